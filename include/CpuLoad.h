@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * CpuLoad.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "SystemSnapshot.h"
+
+#include <array>
+#include <vector>
+
+/**
+ * \brief Calculates the CPU usage and the share of the individual CPU states from consecutive CPU ticks.
+ *
+ * All buffers are allocated for a fixed number of CPUs on construction and are stored as structure of arrays. Each
+ * update processes one state of all CPUs in a branch free loop, which the compiler can vectorise. Thus, the update
+ * does not allocate memory and scales to hosts with hundreds of cores.
+ *
+ * The shares are given in percent of all ticks spend since the last update. A share is set to -1 if the ticks
+ * decreased (overflow or CPU hot plugging) and to 0 if no ticks passed.
+ */
+class CpuLoad {
+ public:
+  /** Published states, USAGE is the busy time (see SystemSnapshot::Cpu::busy()) */
+  enum State { USAGE, IOWAIT, IRQ, SOFTIRQ, STEAL, GUEST, N_STATES };
+
+  /**
+   * \param nCpus Number of CPUs. CPUs with a larger index are ignored by update.
+   */
+  explicit CpuLoad(size_t nCpus = 0);
+
+  /**
+   * Calculate the shares since the last update. The first update uses 0 as last ticks.
+   */
+  void update(const SystemSnapshot::Cpu& total, const SystemSnapshot::CpuArray& cpus);
+
+  /** \return Share of the state summed over all CPUs. */
+  double getTotal(State state) const { return _totalShares[state]; }
+
+  /** \return Share of the state for each CPU. */
+  const std::vector<double>& get(State state) const { return _shares[state]; }
+
+  /**
+   * Calculate the share of a state for groups of CPUs (e.g. sockets, see CpuTopology) from the ticks of the last
+   * update. CPUs with decreased ticks are ignored, a group is set to -1 if this applies to all its CPUs.
+   * \param state The state.
+   * \param mapping Group index of each CPU.
+   * \param shares Share of each group. The size has to be the number of groups.
+   */
+  void aggregate(State state, const std::vector<size_t>& mapping, std::vector<double>& shares);
+
+ private:
+  /**
+   * Calculate the shares of a single state.
+   * \param now Ticks of the state read by this update.
+   * \param last Ticks of the state read by the last update.
+   * \param share Share of the state.
+   */
+  void calculate(const uint64_t* now, const uint64_t* last, double* share) const;
+
+  size_t _nCpus;                                                  ///< Number of CPUs
+  std::array<std::vector<uint64_t>, N_STATES> _ticks, _lastTicks; ///< Ticks of the states
+  std::vector<uint64_t> _allTicks, _lastAllTicks;                 ///< Ticks of all states
+  std::vector<double> _scale;                                     ///< 100 / ticks passed since the last update
+  std::vector<uint8_t> _invalid;                                  ///< 1 if the ticks of all states decreased
+  std::array<std::vector<double>, N_STATES> _shares;              ///< Shares of the individual CPUs
+  SystemSnapshot::Cpu _lastTotal;                                 ///< Ticks of the summary read by the last update
+  std::array<double, N_STATES> _totalShares{};                    ///< Shares of the summary
+  std::vector<uint64_t> _groupTicks, _groupAllTicks;              ///< Buffers used by aggregate
+  std::vector<uint8_t> _groupValid;                               ///< Buffer used by aggregate
+};
@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * CpuTopology.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <array>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Assigns the CPUs to sockets, NUMA nodes and core types.
+ *
+ * The topology is read once on construction from \c /sys:
+ * - socket: \c devices/system/cpu/cpuN/topology/physical_package_id
+ * - NUMA node: \c devices/system/node/nodeN/cpulist
+ * - core type: \c devices/cpu_core/cpus and \c devices/cpu_atom/cpus on hybrid Intel CPUs. If these are not available
+ *   \c devices/system/cpu/cpuN/cpu_capacity is used (e.g. ARM big.LITTLE), where each capacity is a core type.
+ *
+ * Each level has at least one group. CPUs without information (e.g. offline CPUs or systems without NUMA support) are
+ * assigned to the group "0" respectively "default".
+ */
+class CpuTopology {
+ public:
+  /** Levels the CPUs are grouped by */
+  enum Level { SOCKET, NODE, CORE_TYPE, N_LEVELS };
+
+  /**
+   * Read the topology.
+   * \param nCpus Number of CPUs.
+   * \param sysPath Path of the sys file system. Only change this for test purposes.
+   */
+  explicit CpuTopology(size_t nCpus = 0, const std::string& sysPath = "/sys");
+
+  /** \return Names of the groups of a level, e.g. the socket IDs. */
+  const std::vector<std::string>& getGroups(Level level) const { return _groups[level]; }
+
+  /** \return Group index of each CPU. */
+  const std::vector<size_t>& getMapping(Level level) const { return _mapping[level]; }
+
+  /**
+   * Parse a CPU list as used in \c /sys, e.g. "0-3,8,10-11".
+   * \return The CPUs in the list. Invalid parts are skipped.
+   */
+  static std::vector<size_t> parseList(const std::string& list);
+
+  /**
+   * \param sysPath Path of the sys file system.
+   * \return IDs of the NUMA nodes found in \c devices/system/node in ascending order. Empty if NUMA is not supported.
+   */
+  static std::vector<std::string> listNodes(const std::string& sysPath = "/sys");
+
+ private:
+  /**
+   * Set the group of a CPU and add the group if it is not known yet.
+   */
+  void assign(Level level, size_t cpu, const std::string& group);
+
+  /**
+   * Assign CPUs without information to the fallback group.
+   */
+  void fillMissing(Level level, const std::string& fallback);
+
+  std::array<std::vector<std::string>, N_LEVELS> _groups; ///< Names of the groups
+  std::array<std::vector<size_t>, N_LEVELS> _mapping;     ///< Group index of each CPU
+};
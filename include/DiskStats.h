@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * DiskStats.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * \brief Calculates throughput, latency and utilisation of all block devices from \c /proc/diskstats.
+ *
+ * The file is kept open and read using a single pread per update, like in SystemSnapshot. Only whole block devices are
+ * considered, i.e. devices listed in \c /sys/block. Partitions, loop and ram devices are skipped.
+ *
+ * The devices are assigned to a fixed number of slots, so the results can be published using arrays of fixed size.
+ * A device keeps its slot as long as it is present. If a device is removed its slot is freed and reused by the next
+ * device that is plugged in. Devices that do not find a free slot are counted (see getNDropped()).
+ */
+class DiskStats {
+ public:
+  /**
+   * Counters of a device since boot (see the kernel documentation of \c /proc/diskstats).
+   */
+  struct Counters {
+    uint64_t reads{0};          ///< Reads completed
+    uint64_t sectorsRead{0};    ///< Sectors read, a sector is 512 bytes
+    uint64_t msReading{0};      ///< Time spent reading in ms
+    uint64_t writes{0};         ///< Writes completed
+    uint64_t sectorsWritten{0}; ///< Sectors written
+    uint64_t msWriting{0};      ///< Time spent writing in ms
+    uint64_t inFlight{0};       ///< Requests currently in flight
+    uint64_t msBusy{0};         ///< Time the device had requests in flight in ms
+    uint64_t msWeighted{0};     ///< Time spent by all requests in ms, i.e. queue depth integrated over time
+  };
+
+  /**
+   * Results of a device calculated from the counters of two updates.
+   */
+  struct Rates {
+    double readIOPS{0};     ///< Reads per second
+    double writeIOPS{0};    ///< Writes per second
+    double readBytes{0};    ///< Bytes read per second
+    double writeBytes{0};   ///< Bytes written per second
+    double readLatency{0};  ///< Average time per read in ms
+    double writeLatency{0}; ///< Average time per write in ms
+    double queueDepth{0};   ///< Average number of requests in flight
+    double inFlight{0};     ///< Requests in flight at the time of the update
+    double utilisation{0};  ///< Share of time the device was busy in %
+  };
+
+  /**
+   * Open the file.
+   * \param nSlots Maximum number of devices.
+   * \param procPath Directory containing \c diskstats. Only change this for test purposes.
+   * \param sysPath Path of the sys file system used to find whole block devices.
+   */
+  explicit DiskStats(size_t nSlots, const std::string& procPath = "/proc", const std::string& sysPath = "/sys");
+  ~DiskStats();
+  DiskStats(const DiskStats&) = delete;
+  DiskStats& operator=(const DiskStats&) = delete;
+  /** Move the opened file. */
+  DiskStats(DiskStats&& other) noexcept;
+  DiskStats& operator=(DiskStats&& other) noexcept;
+
+  /**
+   * Read the file and calculate the rates since the last update. Devices found for the first time get rates of 0.
+   * \param now Time the file is read.
+   * \return False if the file could not be read or parsed. Use getError() to get the reason.
+   */
+  bool update(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+  /** \return Device names of the slots, empty for free slots. */
+  const std::vector<std::string>& getNames() const { return _names; }
+
+  /** \return Results of the slots, 0 for free slots. */
+  const std::vector<Rates>& getRates() const { return _rates; }
+
+  /** \return True if a device was added or removed by the last update. */
+  bool namesChanged() const { return _namesChanged; }
+
+  /** \return Number of devices found by the last update that did not get a slot. */
+  size_t getNDropped() const { return _nDropped; }
+
+  /** \return The reason of the last failed update. */
+  const std::string& getError() const { return _error; }
+
+  /**
+   * \return Names of the block devices currently present, see DiskStats for the devices considered.
+   */
+  static std::vector<std::string> findDevices(
+      const std::string& procPath = "/proc", const std::string& sysPath = "/sys");
+
+ private:
+  /** \return True if the device is a whole block device that is not a loop or ram device. */
+  bool accept(std::string_view name);
+
+  /** Calculate the rates of a slot from the last and the current counters. */
+  void calculate(size_t slot, const Counters& current, double dt);
+
+  /** Close the file. */
+  void close();
+
+  std::string _fileName;                                  ///< Name of the diskstats file
+  std::string _sysPath;                                   ///< Path of the sys file system
+  int _fd{-1};                                            ///< Opened file
+  std::string _buffer;                                    ///< Buffer reused for reading the file
+  std::vector<std::string> _names;                        ///< Device names of the slots
+  std::vector<Counters> _counters;                        ///< Counters of the last update
+  std::vector<Rates> _rates;                              ///< Rates calculated by the last update
+  std::vector<uint8_t> _seen;                             ///< Slots found by the current update
+  std::unordered_map<std::string, bool> _accepted;        ///< Result of accept() for all device names found so far
+  std::vector<std::pair<std::string, Counters>> _pending; ///< Devices found by the current update without slot
+  std::chrono::steady_clock::time_point _lastUpdate;      ///< Time of the last update
+  bool _namesChanged{false};                              ///< A device was added or removed by the last update
+  size_t _nDropped{0};                                    ///< Devices without slot
+  std::string _error;                                     ///< Reason of the last failed update
+};
@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * ExecSpec.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <string>
+#include <vector>
+
+/**
+ * \brief Immutable description of a command passed to execve.
+ *
+ * The command and the environment given by the user are parsed once and the argv and envp arrays passed to execve
+ * are prepared. Thus, after fork nothing needs to be parsed or allocated, which is not safe in the child of a
+ * multi-threaded process. Keep the object as long as the command and environment are not changed and reuse it for
+ * every (re)start of the process.
+ *
+ * Arguments are separated by white spaces. Use single or double quotes to pass arguments that include white spaces
+ * and a backslash to escape single characters, e.g.:
+ * \code
+ * myServer --name "my server" --opt 'a b' c\ d
+ * \endcode
+ * The same quoting rules apply to the environment. Here variables are separated by a comma, e.g.:
+ * \code
+ * ENSHOST=localhost,MYLIST="a,b,c"
+ * \endcode
+ * The environment passed to execve consists of the environment of the calling process extended by the given
+ * variables. Existing variables are only replaced if overwriteEnv is true (see setenv).
+ */
+class ExecSpec {
+ public:
+  /**
+   * Parse the command and environment.
+   * \param path Directory where to find the command. It is also used as working directory.
+   * \param cmd Command including command line options.
+   * \param environment Environment variables to be set, separated by a comma.
+   * \param overwriteEnv If true existing environment variables are overwritten.
+   * \throw std::runtime_error If the command is empty or the quoting is broken.
+   */
+  ExecSpec(const std::string& path, const std::string& cmd, const std::string& environment = "",
+      bool overwriteEnv = false);
+
+  /**
+   * Construct from already parsed arguments and environment, e.g. received by the spawn helper.
+   * \param path Working directory.
+   * \param args Arguments, the first argument is the command.
+   * \param env Complete environment in the form NAME=VALUE.
+   * \throw std::runtime_error If args is empty.
+   */
+  ExecSpec(const std::string& path, std::vector<std::string> args, std::vector<std::string> env);
+
+  // argv and envp point to the strings stored in the object
+  ExecSpec(const ExecSpec&) = delete;
+  ExecSpec& operator=(const ExecSpec&) = delete;
+
+  /**
+   * \return True if the object was created from the given parameters. Use it to check if the object needs to be
+   * recreated after the user changed the configuration.
+   */
+  bool matches(const std::string& path, const std::string& cmd, const std::string& environment,
+      bool overwriteEnv) const;
+
+  /**
+   * Split a string into arguments.
+   * \param input The string to be split.
+   * \param separators Characters used to separate arguments outside of quotes.
+   * \throw std::runtime_error If a quote is not closed or the string ends with a backslash.
+   */
+  static std::vector<std::string> parseArguments(const std::string& input, const std::string& separators = "\t ");
+
+  /** \return The working directory. */
+  const std::string& getPath() const { return _path; }
+
+  /** \return The file passed to execve, i.e. path + command. */
+  const std::string& getFile() const { return _file; }
+
+  /** \return The arguments, the first argument is the command. */
+  const std::vector<std::string>& getArgs() const { return _args; }
+
+  /** \return The complete environment passed to execve. */
+  const std::vector<std::string>& getEnv() const { return _env; }
+
+  /** \return Environment strings that could not be interpreted and were ignored. */
+  const std::vector<std::string>& getIgnoredEnv() const { return _ignoredEnv; }
+
+  /** \return Null terminated argument array to be passed to execve. */
+  char* const* getArgv() const { return _argv.data(); }
+
+  /** \return Null terminated environment array to be passed to execve. */
+  char* const* getEnvp() const { return _envp.data(); }
+
+ private:
+  /**
+   * Set the file name and fill the pointer arrays.
+   */
+  void prepare();
+
+  std::string _path;                    ///< Working directory
+  std::string _cmd;                     ///< Command as given by the user
+  std::string _environment;             ///< Environment as given by the user
+  bool _overwriteEnv{false};            ///< Overwrite setting given by the user
+  std::string _file;                    ///< File passed to execve
+  std::vector<std::string> _args;       ///< Parsed arguments
+  std::vector<std::string> _env;        ///< Complete environment
+  std::vector<std::string> _ignoredEnv; ///< Environment strings without '='
+  std::vector<char*> _argv;             ///< Pointers to _args terminated by nullptr
+  std::vector<char*> _envp;             ///< Pointers to _env terminated by nullptr
+};
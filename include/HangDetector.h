@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * HangDetector.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * \brief Detect processes that are still running but no longer make progress.
+ *
+ * A heartbeat value is sampled once per trigger. The heartbeat can be any value that increases (or at least changes)
+ * while the process is working, e.g. the CPU time used by the process, the modification time of a file the process
+ * touches regularly or a counter the process increments in shared memory.
+ * If the heartbeat does not change for longer than the timeout the process is considered hung.
+ */
+class HangDetector {
+ public:
+  /**
+   * Source of the heartbeat.
+   */
+  enum class Source {
+    CPUTime = 0,   ///< CPU time (utime + stime + cutime + cstime) of the process
+    FileMTime = 1, ///< Modification time of the heartbeat file
+    Counter = 2    ///< 64 bit counter stored at the beginning of the heartbeat file (e.g. a segment in /dev/shm)
+  };
+
+  /**
+   * Highest valid value of Source.
+   */
+  static constexpr unsigned int maxSource = static_cast<unsigned int>(Source::Counter);
+
+  /**
+   * Forget the last heartbeat. Call this whenever a new process is started.
+   * The timeout is counted from the first heartbeat passed to update() after the reset.
+   */
+  void reset() { _valid = false; }
+
+  /**
+   * Pass a new heartbeat sample.
+   * \param heartbeat The current heartbeat value.
+   * \param timeout Time in seconds the heartbeat may stay constant. If 0 hang detection is disabled.
+   * \param now Time the heartbeat was sampled.
+   * \return True if the heartbeat did not change for longer than the timeout.
+   */
+  bool update(uint64_t heartbeat, unsigned int timeout,
+      std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+  /**
+   * \return Seconds since the heartbeat changed the last time. 0 if no heartbeat was passed since the last reset.
+   */
+  double getStallTime(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) const;
+
+  /**
+   * \return The last heartbeat passed to update(). Pass it again if no new heartbeat could be read, so a missing
+   * heartbeat is not mistaken for progress.
+   */
+  uint64_t getLastHeartbeat() const { return _lastHeartbeat; }
+
+  /**
+   * \return True if a heartbeat was passed to update() since the last reset.
+   */
+  bool hasHeartbeat() const { return _valid; }
+
+  /**
+   * Read a heartbeat from a file.
+   * \param source FileMTime or Counter. For CPUTime nothing is read and false is returned.
+   * \param fileName Name of the heartbeat file.
+   * \param heartbeat The heartbeat read from the file.
+   * \return False if the file could not be read.
+   */
+  static bool readHeartbeat(Source source, const std::string& fileName, uint64_t& heartbeat);
+
+ private:
+  bool _valid{false};                                ///< False until the first heartbeat after reset() is passed
+  uint64_t _lastHeartbeat{0};                        ///< Last heartbeat
+  std::chrono::steady_clock::time_point _lastChange; ///< Time the heartbeat changed the last time
+};
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * LineRing.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <deque>
+#include <string>
+
+/**
+ * \brief Keep the last lines of a text stream.
+ *
+ * Data is added in arbitrary chunks and split into lines. Only the last \c capacity lines are kept.
+ * The tail is formatted like logging::formatLogTail does, i.e. each line is terminated by a newline and an
+ * incomplete last line counts as a line.
+ */
+class LineRing {
+ public:
+  /**
+   * Set the number of lines to keep. Surplus lines are removed.
+   */
+  void setCapacity(size_t capacity);
+
+  size_t getCapacity() const { return _capacity; }
+
+  /**
+   * Add data, which does not need to end with a newline.
+   */
+  void add(const char* data, size_t size);
+
+  /** Remove all lines. */
+  void clear();
+
+  /**
+   * \return The formatted tail.
+   */
+  std::string format() const;
+
+ private:
+  size_t _capacity{0};            ///< Number of lines to keep
+  std::deque<std::string> _lines; ///< Last complete lines
+  std::string _partial;           ///< Incomplete last line
+};
@@ -9,6 +9,8 @@
  *      Author: Klaus Zenker (HZDR)
  */
 
+#include "LogIndex.h"
+#include "LogTail.h"
 #include "Logging.h"
 
 #include <ChimeraTK/ApplicationCore/ApplicationCore.h>
@@ -17,6 +19,46 @@
 
 namespace ctk = ChimeraTK;
 
+/**
+ * \brief Variables used to read pages of a log file.
+ *
+ * The lines are found using a LogIndex, so clients can browse the complete log file without copying it from the host.
+ * A page is selected by line numbers or by a time range. It is only read again if the request or the number of lines
+ * in the log file changed. If nLines is 0 the log file is not indexed at all.
+ */
+struct LogPage : public ctk::VariableGroup {
+  using ctk::VariableGroup::VariableGroup;
+  ctk::ScalarPollInput<int64_t> firstLine{this, "firstLine", "",
+      "First line of the page, starting at 0. Negative values count from the end of the log file, e.g. -100 shows the "
+      "last 100 lines."};
+  ctk::ScalarPollInput<uint> nLines{this, "nLines", "",
+      "Number of lines of the page. Set 0 to disable reading pages. At most 1000 lines and 64 kB are shown."};
+  ctk::ScalarPollInput<std::string> startTime{this, "startTime", "",
+      "If set the page starts with the first line with a time stamp not older than this time, e.g. 2026-10-19 "
+      "12:00:00. In that case firstLine is ignored."};
+  ctk::ScalarPollInput<std::string> endTime{
+      this, "endTime", "", "If set the page ends before the first line with a time stamp not older than this time."};
+  ctk::ScalarOutput<std::string> page{this, "page", "", "Requested lines of the log file."};
+  ctk::ScalarOutput<uint64_t> pageFirstLine{this, "pageFirstLine", "", "Number of the first line of the page."};
+  ctk::ScalarOutput<uint64_t> totalLines{this, "totalLines", "", "Number of complete lines in the log file."};
+
+  /** Maximum number of lines of a page */
+  static constexpr uint maxLines = 1000;
+
+  /**
+   * Update the index and read the requested page.
+   * \param fileName Name of the log file. If empty no lines are found.
+   * \return True if the outputs changed.
+   */
+  bool update(const std::string& fileName);
+
+ private:
+  LogIndex _index;                  ///< Line index of the log file
+  int64_t _firstLine{0};            ///< firstLine used for the current page
+  uint _nLines{0};                  ///< nLines used for the current page
+  std::string _startTime, _endTime; ///< startTime and endTime used for the current page
+};
+
 /**
  * \brief Module used to read external log file in order to make messages available
  * to the control system.
@@ -24,6 +66,8 @@ namespace ctk = ChimeraTK;
  * E.g. the ChimeraTk watchdog starts a process and its output is not available by the watchdog.
  * But the log file produced by the process can be read. If the log file is set
  * via \c logFileExternal it is parsed and the tail is published to \c LogFileTailExternal.
+ * The tail is only written if it changed.
+ * Pages of the log file can be read using \c logPage.
  */
 struct LogFileModule : public ctk::ApplicationModule {
   LogFileModule(ctk::ModuleGroup* owner, const std::string& name, const std::string& description,
@@ -44,15 +88,16 @@ struct LogFileModule : public ctk::ApplicationModule {
         "Tail of an external log file, e.g. produced by a program started by the watchdog.", {getName()}};
   } status{this, "status", "Status parameter of the process"};
 
+  LogPage logPage{this, "logPage", "Read pages of the log file"};
+
   ctk::ScalarPushInput<uint64_t> trigger;
   ctk::ScalarPollInput<std::string> logFile;
 
-  std::unique_ptr<std::filebuf> logFileBuffer;
-
   /**
    * Application core main loop.
    */
   void mainLoop() override;
 
-  void terminate() override;
+ private:
+  LogTail _logTail; ///< Follows the log file
 };
@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * LogIndex.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "LogWatchReactor.h"
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * \brief Sparse line offset index of a log file used for random access to its lines.
+ *
+ * Every \c stride lines the byte offset of the line is stored. Thus, a line range is found by a binary search followed
+ * by reading at most \c stride lines that are skipped. The index is maintained incrementally: an update only reads the
+ * bytes appended since the last update. To limit the time spend in a single update at most \c maxBytesPerUpdate bytes
+ * are indexed, so a large existing file is indexed during several updates.
+ *
+ * In addition the latest time stamp found at the beginning of the lines before an index entry is stored. Lines
+ * without time stamp (e.g. continuation lines) belong to the preceding time stamp. This allows to find the first
+ * line of a time range the same way. Supported time stamps are "2026-10-19 12:00:00", "2026-10-19T12:00:00" and
+ * "2026-Oct-19 12:00:00" (as written by boost), optionally enclosed in square brackets.
+ *
+ * If the file is truncated, replaced or deleted (e.g. by log rotation) the index is reset.
+ * Only complete lines are indexed.
+ *
+ * Like LogTail the index uses the shared LogWatchReactor to find out if the file changed. Thus, an update of a file
+ * that did not change does not need any system call. If the file can not be watched the file status is checked on
+ * every update instead.
+ */
+class LogIndex {
+ public:
+  /**
+   * \param stride Number of lines between two index entries.
+   * \param maxBytesPerUpdate Maximum number of bytes indexed in a single update.
+   */
+  explicit LogIndex(size_t stride = 64, size_t maxBytesPerUpdate = 64 * 1024 * 1024);
+  ~LogIndex();
+  LogIndex(const LogIndex&) = delete;
+  LogIndex& operator=(const LogIndex&) = delete;
+  /** Move the opened file, needed since modules owning a LogIndex are stored in vectors. */
+  LogIndex(LogIndex&& other) noexcept;
+  LogIndex& operator=(LogIndex&& other) noexcept;
+
+  /**
+   * Index the lines appended to the file since the last call.
+   * \param fileName Name of the log file. If it differs from the last call the index is reset.
+   * \return True if the number of lines changed or the index was reset.
+   */
+  bool update(const std::string& fileName);
+
+  /**
+   * \return Number of indexed lines.
+   */
+  size_t getNLines() const { return _nLines; }
+
+  /**
+   * Read indexed lines.
+   * \param first Number of the first line, starting at 0.
+   * \param n Number of lines to read.
+   * \param maxBytes Maximum size of the result. Lines that do not fit are not returned, except the first line, which is
+   * cut.
+   * \return The lines including their line feeds.
+   */
+  std::string readLines(size_t first, size_t n, size_t maxBytes = 64 * 1024) const;
+
+  /**
+   * Find the first line with a time stamp that is not older than the given time.
+   * \param time Seconds since EPOCH, the time stamps in the file are considered to be UTC.
+   * \return Number of the line or getNLines() if no such line exists.
+   */
+  size_t findTime(int64_t time) const;
+
+  /**
+   * Parse the time stamp at the beginning of a line.
+   * \param line The line.
+   * \param time Set to the seconds since EPOCH if a time stamp was found.
+   * \return False if the line does not start with a supported time stamp.
+   */
+  static bool parseTimestamp(std::string_view line, int64_t& time);
+
+ private:
+  /** Index entry, stored every _stride lines. */
+  struct Entry {
+    size_t line;    ///< Number of the line
+    off_t offset;   ///< Offset of the line in the file
+    int64_t before; ///< Latest time stamp found in the lines before, INT64_MIN if none was found
+  };
+
+  /** Forget the indexed lines. */
+  void clear();
+
+  /** Forget the indexed lines and close the file. */
+  void close();
+
+  /**
+   * Read the events of the watch or check the file status if inotify is not available.
+   * \param modified Set true if the file might contain data that is not indexed yet.
+   * \return True if the file needs to be reopened.
+   */
+  bool checkReopen(bool& modified);
+
+  /** Index a chunk of data read from the file at _offset. */
+  void add(const char* data, size_t size);
+
+  /** \return The last entry with a line number not larger than line. */
+  const Entry& findEntry(size_t line) const;
+
+  /**
+   * Call the function for every complete line starting at the given offset until it returns false.
+   * The line passed to the function includes the line feed.
+   */
+  template<typename FUNC>
+  void forEachLine(off_t offset, FUNC&& function) const;
+
+  size_t _stride;              ///< Number of lines between two entries
+  size_t _maxBytesPerUpdate;   ///< Maximum number of bytes read per update
+  std::string _fileName;       ///< Name of the indexed file
+  int _fd{-1};                 ///< File descriptor of the indexed file
+  dev_t _device{0};            ///< Device of the opened file
+  ino_t _inode{0};             ///< Inode of the opened file
+  off_t _offset{0};            ///< Number of bytes read from the file
+  bool _pending{false};        ///< The last update did not reach the end of the file
+  off_t _lineStart{0};         ///< Offset of the current incomplete line, all bytes before belong to indexed lines
+  size_t _nLines{0};           ///< Number of complete lines
+  int64_t _latest{INT64_MIN};  ///< Latest time stamp found so far
+  std::string _head;           ///< Beginning of the current incomplete line, used to parse its time stamp
+  std::vector<Entry> _entries; ///< Index entries, the first one is line 0
+
+  std::shared_ptr<LogWatchReactor> _reactor;      ///< Shared inotify reactor, nullptr if not available
+  std::shared_ptr<LogWatchReactor::Watch> _watch; ///< Watch of the opened file
+};
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * LogRotator.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Rotate the log file of a process based on its size and age.
+ *
+ * The rotated file is named <logfile>.<YYYYMMDD-HHMMSS>. Two methods are supported, so the process does not need to
+ * be restarted:
+ * - CopyTruncate: The file is copied and truncated afterwards. This is used if the process writes the log file
+ *   itself (opened with O_APPEND, so it continues writing at the beginning of the truncated file). Data written
+ *   between copying and truncating is lost. Copying is done by the background thread.
+ * - Rename: The file is renamed. This is used if the watchdog writes the log file (see OutputCapture), which has to
+ *   reopen the file afterwards.
+ *
+ * Compressing the rotated file (gzip) and removing old rotated files in order to respect the retention budget is
+ * done by a background thread shared by all rotators, too.
+ */
+class LogRotator {
+ public:
+  /**
+   * Rotation settings. A setting of 0 is not evaluated.
+   */
+  struct Settings {
+    uint64_t maxSize{0};   ///< Rotate if the file is larger (kB)
+    unsigned maxAge{0};    ///< Rotate if the file was not rotated for that time (s)
+    uint64_t retention{0}; ///< Maximum total size of all rotated files of the log file (kB)
+    bool compress{false};  ///< Compress rotated files using gzip
+  };
+
+  /**
+   * Rotation methods.
+   */
+  enum class Method { CopyTruncate, Rename };
+
+  LogRotator();
+
+  /**
+   * Check if the file needs to be rotated and rotate it.
+   * \param fileName The log file.
+   * \param settings Rotation settings.
+   * \param method Rotation method.
+   * \param now Current time, used to evaluate the age.
+   * \return Name of the rotated file or an empty string if the file was not rotated. With CopyTruncate the file is
+   * copied in the background, no further rotation is done until the copy is finished.
+   * \throw std::runtime_error If the rotation failed. A failure of the copy in the background is thrown by the next
+   * call.
+   */
+  std::string check(const std::string& fileName, const Settings& settings, Method method,
+      std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+  /**
+   * Wait until all copy, compression and retention jobs are done. This is intended for tests.
+   */
+  static void waitForBackgroundJobs();
+
+  /**
+   * Compress a file using gzip. The compressed file is called <fileName>.gz and the original file is removed.
+   * \return False if compressing failed. In that case the original file is kept.
+   */
+  static bool compressFile(const std::string& fileName);
+
+  /**
+   * Remove the oldest rotated files of a log file until their total size fits into the budget.
+   * \param fileName The log file (not the rotated file).
+   * \param budget Maximum total size in bytes.
+   */
+  static void enforceRetention(const std::string& fileName, uint64_t budget);
+
+  /**
+   * \return All rotated files of the log file sorted by their modification time, oldest first.
+   */
+  static std::vector<std::string> findRotatedFiles(const std::string& fileName);
+
+ private:
+  /**
+   * Background thread used for compression and retention.
+   */
+  class Worker;
+
+  /**
+   * Result of a copy done by the background thread.
+   */
+  struct CopyState {
+    std::mutex mutex;  ///< Protects done and error
+    bool done{false};  ///< The copy is finished
+    std::string error; ///< Reason of a failure, empty on success
+  };
+
+  std::shared_ptr<Worker> _worker;              ///< Shared background thread
+  std::shared_ptr<CopyState> _copy;             ///< Copy in progress or not yet checked, nullptr if none
+  std::string _fileName;                        ///< Log file observed so far
+  std::chrono::steady_clock::time_point _since; ///< Time of the last rotation or first observation
+};
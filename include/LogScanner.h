@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * LogScanner.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <cstdint>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Count log lines matching a set of patterns.
+ *
+ * Data is added in arbitrary chunks as it is read from the log file or the output pipe. All literal patterns are
+ * matched in a single pass using an Aho-Corasick automaton, so the cost does not depend on the number of patterns.
+ * Patterns enclosed in slashes (e.g. "/timeout after [0-9]+ s/") are ECMAScript regular expressions. They are
+ * evaluated per line, which is only buffered if regular expressions are used.
+ *
+ * A line is counted once per pattern, even if the pattern occurs several times in the line. A line is counted when
+ * its newline is added.
+ *
+ * add() and getCounts() can be called from different threads.
+ */
+class LogScanner {
+ public:
+  /** Maximum number of patterns. */
+  static constexpr size_t maxPatterns = 16;
+
+  /**
+   * Set the patterns. The counters are reset if the patterns changed.
+   * \throw std::runtime_error If there are too many patterns, a pattern is empty or a regular expression is invalid.
+   */
+  void setPatterns(const std::vector<std::string>& patterns);
+
+  /**
+   * Scan data, which does not need to end with a newline.
+   */
+  void add(const char* data, size_t size);
+
+  /**
+   * \return The number of matching lines per pattern, in the order of the patterns.
+   */
+  std::vector<uint64_t> getCounts();
+
+ private:
+  /** Finish the current line. */
+  void endLine();
+
+  /** Maximum length of a line buffered for regular expressions. Longer lines are cut. */
+  static constexpr size_t maxLineLength = 64 * 1024;
+
+  std::mutex _mutex;                                 ///< Protects all data below
+  std::vector<std::string> _patterns;                ///< Patterns as set by the user
+  std::vector<int32_t> _transitions;                 ///< Automaton: next state = _transitions[state * 256 + byte]
+  std::vector<uint32_t> _output;                     ///< Bit mask of the literal patterns found when reaching a state
+  std::vector<std::pair<size_t, std::regex>> _regex; ///< Regular expressions and their pattern index
+  int32_t _state{0};                                 ///< Current state of the automaton
+  uint32_t _lineMatches{0};                          ///< Patterns found in the current line
+  std::string _line;                                 ///< Current line, only used for regular expressions
+  std::vector<uint64_t> _counts;                     ///< Number of matching lines per pattern
+};
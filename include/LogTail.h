@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * LogTail.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "LineRing.h"
+#include "LogScanner.h"
+#include "LogWatchReactor.h"
+
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+
+/**
+ * \brief Incrementally follow the tail of a log file.
+ *
+ * The log file is kept open and only the bytes appended since the last update are read. The last lines are kept in
+ * memory, so an update costs O(new bytes). The shared LogWatchReactor is used to find out if the file was modified,
+ * moved or deleted. If nothing happened an update does not need any system call. Moved or deleted files are reopened
+ * by name, which also covers log files that are deleted and recreated when a process is restarted. If a file is
+ * truncated (e.g. by copy-truncate log rotation) it is read from the beginning. If the file can not be watched the
+ * file status is checked on every update instead.
+ *
+ * The tail is formatted by LineRing. Optionally all data appended to the file is passed to a LogScanner.
+ */
+class LogTail {
+ public:
+  LogTail() = default;
+  ~LogTail();
+  LogTail(const LogTail&) = delete;
+  LogTail& operator=(const LogTail&) = delete;
+  /** Move the opened file, needed since modules owning a LogTail are stored in vectors. */
+  LogTail(LogTail&& other) noexcept;
+  LogTail& operator=(LogTail&& other) noexcept;
+
+  /**
+   * Read new data from the log file.
+   * \param fileName Name of the log file. If it differs from the last call the new file is read.
+   * \param tailLength Number of lines in the tail.
+   * \return True if the tail changed since the last call.
+   */
+  bool update(const std::string& fileName, size_t tailLength);
+
+  /**
+   * \return The tail or a message explaining why no tail could be read (e.g. the file could not be opened).
+   */
+  const std::string& getTail() const { return _tail; }
+
+  /**
+   * Set the scanner that gets all data appended to the log file. The lines read when a file is opened for the first
+   * time are not scanned. If the file is replaced (e.g. rotated or recreated) the new file is scanned from the
+   * beginning.
+   * \param scanner The scanner or nullptr to disable scanning.
+   */
+  void setScanner(std::shared_ptr<LogScanner> scanner) { _scanner = std::move(scanner); }
+
+ private:
+  /**
+   * Open the file and read the last lines.
+   * \return False if the file could not be opened.
+   */
+  bool open();
+
+  /** Close the file and forget the stored lines. */
+  void close();
+
+  /**
+   * Read the inotify events or check the file status if inotify is not available.
+   * \param modified Set true if data was written to the file.
+   * \return True if the file needs to be reopened.
+   */
+  bool checkReopen(bool& modified);
+
+  /**
+   * Read all data appended since the last call.
+   * \param scan If true the data is passed to the scanner.
+   * \return True if new data was read.
+   */
+  bool readAppended(bool scan = true);
+
+  /** Set a message instead of the tail. \return True if the message differs from the current tail. */
+  bool setMessage(const std::string& message);
+
+  std::string _fileName;                          ///< Name of the currently followed file
+  size_t _tailLength{0};                          ///< Number of lines to keep
+  int _fd{-1};                                    ///< File descriptor of the log file
+  std::shared_ptr<LogWatchReactor> _reactor;      ///< Shared inotify reactor, nullptr if not available
+  std::shared_ptr<LogWatchReactor::Watch> _watch; ///< Watch of the opened file
+  off_t _offset{0};                               ///< Number of bytes read from the file
+  dev_t _device{0};                               ///< Device of the opened file, used without inotify
+  ino_t _inode{0};                                ///< Inode of the opened file, used without inotify
+  LineRing _lines;                                ///< Last lines of the file
+  std::string _tail;                              ///< Formatted tail
+  std::shared_ptr<LogScanner> _scanner;           ///< Scanner for new data, nullptr if not used
+  bool _opened{false};                            ///< The file was opened before, so a reopened file is new
+};
@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * LogWatchReactor.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * \brief Single thread watching all log files for changes.
+ *
+ * Instead of every LogTail owning an inotify instance and reading its events, all log files are watched by one
+ * inotify instance. A single thread waits for events using epoll and marks the affected watches. Modules only check
+ * the flags of their watch, so a log file that did not change costs no system call at all.
+ * The same thread also drains the pipes used to capture the output of processes (see OutputCapture).
+ *
+ * The reactor is shared by all users. Get it using LogWatchReactor::get() and keep the returned pointer as long as
+ * watches are used.
+ */
+class LogWatchReactor {
+ public:
+  /**
+   * Events reported for a watched file.
+   */
+  enum Event : unsigned int {
+    Modified = 1,   ///< Data was written to the file or it was truncated
+    Attributes = 2, ///< Attributes changed, e.g. the link count after the file was deleted
+    Reopen = 4      ///< The file was moved or deleted and needs to be opened again by name
+  };
+
+  /**
+   * Watch of a single file. The reactor thread sets the events, the user collects them using takeEvents().
+   */
+  struct Watch {
+    /**
+     * \return All events since the last call as bit mask of Event.
+     */
+    unsigned int takeEvents() { return events.exchange(0); }
+
+    std::atomic<unsigned int> events{0}; ///< Events not yet collected
+    int wd{-1};                          ///< Inotify watch descriptor
+  };
+
+  /**
+   * \return The shared reactor or nullptr if inotify is not available.
+   */
+  static std::shared_ptr<LogWatchReactor> get();
+
+  ~LogWatchReactor();
+  LogWatchReactor(const LogWatchReactor&) = delete;
+  LogWatchReactor& operator=(const LogWatchReactor&) = delete;
+
+  /**
+   * Start watching a file.
+   * \param fileName The file to be watched. It has to exist.
+   * \return The watch or nullptr if the file could not be watched.
+   */
+  std::shared_ptr<Watch> watch(const std::string& fileName);
+
+  /**
+   * Stop watching a file.
+   */
+  void unwatch(const std::shared_ptr<Watch>& watch);
+
+  /**
+   * Call \c onReadable from the reactor thread whenever \c fd is readable or closed by the writer.
+   * \param fd The file descriptor, e.g. the read end of a pipe. It is not closed by the reactor.
+   * \param onReadable Function reading the data. If it returns false, e.g. at the end of the file, the file
+   * descriptor is removed from the reactor.
+   * \return False if the file descriptor could not be added.
+   */
+  bool addReader(int fd, std::function<bool()> onReadable);
+
+  /**
+   * Remove a file descriptor added by addReader. Once the function returns \c onReadable is no longer called and the
+   * file descriptor can be closed. If \c onReadable is running in the reactor thread, the function waits for it to
+   * return, unless it is called from \c onReadable itself.
+   */
+  void removeReader(int fd);
+
+ private:
+  LogWatchReactor(int inotifyFD, int epollFD, int stopFD);
+
+  /** Thread function waiting for inotify events. */
+  void run();
+
+  /**
+   * Call the reader of \c fd without holding the lock.
+   * \param destroyed Set if the reactor was destroyed by releasing the last reference within the reader.
+   * \return False if the reactor was destroyed and the thread has to return without touching any member.
+   */
+  bool callReader(int fd, const bool& destroyed);
+
+  /** Read all pending inotify events and mark the watches. */
+  void dispatch();
+
+  int _inotifyFD;                                            ///< Inotify instance shared by all watches
+  int _epollFD;                                              ///< Used to wait for inotify events and the stop request
+  int _stopFD;                                               ///< Eventfd used to stop the thread
+  std::mutex _mutex;                                         ///< Protects _watches, _readers and _activeReader
+  std::map<int, std::vector<std::weak_ptr<Watch>>> _watches; ///< Watches per watch descriptor
+  std::map<int, std::function<bool()>> _readers;             ///< Readers per file descriptor
+  int _activeReader{-1};                                     ///< File descriptor whose reader is running, -1 if none
+  std::condition_variable _readerDone;                       ///< Notified when a reader returned
+  bool* _destroyed{nullptr};                                 ///< Set by the destructor if it runs in the reactor thread
+  std::thread _thread;                                       ///< Reactor thread
+};
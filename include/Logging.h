@@ -11,6 +11,9 @@
 
 #include <ChimeraTK/ApplicationCore/Logging.h>
 
+#include <sys/types.h>
+
+#include <atomic>
 #include <ostream>
 #include <sstream>
 #include <string>
@@ -21,6 +24,40 @@ namespace logging {
   //  enum class Level { DEBUG, INFO, WARNING, ERROR, SILENT };
   std::string getTime();
 
+  /**
+   * Minimum level of messages send by the watchdog modules. Messages below are not even formatted.
+   * The LoggingModule can filter the remaining messages further at runtime.
+   */
+  inline std::atomic<LogLevel> messageThreshold{LogLevel::DEBUG};
+
+  /**
+   * Set the minimum level of messages send by the watchdog modules.
+   */
+  inline void setMessageThreshold(LogLevel level) {
+    messageThreshold.store(level, std::memory_order_relaxed);
+  }
+
+  /**
+   * \return True if messages of the given level are send.
+   */
+  inline bool isEnabled(LogLevel level) {
+    return level >= messageThreshold.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Send a message that is only formatted if its level is enabled. So a disabled message only costs a branch.
+   * \code
+   * logging::send(logger, logging::LogLevel::DEBUG, [&] { return "PID: " + std::to_string(pid); });
+   * \endcode
+   * \param logger The logger used to send the message.
+   * \param level The level of the message.
+   * \param format Function returning the message.
+   */
+  template<class LoggerPtr, class Format>
+  void send(const LoggerPtr& logger, LogLevel level, Format&& format) {
+    if(isEnabled(level)) logger->sendMessage(format(), level);
+  }
+
   std::ostream& operator<<(std::ostream& os, const logging::LogLevel& level);
 
   struct Message {
@@ -47,5 +84,27 @@ namespace logging {
    */
   void formatLogTail(std::istream& data, std::ostream& os, size_t numberOfLines = 10);
 
-  std::vector<Message> stripMessages(std::stringstream& msg, const size_t maxCharacters = 256);
+  /**
+   * Find the offset of the first of the last lines of a file.
+   * The file is read backwards in blocks of \c blockSize bytes using pread and newlines are searched using memrchr.
+   * Thus, the costs only depend on the size of the tail and not on the size of the file. The last byte of the file is
+   * not considered, so a newline at the end of the file does not count as an empty line, whereas an incomplete last
+   * line counts as a line.
+   * \param fd The file descriptor of the file.
+   * \param fileSize Size of the file in bytes.
+   * \param numberOfLines The number of lines in the tail.
+   * \param blockSize Number of bytes read at once.
+   * \return The offset where to start reading the tail. It is 0 if the file has less than \c numberOfLines lines.
+   */
+  off_t findTailOffset(int fd, off_t fileSize, size_t numberOfLines, size_t blockSize = 65536);
+
+  /**
+   * Put the last lines of a file to the ostream. The output is formatted like by formatLogTail, but only the
+   * tail of the file is read (see findTailOffset).
+   * \param fileName The file to be read.
+   * \param os The ostream used to put the selected messages to.
+   * \param numberOfLines The number of lines to be put to the output \c os.
+   * \return False if the file could not be read.
+   */
+  bool readLogTail(const std::string& fileName, std::ostream& os, size_t numberOfLines = 10);
 } // namespace logging
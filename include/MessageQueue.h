@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * MessageQueue.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <ChimeraTK/ApplicationCore/Logging.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace logging {
+
+  /**
+   * A message send through the MessageQueue.
+   */
+  struct Record {
+    LogLevel level{LogLevel::INFO}; ///< Log level of the message
+    std::string text;               ///< Message text without level and time, the time is added by the logger
+  };
+
+  /**
+   * \brief Bounded lock-free single producer single consumer queue of messages.
+   *
+   * Used to pass messages from a ProcessHandler to the module owning it. The messages keep their log level, so they
+   * do not need to be formatted and parsed again. The producer and the consumer can be different threads, but only
+   * one thread may push and only one thread may pop at a time.
+   * If the queue is full new messages are dropped and counted.
+   */
+  class MessageQueue {
+   public:
+    /**
+     * \param capacity Maximum number of messages in the queue. It is rounded up to a power of 2.
+     */
+    explicit MessageQueue(size_t capacity = 256);
+
+    /**
+     * Add a message. Called by the producer.
+     * \return False if the queue is full and the message was dropped.
+     */
+    bool push(LogLevel level, std::string text);
+
+    /**
+     * Take the oldest message. Called by the consumer. The text buffer of \c record is reused by the queue.
+     * \return False if the queue is empty.
+     */
+    bool pop(Record& record);
+
+    /**
+     * \return The number of messages dropped since the last call.
+     */
+    size_t takeDropped() { return _dropped.exchange(0); }
+
+   private:
+    std::vector<Record> _slots;                  ///< Ring buffer
+    size_t _mask;                                ///< Number of slots - 1
+    alignas(64) std::atomic<size_t> _head{0};    ///< Number of messages pushed, written by the producer
+    alignas(64) std::atomic<size_t> _tail{0};    ///< Number of messages popped, written by the consumer
+    alignas(64) std::atomic<size_t> _dropped{0}; ///< Number of dropped messages
+  };
+} // namespace logging
@@ -0,0 +1,211 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * NetStats.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * \brief Counters of all network interfaces read from \c /proc/net/dev or using RTNETLINK.
+ *
+ * By default the file \c /proc/net/dev is kept open and read using a single pread per snapshot, like in SystemSnapshot.
+ * After useNetlink() the snapshot is taken using a single RTM_GETLINK dump instead, which provides all 64 bit counters
+ * of the kernel (struct rtnl_link_stats64). A snapshot is shared by all users: it is identified by the tick of the
+ * trigger, so the interfaces are read only once per tick no matter how many NetworkModules request counters. All
+ * interfaces of a snapshot share a single time stamp taken from the steady clock.
+ *
+ * Interfaces can be assigned to a fixed number of slots (see setSlots()), so a fixed number of modules can monitor
+ * interfaces that appear, disappear or are renamed at runtime. After watchLinks() the slots are updated using the link
+ * notifications of the kernel (RTMGRP_LINK), which are received whenever a snapshot is taken. Interfaces are not
+ * rescanned, except if notifications were lost because the socket buffer overflowed. New interfaces are only assigned
+ * to a slot if they are not virtual (like in findNetworkDevices() of the WatchdogServer). Interfaces that do not find
+ * a free slot wait for the next slot that is freed.
+ *
+ * The object is used by several module threads, all public methods are thread safe.
+ */
+class NetStats {
+ public:
+  /**
+   * Counters of an interface since it was created (64 bit counters of the kernel).
+   * When reading \c /proc/net/dev missed packets are included in rxDropped, overruns are included in rxFrame and
+   * rxMissed and rxOver are 0.
+   */
+  struct Counters {
+    uint64_t rxBytes{0};      ///< Received bytes
+    uint64_t rxPackets{0};    ///< Received packets
+    uint64_t rxErrors{0};     ///< Receive errors
+    uint64_t rxDropped{0};    ///< Received packets dropped
+    uint64_t rxFifo{0};       ///< Receive fifo errors
+    uint64_t rxFrame{0};      ///< Receive frame errors
+    uint64_t rxCompressed{0}; ///< Received compressed packets
+    uint64_t multicast{0};    ///< Received multicast packets
+    uint64_t txBytes{0};      ///< Transmitted bytes
+    uint64_t txPackets{0};    ///< Transmitted packets
+    uint64_t txErrors{0};     ///< Transmit errors
+    uint64_t txDropped{0};    ///< Transmitted packets dropped
+    uint64_t txFifo{0};       ///< Transmit fifo errors
+    uint64_t collisions{0};   ///< Collisions
+    uint64_t txCarrier{0};    ///< Carrier errors
+    uint64_t txCompressed{0}; ///< Transmitted compressed packets
+    uint64_t rxMissed{0};     ///< Packets missed by the receiver, e.g. because the ring buffer was full
+    uint64_t rxOver{0};       ///< Receiver ring buffer overruns
+  };
+
+  /**
+   * Counters of an interface together with the time of the snapshot they belong to.
+   */
+  struct Sample {
+    Counters counters;                          ///< Counters of the interface
+    std::chrono::steady_clock::time_point time; ///< Time the snapshot was read
+    std::string interface;                      ///< Name of the interface, empty for free slots
+    size_t generation{0};                       ///< Changes whenever another interface is assigned to the slot
+  };
+
+  /**
+   * Open the file.
+   * \param procPath Directory containing \c net/dev. Only change this for test purposes.
+   * \param sysPath Path of the sys file system used to find virtual interfaces. Only change this for test purposes.
+   */
+  explicit NetStats(const std::string& procPath = "/proc", const std::string& sysPath = "/sys");
+  ~NetStats();
+  NetStats(const NetStats&) = delete;
+  NetStats& operator=(const NetStats&) = delete;
+
+  /**
+   * Take snapshots using RTM_GETLINK dumps instead of reading \c /proc/net/dev.
+   * \return False if the netlink socket could not be opened. Use getError() to get the reason.
+   */
+  bool useNetlink();
+
+  /**
+   * Assign interfaces to slots.
+   * \param interfaces Interfaces assigned to the first slots.
+   * \param nSlots Number of slots. Slots not used by the given interfaces are free.
+   */
+  void setSlots(const std::vector<std::string>& interfaces, size_t nSlots);
+
+  /**
+   * Subscribe to link notifications, which update the slots.
+   * \return False if the netlink socket could not be opened. Use getError() to get the reason.
+   */
+  bool watchLinks();
+
+  /**
+   * Get the counters of an interface. The interfaces are read if no snapshot exists for the given tick yet, i.e. if
+   * the tick is newer than the tick of the last snapshot.
+   * \param tick Tick of the trigger the counters are requested for.
+   * \param interface Name of the interface.
+   * \param sample Filled with the counters and the time of the snapshot.
+   * \return False if the interfaces could not be read or the interface is not found. Use getError() to get the reason.
+   */
+  bool get(uint64_t tick, const std::string& interface, Sample& sample);
+
+  /**
+   * Get the counters of the interface assigned to a slot, see get(). For free slots the interface name is empty and
+   * the counters are 0.
+   */
+  bool get(uint64_t tick, size_t slot, Sample& sample);
+
+  /** \return Names of the interfaces in the last snapshot. */
+  std::vector<std::string> getInterfaces();
+
+  /** \return Number of snapshots taken, used to check that snapshots are shared. */
+  size_t getNReads();
+
+  /** \return Number of interfaces waiting for a free slot. */
+  size_t getNWaiting();
+
+  /** \return The reason of the last failed call. */
+  std::string getError();
+
+  /**
+   * Update the slots using the link notifications received in a datagram. This is called for each datagram received
+   * on the notification socket and is only public for test purposes.
+   * \return False if the datagram contains an error message.
+   */
+  bool handleNotifications(const char* data, size_t size);
+
+ private:
+  /**
+   * Counters of an interface found in the snapshot.
+   */
+  struct Interface {
+    std::string name;  ///< Interface name
+    int index{0};      ///< Interface index, 0 if read from /proc/net/dev
+    Counters counters; ///< Counters of the interface
+  };
+
+  /**
+   * Interface assigned to a slot or waiting for a free slot.
+   */
+  struct Slot {
+    std::string name;     ///< Interface name, empty for free slots
+    int index{0};         ///< Interface index, 0 if not known yet
+    size_t generation{0}; ///< Incremented whenever another interface is assigned
+  };
+
+  /**
+   * Take a snapshot if no snapshot exists for the tick yet. The caller has to hold the mutex.
+   * \return False if the interfaces could not be read or parsed.
+   */
+  bool update(uint64_t tick);
+
+  /** Take a snapshot and update the slots. */
+  bool read();
+
+  /** Read \c /proc/net/dev. */
+  bool readFile();
+
+  /** Read all interfaces using a RTM_GETLINK dump. */
+  bool readNetlink();
+
+  /** Receive all pending link notifications. */
+  void receiveNotifications();
+
+  /** handleNotifications() without locking the mutex. */
+  bool applyNotifications(const char* data, size_t size);
+
+  /** Reassign the slots according to the last snapshot, used after link notifications were lost. */
+  void resync();
+
+  /** Handle a new or changed interface. */
+  void linkAdded(int index, std::string_view name);
+
+  /** Handle a removed interface. */
+  void linkRemoved(int index, std::string_view name);
+
+  /** \return True if the interface is not virtual, i.e. its sys directory is not found in \c devices/virtual. */
+  bool accept(std::string_view name);
+
+  /** \return Next element of _interfaces to be filled. */
+  Interface& nextInterface();
+
+  std::mutex _mutex;                           ///< Protects all data below
+  std::string _fileName;                       ///< Name of the net/dev file
+  std::string _sysPath;                        ///< Path of the sys file system
+  int _fd{-1};                                 ///< Opened file
+  int _dumpSocket{-1};                         ///< Netlink socket used for RTM_GETLINK dumps
+  int _notificationSocket{-1};                 ///< Netlink socket receiving link notifications
+  uint32_t _sequence{0};                       ///< Sequence number of the last dump request
+  std::string _buffer;                         ///< Buffer reused for reading the file and netlink messages
+  std::vector<Interface> _interfaces;          ///< Interfaces of the last snapshot, elements are reused
+  size_t _nInterfaces{0};                      ///< Number of valid elements in _interfaces
+  std::vector<Slot> _slots;                    ///< Interfaces assigned to slots
+  std::vector<Slot> _waiting;                  ///< Interfaces waiting for a free slot
+  bool _lostNotifications{false};              ///< True if notifications were lost, the slots need a resync
+  std::chrono::steady_clock::time_point _time; ///< Time of the last snapshot
+  uint64_t _tick{0};                           ///< Tick of the last snapshot
+  bool _valid{false};                          ///< True if the last snapshot was read successfully
+  size_t _nReads{0};                           ///< Number of snapshots taken
+  std::string _error;                          ///< Reason of the last failure
+};
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * NumaMemory.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * \brief Reads the memory statistics of the NUMA nodes from \c /sys/devices/system/node.
+ *
+ * The nodes are searched once on construction and the files \c meminfo and \c numastat of each node are kept open.
+ * Like SystemSnapshot an update reads each file using a single pread into a reused buffer.
+ */
+class NumaMemory {
+ public:
+  /**
+   * Memory information of a single node. The sizes are given in kB, the allocation counters in pages since boot
+   * (see \c numastat).
+   */
+  struct Node {
+    uint64_t total{0};         ///< MemTotal
+    uint64_t free{0};          ///< MemFree
+    uint64_t used{0};          ///< MemUsed
+    uint64_t numaHit{0};       ///< Allocated on this node as intended
+    uint64_t numaMiss{0};      ///< Allocated on this node although another node was intended
+    uint64_t numaForeign{0};   ///< Intended for this node but allocated on another node
+    uint64_t interleaveHit{0}; ///< Interleaved allocation on this node as intended
+    uint64_t localNode{0};     ///< Allocated on this node by a process running on this node
+    uint64_t otherNode{0};     ///< Allocated on this node by a process running on another node
+  };
+
+  /**
+   * Search the nodes and open the files.
+   * \param sysPath Path of the sys file system. Only change this for test purposes.
+   */
+  explicit NumaMemory(const std::string& sysPath = "/sys");
+  ~NumaMemory();
+  NumaMemory(const NumaMemory&) = delete;
+  NumaMemory& operator=(const NumaMemory&) = delete;
+  /** Move the opened files, so modules owning a NumaMemory stay movable like all ApplicationModules. */
+  NumaMemory(NumaMemory&& other) noexcept;
+  NumaMemory& operator=(NumaMemory&& other) noexcept;
+
+  /**
+   * Read and parse the files of all nodes. Values of files that could not be read are kept.
+   * \return False if a file could not be read or parsed. Use getError() to get the reason.
+   */
+  bool update();
+
+  /** \return IDs of the nodes. Empty if NUMA is not supported. */
+  const std::vector<std::string>& getNodeIds() const { return _ids; }
+
+  /** \return Information of the nodes in the order of getNodeIds(). */
+  const std::vector<Node>& getNodes() const { return _nodes; }
+
+  /** \return The reason of the last failed update. */
+  const std::string& getError() const { return _error; }
+
+ private:
+  bool parseMeminfo(std::string_view data, Node& node);
+  bool parseNumastat(std::string_view data, Node& node);
+
+  /** Set _error and return false. */
+  bool fail(size_t node, const char* file, const char* reason);
+
+  /** Close all files. */
+  void close();
+
+  std::string _nodePath;                ///< Directory containing the nodes
+  std::vector<std::string> _ids;        ///< IDs of the nodes
+  std::vector<int> _meminfo, _numastat; ///< Opened files, -1 if a file could not be opened
+  std::string _buffer;                  ///< Buffer reused for reading the files
+  std::vector<Node> _nodes;             ///< Information of the nodes
+  std::string _error;                   ///< Reason of the last failed update
+};
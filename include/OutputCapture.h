@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * OutputCapture.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "LineRing.h"
+#include "LogScanner.h"
+#include "LogWatchReactor.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * \brief Capture the output of a process using a pipe.
+ *
+ * The read end of the pipe connected to stdout/stderr of the process is drained by the LogWatchReactor thread and
+ * the last lines are kept in memory. Thus, the tail is available without writing the output to disk and reading it
+ * back. Optionally the output is also written to a log file. These writes are collected and done in batches by
+ * calling flush(), e.g. once per trigger from the module thread. So neither the process nor the reactor thread is
+ * blocked by the disk. If the log file can not be written (e.g. the disk is full) the data is dropped, but the tail
+ * is still available.
+ *
+ * The capture can be reused for several pipes, e.g. after restarting the process. The tail is kept in that case.
+ * Always create it as std::shared_ptr, because the reactor only keeps a weak reference.
+ */
+class OutputCapture : public std::enable_shared_from_this<OutputCapture> {
+ public:
+  /**
+   * \param maxPending Maximum number of bytes waiting to be written to the log file. Additional data is dropped.
+   */
+  explicit OutputCapture(size_t maxPending = 1024 * 1024);
+  ~OutputCapture();
+  OutputCapture(const OutputCapture&) = delete;
+  OutputCapture& operator=(const OutputCapture&) = delete;
+
+  /**
+   * Start reading from a pipe. A previously attached pipe is closed.
+   * \param fd Read end of the pipe. The capture takes ownership of it.
+   */
+  void attach(int fd);
+
+  /**
+   * Stop reading and close the pipe.
+   */
+  void detach();
+
+  /**
+   * Set the number of lines in the tail.
+   */
+  void setTailLength(size_t tailLength);
+
+  /**
+   * Set the log file. Pass an empty string in order to not write a log file.
+   */
+  void setLogFile(const std::string& fileName);
+
+  /**
+   * Close the log file, so it is opened again with the next flush(). Call this after the log file was rotated.
+   */
+  void reopenLogFile();
+
+  /**
+   * Set the scanner that gets all captured output. It is called from the reactor thread.
+   * \param scanner The scanner or nullptr to disable scanning.
+   */
+  void setScanner(std::shared_ptr<LogScanner> scanner);
+
+  /**
+   * Write the collected output to the log file.
+   */
+  void flush();
+
+  /**
+   * Get the tail.
+   * \param tail Set to the tail if it changed since the last call.
+   * \return True if the tail changed.
+   */
+  bool update(std::string& tail);
+
+  /**
+   * \return Number of bytes that could not be written to the log file.
+   */
+  size_t getDroppedBytes();
+
+ private:
+  /**
+   * Read the available data from the pipe. Called by the reactor thread or by update() if no reactor is available.
+   * \return False if the writing end of the pipe was closed.
+   */
+  bool read();
+
+  std::shared_ptr<LogWatchReactor> _reactor; ///< Thread draining the pipe, nullptr if not available
+  std::mutex _mutex;                         ///< Protects all data below
+  int _fd{-1};                               ///< Read end of the pipe
+  LineRing _lines;                           ///< Last lines of the output
+  bool _changed{true};                       ///< Lines changed since the last update
+  std::string _pending;                      ///< Data not yet written to the log file
+  size_t _maxPending;                        ///< Maximum size of _pending
+  size_t _dropped{0};                        ///< Number of bytes not written to the log file
+  std::string _logFileName;                  ///< Name of the log file
+  int _logFD{-1};                            ///< Log file opened for appending
+  std::shared_ptr<LogScanner> _scanner;      ///< Scanner for the output, nullptr if not used
+};
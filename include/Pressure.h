@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * Pressure.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * \brief Reads the pressure stall information (PSI) of cpu, memory and io and waits for PSI triggers.
+ *
+ * The files are kept open and read using a single pread, like in SystemSnapshot. System wide the files are
+ * \c /proc/pressure/{cpu,memory,io}, for a cgroup (v2) they are \c {cpu,memory,io}.pressure in the cgroup directory.
+ *
+ * In addition the kernel can be asked to notify if the stall time exceeds a threshold within a time window (see
+ * addTrigger()). wait() returns as soon as one of the triggers fires, so pressure is noticed without polling the
+ * files. Registering triggers requires CAP_SYS_RESOURCE on kernels older than 6.4. A thread blocked in wait() can be
+ * woken up from another thread using interrupt().
+ */
+class Pressure {
+ public:
+  /** Resources the pressure is reported for */
+  enum Resource { CPU, MEMORY, IO, N_RESOURCES };
+
+  /** Names of the resources as used in the file names */
+  static constexpr const char* names[N_RESOURCES] = {"cpu", "memory", "io"};
+
+  /**
+   * Pressure of a single line of a PSI file.
+   */
+  struct Stall {
+    double avg10{0};   ///< Share of time stalled within the last 10 s in %
+    double avg60{0};   ///< Share of time stalled within the last 60 s in %
+    double avg300{0};  ///< Share of time stalled within the last 300 s in %
+    uint64_t total{0}; ///< Total stall time in us
+  };
+
+  /**
+   * Pressure of a resource.
+   */
+  struct Values {
+    Stall some; ///< At least one task stalled
+    Stall full; ///< All non-idle tasks stalled at the same time. Always 0 for the system wide cpu pressure.
+  };
+
+  /**
+   * Open the files.
+   * \param directory Directory containing the files. No files are opened if it is empty.
+   * \param suffix Appended to the resource names to get the file names, e.g. ".pressure" for cgroups.
+   */
+  explicit Pressure(const std::string& directory = "/proc/pressure", const std::string& suffix = "");
+  ~Pressure();
+  Pressure(const Pressure&) = delete;
+  Pressure& operator=(const Pressure&) = delete;
+  /** Move the opened files, so modules owning a Pressure stay movable like all ApplicationModules. */
+  Pressure(Pressure&& other) noexcept;
+  Pressure& operator=(Pressure&& other) noexcept;
+
+  /**
+   * Read and parse all files. Values of files that could not be read are kept.
+   * \return False if a file could not be read or parsed. Use getError() to get the reason.
+   */
+  bool update();
+
+  /** \return True if the file of the resource could be opened, i.e. the kernel supports PSI. */
+  bool isAvailable(Resource resource) const { return _fds[resource] >= 0; }
+
+  /** \return Pressure of the resource read by the last update. */
+  const Values& get(Resource resource) const { return _values[resource]; }
+
+  /**
+   * Register a PSI trigger. Only one trigger per resource is supported, an existing trigger is replaced.
+   * \param resource The resource.
+   * \param full Use the stall time of all tasks instead of the stall time of at least one task.
+   * \param threshold Stall time in us that fires the trigger.
+   * \param window Time window in us the stall time is measured in. The kernel requires 500 ms to 10 s and a multiple
+   * of 2 s for processes without CAP_SYS_RESOURCE.
+   * \return False if the trigger could not be registered. Use getError() to get the reason.
+   */
+  bool addTrigger(Resource resource, bool full, uint64_t threshold, uint64_t window);
+
+  /** \return Number of registered triggers. */
+  size_t getNTriggers() const;
+
+  /**
+   * Wait until a trigger fires. Triggers that report an error, e.g. because the cgroup was removed, are dropped.
+   * \param timeout Maximum time to wait in ms, -1 to wait until a trigger fires or interrupt() is called.
+   * \return Bit mask of the resources whose triggers fired (1 << Resource), 0 if the timeout expired or wait() was
+   * interrupted.
+   */
+  unsigned int wait(int timeout);
+
+  /**
+   * Wake up wait(). This is the only function that may be called while another thread is blocked in wait(). Once
+   * called, every following wait() returns immediately.
+   */
+  void interrupt();
+
+  /** \return The reason of the last failure. */
+  const std::string& getError() const { return _error; }
+
+  /**
+   * Find the directory of the cgroup (v2) of the calling process that provides pressure files.
+   * \param selfCgroup File listing the cgroups of the process. Only change this for test purposes.
+   * \param cgroupRoots Mount points checked for the unified hierarchy.
+   * \return The directory or an empty string if the process is in the root cgroup or no pressure files are found.
+   */
+  static std::string findCgroup(const std::string& selfCgroup = "/proc/self/cgroup",
+      const std::array<std::string, 2>& cgroupRoots = {"/sys/fs/cgroup", "/sys/fs/cgroup/unified"});
+
+ private:
+  /** \return The file name of a resource. */
+  std::string fileName(Resource resource) const;
+
+  /** Parse the content of a PSI file. */
+  bool parse(std::string_view data, Values& values);
+
+  /** Set _error and return false. */
+  bool fail(Resource resource, const std::string& reason);
+
+  /** Close all files. */
+  void close();
+
+  std::string _directory;                   ///< Directory containing the files
+  std::string _suffix;                      ///< Suffix of the file names
+  std::array<int, N_RESOURCES> _fds;        ///< Opened files, -1 if a file could not be opened
+  std::array<int, N_RESOURCES> _triggerFds; ///< Files the triggers are registered on, -1 if no trigger is used
+  int _wakeFd{-1};                          ///< Eventfd used by interrupt() to wake up wait()
+  std::array<Values, N_RESOURCES> _values;  ///< Pressure read by the last update
+  std::string _buffer;                      ///< Buffer reused for reading the files
+  std::string _error;                       ///< Reason of the last failure
+};
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * ProcFile.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * \brief Helpers used to read and parse files in \c /proc and \c /sys without creating strings.
+ *
+ * They are used by readers that keep their files open and read them once per trigger, like SystemSnapshot.
+ */
+namespace procfs {
+
+  /**
+   * Read the complete file using pread at offset 0, so the file can be kept open and read again for the next sample.
+   * The buffer is reused and enlarged if the file does not fit.
+   * \param fd The opened file.
+   * \param buffer Buffer reused for reading.
+   * \return The data, which points into the buffer, or an empty view if the file could not be read.
+   */
+  std::string_view readFile(int fd, std::string& buffer);
+
+  /** Cut the first line from data. */
+  inline std::string_view nextLine(std::string_view& data) {
+    auto end = data.find('\n');
+    auto line = data.substr(0, end);
+    data.remove_prefix(end == std::string_view::npos ? data.size() : end + 1);
+    return line;
+  }
+
+  /** Cut the next word from text, leading spaces are skipped. */
+  inline std::string_view nextWord(std::string_view& text) {
+    auto start = text.find_first_not_of(' ');
+    if(start == std::string_view::npos) start = text.size();
+    text.remove_prefix(start);
+    auto end = std::min(text.find(' '), text.size());
+    auto word = text.substr(0, end);
+    text.remove_prefix(end);
+    return word;
+  }
+
+  /** Parse an unsigned number at the beginning of text and cut it, leading spaces are skipped. */
+  bool parseNumber(std::string_view& text, uint64_t& value);
+
+  /** Parse a decimal number like 1234.56 at the beginning of text and cut it, leading spaces are skipped. */
+  bool parseDecimal(std::string_view& text, double& value);
+
+} // namespace procfs
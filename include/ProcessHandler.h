@@ -9,9 +9,12 @@
  *      Author: Klaus Zenker (HZDR)
  */
 
+#include "ExecSpec.h"
 #include "Logging.h"
+#include "MessageQueue.h"
 
 #include <iostream>
+#include <memory>
 #include <string>
 
 #ifndef WITH_PROCPS
@@ -41,6 +44,11 @@
  * If this is the case it is killed. First the process is killed using SIGINT
  * and if that fails SIGKILL is used.
  *
+ * If the spawn::SpawnHelper is running the process is started by the helper instead
+ * of forking the calling process. In that case the helper only reports the PID once
+ * execve succeeded and no delay is needed before reading the PID file. If the helper
+ * was started but died, startProcess fails instead of forking the calling process.
+ *
  * \attention Use the setupHandler() function once to define a handler for the
  * SIGCHLD signal!
  */
@@ -77,15 +85,24 @@ struct ProcessHandler {
    */
   bool isPIDFolderWritable();
 
+  /**
+   * Send a message if its level is not below the current log level.
+   * It is pushed to the message queue or printed to std::cout if no queue is set.
+   */
+  void send(const logging::LogLevel& level, const std::string& text);
+
+  /** Queue used to send messages, nullptr to print them to std::cout */
+  std::shared_ptr<logging::MessageQueue> messages;
   int pid;                ///< The pid of the last process that was started.
   std::string pidFile;    ///< Name of the temporary file that holds the child PID
   bool deletePIDFile;     ///< If true the PID file is deleted after reading the PID.
   int signum;             ///< Signal used to stop a process
-  std::ostream& os;       ///< Stream used to send messages
   logging::LogLevel log;  ///< The current log level
   const std::string name; ///< Name of this class
   bool connected;         ///< If false no cleanup is performed on destructor call
   size_t killTimeout;     ///< Time in seconds to wait for a process to exit before using SIGKILL
+  int outputFD{-1};       ///< Read end of the pipe connected to stdout/stderr of the process if output is captured
+  uint64_t spawnID{0};    ///< Spawn ID of the process if it was started by the spawn::SpawnHelper, else 0
 #ifndef WITH_PROCPS
   struct pids_info* infoptr{nullptr};
 #endif
@@ -96,7 +113,7 @@ struct ProcessHandler {
    * It is checked if a process is already running. This is done by testing if the
    * PID file already exists and a process with the PID read from the PID file is found.
    * \param PIDFileName the name of the PID file -> will result in: PIDFileName.PID
-   * \param os The ostream used to send status messages and errors.
+   * \param messages The queue used to send status messages and errors. If nullptr they are printed to std::cout.
    * \param deletePIDFile If true the PID file deleted directly after reading the PID.
    * \param name Give a name to the ProcessHandler to distinguish between multiple handlers.
    * It is used in the messages send by the handler.
@@ -105,12 +122,12 @@ struct ProcessHandler {
    * ProcessHandler is not terminated correctly and started again.
    * \param PID The PID is set in case a running process was found. Else it is set to -1.
    */
-  ProcessHandler(const std::string& PIDFileName, const bool deletePIDFile, int& PID, std::ostream& os,
-      const std::string& name = "");
+  ProcessHandler(const std::string& PIDFileName, const bool deletePIDFile, int& PID,
+      std::shared_ptr<logging::MessageQueue> messages, const std::string& name = "");
   /**
    * Constructor.
    * \param PIDFileName the name of the PID file -> will result in: PIDFileName.PID
-   * \param os The ostream used to send status messages and errors.
+   * \param messages The queue used to send status messages and errors. If nullptr they are printed to std::cout.
    * \param deletePIDFile If true the PID file deleted directly after reading the PID.
    * \param name Give a name to the ProcessHandler to distinguish between multiple handlers.
    * It is used in the messages send by the handler.
@@ -118,15 +135,15 @@ struct ProcessHandler {
    * with the same PID file settings. But you can not check for a running process if the
    * ProcessHandler is not terminated correctly and started again.
    */
-  ProcessHandler(const std::string& PIDFileName, const bool deletePIDFile = false, std::ostream& os = std::cout,
-      const std::string& name = "");
+  ProcessHandler(const std::string& PIDFileName, const bool deletePIDFile = false,
+      std::shared_ptr<logging::MessageQueue> messages = nullptr, const std::string& name = "");
 #else
   /**
    * Constructor.
    * It is checked if a process is already running. This is done by testing if the
    * PID file already exists and a process with the PID read from the PID file is found.
    * \param PIDFileName the name of the PID file -> will result in: PIDFileName.PID
-   * \param os The ostream used to send status messages and errors.
+   * \param messages The queue used to send status messages and errors. If nullptr they are printed to std::cout.
    * \param deletePIDFile If true the PID file deleted directly after reading the PID.
    * \param name Give a name to the ProcessHandler to distinguish between multiple handlers.
    * It is used in the messages send by the handler.
@@ -138,12 +155,12 @@ struct ProcessHandler {
    * PIDS_ID_PGRP
    */
   ProcessHandler(const std::string& PIDFileName, pids_info* infoptr, const bool deletePIDFile, int& PID,
-      std::ostream& os, const std::string& name = "");
+      std::shared_ptr<logging::MessageQueue> messages, const std::string& name = "");
 
   /**
    * Constructor.
    * \param PIDFileName the name of the PID file -> will result in: PIDFileName.PID
-   * \param os The ostream used to send status messages and errors.
+   * \param messages The queue used to send status messages and errors. If nullptr they are printed to std::cout.
    * \param deletePIDFile If true the PID file deleted directly after reading the PID.
    * \param name Give a name to the ProcessHandler to distinguish between multiple handlers.
    * \param infoptr Procps info pointer. It will not be cleaned up here! It has to contain two entries: PIDS_ID_PID,
@@ -154,7 +171,7 @@ struct ProcessHandler {
    * ProcessHandler is not terminated correctly and started again.
    */
   ProcessHandler(const std::string& PIDFileName, pids_info* infoptr, const bool deletePIDFile = false,
-      std::ostream& os = std::cout, const std::string& name = "");
+      std::shared_ptr<logging::MessageQueue> messages = nullptr, const std::string& name = "");
 
 #endif
 
@@ -183,7 +200,7 @@ struct ProcessHandler {
    * that file already exists new output will be appended.
    * \param environment Set environment variables if needed (e.g. ENSHOST=localhost,
    * PATH=/home/bin:/home/test/bin). Separate different environments using a comma.
-   * Separate different paths per environment using a colon.
+   * Separate different paths per environment using a colon. Quotes can be used as described in ExecSpec.
    * \param overwriteENV If true the environment variables are overwritten. Else they
    * are extended.
    * \return PID of the created process
@@ -193,11 +210,45 @@ struct ProcessHandler {
   size_t startProcess(const std::string& path, const std::string& cmd, const std::string& logfile,
       const std::string& environment = "", const bool& overwriteENV = false);
 
+  /**
+   * Start a process using a command that was already prepared.
+   * Keep the ExecSpec and pass it again when restarting the process. Thus, the command and environment are only
+   * parsed once. See startProcess above for a description of the remaining parameters.
+   * \param exec Prepared command, working directory and environment.
+   * \param logfile Name of the log file. It is not used if the output is captured.
+   * \param captureOutput If true stdout/stderr of the process are connected to a pipe instead of the log file. Get
+   * the read end of the pipe using takeOutputFD().
+   * \return PID of the created process
+   */
+  size_t startProcess(
+      std::shared_ptr<const ExecSpec> exec, const std::string& logfile, const bool captureOutput = false);
+
+  /**
+   * Get the read end of the pipe connected to stdout/stderr of the last started process.
+   * \return The file descriptor, which is owned by the caller afterwards, or -1 if the output is not captured.
+   */
+  int takeOutputFD();
+
   /**
    * \param sig Signal used to kill the process (e.g. SIGINT = 2, SIGKILL = 9)
    */
   void setSigNum(int sig) { signum = sig; }
 
+  /**
+   * Send a signal to the process group of the started process without waiting for the process to exit.
+   * \param sig Signal to be send (e.g. SIGINT = 2, SIGKILL = 9)
+   * \return False if no process was started or the signal could not be send.
+   */
+  bool sendSignal(int sig);
+
+  /**
+   * Get the exit status of the last started process.
+   * This is only available if the process was started by the spawn::SpawnHelper.
+   * \param status The status as returned by waitpid.
+   * \return False if the exit status is not known.
+   */
+  bool getExitStatus(int& status);
+
   /**
    * Tell all file handles to be closed when exec is called.
    * Therefore this should be called after forking in the child process brefore calling
@@ -212,7 +263,7 @@ struct ProcessHandler {
   /**
    * Set the log level.
    *
-   * Depending on the level messages are put to the ostream.
+   * Depending on the level messages are put to the message queue.
    */
   void SetLogLevel(const logging::LogLevel& level) { log = level; }
 
@@ -12,12 +12,18 @@
 #include <ChimeraTK/ApplicationCore/ApplicationCore.h>
 #include <ChimeraTK/ApplicationCore/Logging.h>
 
+#include <algorithm>
 #include <memory>
 
 namespace ctk = ChimeraTK;
 
+#include "HangDetector.h"
 #include "LogFileReader.h"
+#include "LogRotator.h"
+#include "LogScanner.h"
+#include "OutputCapture.h"
 #include "ProcessHandler.h"
+#include "ResourceLimiter.h"
 #include "sys_stat.h"
 
 /**
@@ -119,6 +125,13 @@ struct ProcessInfoModule : public ctk::ApplicationModule {
      */
     ctk::ScalarOutput<double> avgcpu{
         this, "avgcpu", "%", "Average CPU usage", {"PROCESS", getName(), "DAQ", "history"}};
+    /** number of threads of the process */
+    ctk::ScalarOutput<uint> nThreads{this, "nThreads", "", "Number of threads", {"PROCESS", getName(), "DAQ"}};
+    /** number of open file descriptors of the process, only counted if needed (see fdCountInterval()) */
+    ctk::ScalarOutput<uint> nFDs{this, "nFDs", "",
+        "Number of open file descriptors, 0 if not counted since no FD limit is set. Counted only every limitTicks "
+        "triggers.",
+        {"PROCESS", getName(), "DAQ"}};
     /** @} */
   } statistics{this, "statistics", "Process statistics read from the operating system"};
 
@@ -126,6 +139,24 @@ struct ProcessInfoModule : public ctk::ApplicationModule {
    * Application core main loop.
    */
   void mainLoop() override;
+
+  /**
+   * Counting the open file descriptors requires reading the /proc/PID/fd directory, which is costly for processes with
+   * many open files.
+   * \return Number of updates the FDs are counted in FillProcInfo, the count is kept in between. 0 if the FDs are not
+   * counted, which is the default.
+   */
+  virtual unsigned int fdCountInterval() { return 0; }
+
+  /**
+   * Count the open file descriptors if needed according to fdCountInterval().
+   */
+  void updateNFDs(size_t pid);
+
+  /**
+   * Number of updates since the FDs were counted. Set it to 0 to count them at the next update, e.g. for a new process.
+   */
+  unsigned int _fdTicks{0};
 #ifdef WITH_PROCPS
   /**
    * Fill process information read via proc interface.
@@ -162,14 +193,13 @@ struct ProcessControlModule : public ProcessInfoModule {
   : ProcessInfoModule(owner, name, description, tags, pathToTrigger), _historyOn(historyOn) {};
 
   /**
-   * Search for key words in the given stream (LogLevels like DEBUG, INFO...).
-   * Splits the stream using Logging::stripMessages().
-   * Then sends individual messages to the LoggingModule.
+   * Send the messages queued by the ProcessHandler to the LoggingModule. They keep their log level, so they are not
+   * parsed again.
    */
-  void evaluateMessage(std::stringstream& msg);
+  void evaluateMessage();
 
-  /* Use terminate function to delete the ProcessHandler, since it is using a local stringstream constructed in the main
-   * loop which is not existing at the time the ProcessHandler destructor is called!
+  /* Use terminate function to delete the ProcessHandler, since the process has to be handled before the application
+   * is destroyed. Messages of the ProcessHandler destructor are queued but no longer send to the LoggingModule.
    */
   void terminate() override;
 
@@ -202,8 +232,42 @@ struct ProcessControlModule : public ProcessInfoModule {
         "Name of the logfile created in the given path (the process controlled by the module will "
         "put its output here. Module messages go to cout/cerr",
         {"PROCESS", getName()}};
+    /** Number of times the process was found hung */
+    ctk::ScalarOutput<uint> nHangs{this, "nHangs", "",
+        "Number of times the process was considered hung and restarted by the watchdog since server start.",
+        {"PROCESS", getName(), "DAQ"}};
+    /** Resource limit status */
+    ctk::ScalarOutput<uint> limitStatus{this, "limitStatus", "",
+        "Resource limit status -> 0: ok, 1: limits exceeded (warning), 2: process stopped gracefully, 3: process "
+        "killed",
+        {"PROCESS", getName(), "DAQ"}};
+    /** Captured output not written to the log file */
+    ctk::ScalarOutput<uint64_t> logBytesDropped{this, "logBytesDropped", "",
+        "Number of bytes of the captured process output that could not be written to the log file.",
+        {"PROCESS", getName()}};
+    /** Number of log file rotations */
+    ctk::ScalarOutput<uint> nLogRotations{this, "nLogRotations", "",
+        "Number of times logfileExternal was rotated since server start.", {"PROCESS", getName()}};
+    /** Number of log lines matching config/logPatterns */
+    ctk::ArrayOutput<uint64_t> logPatternCounts{this, "logPatternCounts", "", LogScanner::maxPatterns,
+        "Number of new log lines matching the patterns set in config/logPatterns since the patterns were set.",
+        {"PROCESS", getName(), "DAQ"}};
+    /** Rate of log lines matching config/logPatterns */
+    ctk::ArrayOutput<double> logPatternRates{this, "logPatternRates", "1/s", LogScanner::maxPatterns,
+        "Number of new log lines per second matching the patterns set in config/logPatterns.",
+        {"PROCESS", getName(), "DAQ"}};
   } status{this, "status", "Status parameter of the process"};
 
+  /**
+   * The tail can be several kB, so it is kept out of status and only written if it changed (see writeStatus()).
+   */
+  struct LogStatus : public ctk::VariableGroup {
+    using ctk::VariableGroup::VariableGroup;
+    /** Tail of the log file written by the process */
+    ctk::ScalarOutput<std::string> logTailExtern{this, "logTailExternal", "",
+        "Tail of the log file written by the process started by the watchdog.", {"PROCESS", getName()}};
+  } logStatus{this, "status", "Status parameter of the process"};
+
   struct Config : public ctk::VariableGroup {
     using ctk::VariableGroup::VariableGroup;
     /** Path where to execute the command used to start the process */
@@ -226,6 +290,14 @@ struct ProcessControlModule : public ProcessInfoModule {
         "Set the name of the logfile"
         " used by the process to be started. It is created in the given path.",
         {"PROCESS", getName()}};
+    ctk::ScalarPollInput<uint> tailLength{this, "logTailLengthExternal", "",
+        "Maximum number of messages to be shown in the logfile tail.", {"PROCESS", getName()}};
+    /** Output capture mode (0: off, 1: memory only, 2: memory and log file) */
+    ctk::ScalarPollInput<uint> captureOutput{this, "captureOutput", "",
+        "Capture stdout/stderr of the process using a pipe -> 0: off, the process writes logfileExternal itself, 1: "
+        "keep the tail in memory only, 2: keep the tail in memory and write logfileExternal in batches. Changes are "
+        "applied when the process is started.",
+        {"PROCESS", getName()}};
     /** Signal used to kill the process (2: SIGINT, 9: SIGKILL) */
     ctk::ScalarPollInput<uint> killSig{
         this, "killSig", "", "Signal used to kill the process (2: SIGINT, 9: SIGKILL)", {"PROCESS", getName()}};
@@ -240,8 +312,63 @@ struct ProcessControlModule : public ProcessInfoModule {
         "This is the maximum time waited for the process to exit after stopping. After, it is"
         " stopped using SIGKILL.",
         {"PROCESS", getName(), "DAQ"}};
+    ctk::ScalarPollInput<uint> hangTimeout{this, "hangTimeout", "s",
+        "If the heartbeat of the process does not change for longer than this time the process is considered hung "
+        "and it is restarted. Set 0 to disable hang detection.",
+        {"PROCESS", getName()}};
+    ctk::ScalarPollInput<uint> heartbeatSource{this, "heartbeatSource", "",
+        "Heartbeat used for hang detection. 0: CPU time of the process, 1: modification time of the heartbeat file, "
+        "2: 64 bit counter stored at the beginning of the heartbeat file (e.g. shared memory in /dev/shm)",
+        {"PROCESS", getName()}};
+    ctk::ScalarPollInput<std::string> heartbeatFile{this, "heartbeatFile", "",
+        "Heartbeat file used for hang detection. Relative paths are relative to the process path.",
+        {"PROCESS", getName()}};
+    /**
+     * \name Resource limits
+     * @{
+     */
+    ctk::ScalarPollInput<uint64_t> maxMem{this, "maxMem", "kB",
+        "Maximum resident memory of the process. Set 0 to disable the limit.", {"PROCESS", getName()}};
+    ctk::ScalarPollInput<double> maxCPU{this, "maxCPU", "%",
+        "Maximum CPU usage of the process averaged over cpuWindow triggers. Set 0 to disable the limit.",
+        {"PROCESS", getName()}};
+    ctk::ScalarPollInput<uint> cpuWindow{
+        this, "cpuWindow", "", "Number of triggers used to average the CPU usage.", {"PROCESS", getName()}};
+    ctk::ScalarPollInput<uint> maxFDs{this, "maxFDs", "",
+        "Maximum number of open file descriptors. Set 0 to disable the limit.", {"PROCESS", getName()}};
+    ctk::ScalarPollInput<uint> maxThreads{
+        this, "maxThreads", "", "Maximum number of threads. Set 0 to disable the limit.", {"PROCESS", getName()}};
+    ctk::ScalarPollInput<uint> limitTicks{this, "limitTicks", "",
+        "Number of consecutive triggers a limit has to be exceeded before a warning is issued. After twice the "
+        "number the process is stopped using killSig and restarted, after three times it is killed using SIGKILL.",
+        {"PROCESS", getName()}};
+    /** @} */
+    /**
+     * \name Log rotation
+     * @{
+     */
+    ctk::ScalarPollInput<uint64_t> logMaxSize{this, "logMaxSize", "kB",
+        "Rotate logfileExternal if it is larger than this size. Set 0 to disable size based rotation.",
+        {"PROCESS", getName()}};
+    ctk::ScalarPollInput<uint> logMaxAge{this, "logMaxAge", "s",
+        "Rotate logfileExternal if it was not rotated for this time. Set 0 to disable age based rotation.",
+        {"PROCESS", getName()}};
+    ctk::ScalarPollInput<uint64_t> logRetention{this, "logRetention", "kB",
+        "Maximum total size of the rotated log files. The oldest files are removed. Set 0 to keep all files.",
+        {"PROCESS", getName()}};
+    ctk::ScalarPollInput<uint> logCompress{
+        this, "logCompress", "", "Compress rotated log files using gzip -> 0: off, 1: on", {"PROCESS", getName()}};
+    /** @} */
+    ctk::ScalarPollInput<std::string> logPatterns{this, "logPatterns", "",
+        "Comma separated list of up to 16 patterns counted in new lines of the process output, e.g. "
+        "ERROR,timeout,/segfault|core dumped/. Patterns enclosed in slashes are regular expressions. Use single "
+        "quotes for patterns including commas or backslashes.",
+        {"PROCESS", getName()}};
   } config{this, "config", "Configuration parameters of the process"};
 
+  /** Pages of the log file written by the process, not available in capture mode 1 */
+  LogPage logPage{this, "logPage", "Read pages of logfileExternal"};
+
   /** Start the process */
   ctk::ScalarPollInput<ctk::Boolean> enableProcess{
       this, "enableProcess", "", "Start the process", {"PROCESS", getName()}};
@@ -273,10 +400,47 @@ struct ProcessControlModule : public ProcessInfoModule {
    */
   void CheckIsOnline(const int pid);
 
+  /**
+   * Check if the running process still makes progress according to the heartbeat selected by heartbeatSource.
+   * \return True if the heartbeat did not change for longer than hangTimeout.
+   */
+  bool CheckIsHung();
+
+  /**
+   * Evaluate the resource limits using the statistics filled by FillProcInfo and escalate if limits are exceeded:
+   * warning -> graceful stop (killSig) followed by the normal restart -> SIGKILL.
+   */
+  void CheckLimits();
+
+  /**
+   * The FDs are only needed if the FD limit is enabled. A limit is only escalated after it was exceeded for limitTicks
+   * triggers, so they are counted once per limitTicks triggers.
+   */
+  unsigned int fdCountInterval() override { return config.maxFDs == 0 ? 0 : std::max(1U, (uint)config.limitTicks); }
+
   /**
    * Set kill signal according to user setting set in killSig. After reset the ProcessHandler.
    */
-  void resetProcessHandler(std::stringstream* handlerMessage);
+  void resetProcessHandler();
+
+  /**
+   * Read the tail of the log file written by the process and publish it in status/logTailExternal.
+   * Before, the log file is rotated if required. Afterwards, the requested page of the log file is read.
+   * The tail and the page are only written if they changed.
+   */
+  void updateLogTail();
+
+  /**
+   * Write the process information, statistics and status. Used instead of writeAll(), which would also send the
+   * unchanged log tail and log page on every trigger.
+   */
+  void writeStatus();
+
+  /**
+   * Get the prepared command. It is only parsed again if the user changed path, cmd, env or overwriteEnv.
+   * \throw std::runtime_error If path or command are not set or the command can not be parsed.
+   */
+  std::shared_ptr<const ExecSpec> getExecSpec();
 
   /**
    * Application core main loop.
@@ -301,20 +465,90 @@ struct ProcessControlModule : public ProcessInfoModule {
    * This is needed to end up with a meaningful history buffer in case server based history is enabled.
    */
   bool _historyOn;
-};
 
-struct ProcessGroup : public ctk::ModuleGroup {
-  using ctk::ModuleGroup::ModuleGroup;
+  /**
+   * Used to detect a process that is running but no longer makes progress.
+   */
+  HangDetector _hangDetector;
+
+  /**
+   * Set once an invalid heartbeat source or a failed heartbeat read was reported, so it is reported only once per
+   * process start.
+   */
+  bool _heartbeatError{false};
+
+  /**
+   * Used to evaluate the resource limits of the process.
+   */
+  ResourceLimiter _limiter;
+
+  /**
+   * Command prepared for execve. It is reused for restarts as long as the configuration is not changed.
+   */
+  std::shared_ptr<const ExecSpec> _execSpec;
+
+  /**
+   * Follows the log file of the process.
+   */
+  LogTail _logTail;
+
+  /**
+   * Captured output of the process, used if config/captureOutput is set.
+   */
+  std::shared_ptr<OutputCapture> _capture;
 
   /**
-   * \brief This module is used to start and stop subprocess controlled by the watchdog.
+   * Capture mode used when the process was started successfully. _capture is set if it is not 0.
    */
+  uint _captureMode{0};
+
+  /**
+   * Messages of the ProcessHandler, including their log level.
+   */
+  std::shared_ptr<logging::MessageQueue> _handlerMessages{std::make_shared<logging::MessageQueue>()};
+
+  /**
+   * Record reused when reading _handlerMessages.
+   */
+  logging::Record _handlerRecord;
+
+  /**
+   * Rotates the log file of the process.
+   */
+  LogRotator _rotator;
+
+  /**
+   * Counts the log lines matching config/logPatterns. Shared with the log tail and the output capture.
+   */
+  std::shared_ptr<LogScanner> _scanner{std::make_shared<LogScanner>()};
+
+  /**
+   * Patterns set in the scanner, used to detect changes of config/logPatterns.
+   */
+  std::string _logPatterns;
+
+  /**
+   * Counts and time of the last update, used to calculate the rates.
+   */
+  std::vector<uint64_t> _lastPatternCounts;
+  std::chrono::steady_clock::time_point _lastPatternUpdate;
+
+  /**
+   * Set the patterns and publish the counts and rates.
+   */
+  void updateLogPatterns();
+};
+
+struct ProcessGroup : public ctk::ModuleGroup {
+  using ctk::ModuleGroup::ModuleGroup;
 
   /**
    * vector storing processes
    * The vector is filled during construction using information from the input xml file called:
    * watchdog_server_processes.xml
+   * Each process slot is a single ApplicationModule and thus still runs its own thread, so the number of threads grows
+   * with the number of slots. The slot also publishes the tail of the log file of the process, so no second module is
+   * needed per slot. Slots are activated and configured at runtime using their enableProcess and config variables.
    */
   std::vector<ProcessControlModule> processes;
-  std::vector<LogFileModule> processesLogExternal;
 };
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * ResourceLimiter.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Evaluate resource limits of a process and decide how to escalate.
+ *
+ * The limiter is fed once per trigger with the process statistics that are already collected by the
+ * ProcessInfoModule. If at least one limit is exceeded for nTicks consecutive triggers a warning is issued.
+ * If the breach persists for 2*nTicks the process should be stopped gracefully and restarted. If it is still
+ * running and exceeding the limits after 3*nTicks it should be killed.
+ */
+class ResourceLimiter {
+ public:
+  /**
+   * Escalation steps.
+   */
+  enum class Action {
+    None = 0,    ///< All limits are respected or no new escalation step was reached
+    Warning = 1, ///< Limits exceeded for nTicks triggers
+    Restart = 2, ///< Limits exceeded for 2*nTicks triggers -> stop gracefully, the process is restarted
+    Kill = 3     ///< Limits exceeded for 3*nTicks triggers -> SIGKILL
+  };
+
+  /**
+   * Limits. A limit set to 0 is not evaluated.
+   */
+  struct Limits {
+    uint64_t maxMem{0};          ///< Resident memory in kB
+    double maxCPU{0.};           ///< CPU usage in % averaged over cpuWindow triggers
+    unsigned int cpuWindow{1};   ///< Number of triggers used to average the CPU usage
+    unsigned int maxFDs{0};      ///< Number of open file descriptors
+    unsigned int maxThreads{0};  ///< Number of threads
+    unsigned int nTicks{1};      ///< Number of consecutive triggers before escalating
+  };
+
+  /**
+   * Process statistics of a single trigger.
+   */
+  struct Sample {
+    uint64_t mem{0};            ///< Resident memory in kB
+    double pcpu{0.};            ///< CPU usage in %
+    unsigned int nFDs{0};       ///< Number of open file descriptors
+    unsigned int nThreads{0};   ///< Number of threads
+  };
+
+  /**
+   * Pass the statistics of the current trigger.
+   * \return The escalation step reached with this sample. Each step is returned only once, all following samples
+   * return Action::None until the next step is reached or the limiter is reset.
+   */
+  Action update(const Sample& sample, const Limits& limits);
+
+  /**
+   * Reset the limiter, e.g. after a (re)start of the process.
+   */
+  void reset();
+
+  /**
+   * \return The highest escalation step reached since the limits are exceeded. Action::None if all limits are
+   * respected.
+   */
+  Action getLevel() const { return _level; }
+
+  /**
+   * \return Description of the limits exceeded by the last sample, e.g. "mem: 2048kB > 1024kB". Empty if no limit
+   * is exceeded.
+   */
+  const std::string& getBreach() const { return _breach; }
+
+ private:
+  std::vector<double> _cpuHistory; ///< Ring buffer with the CPU usage of the last cpuWindow triggers
+  size_t _cpuPos{0};               ///< Next position to be written in _cpuHistory
+  size_t _cpuEntries{0};           ///< Number of valid entries in _cpuHistory
+  unsigned int _breachTicks{0};    ///< Number of consecutive triggers with exceeded limits
+  Action _level{Action::None};     ///< Highest escalation step reached
+  std::string _breach;             ///< Description of the exceeded limits
+};
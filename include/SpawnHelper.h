@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * SpawnHelper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "ExecSpec.h"
+#include "Logging.h"
+
+#include <sys/types.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace spawn {
+
+  /**
+   * Everything needed to start a process.
+   * See ProcessHandler::startProcess for a description of the parameters.
+   */
+  struct Request {
+    std::shared_ptr<const ExecSpec> exec; ///< Prepared command, working directory and environment
+    std::string logfile;
+    std::string pidFile; ///< The child writes its PID to this file
+    std::string name;    ///< Name prepended to the messages written by the child
+    logging::LogLevel logLevel{logging::LogLevel::DEBUG};
+    bool captureOutput{false}; ///< Connect stdout/stderr to a pipe instead of the logfile
+    int outputFD{-1};          ///< Write end of the output pipe, set by the forking process (not transferred)
+  };
+
+  /**
+   * Prepare the child process and replace it by the requested command.
+   * This is called in the child after fork. It redirects stdout/stderr to the logfile, sets the process group,
+   * writes the PID file, changes the working directory and calls execve with the prepared argv and envp arrays.
+   * If Request::outputFD is set stdout/stderr are connected to it instead of the logfile.
+   * \param request The process to be started.
+   * \param errorFD If not -1 a message is written to this file descriptor in case the process could not be started.
+   * Use a pipe with O_CLOEXEC to find out in the parent if execve succeeded.
+   */
+  [[noreturn]] void execChild(const Request& request, int errorFD = -1);
+
+  /**
+   * \return Human readable description of a status returned by waitpid, e.g. "exit code 1" or "signal 9".
+   */
+  std::string describeExitStatus(int status);
+
+  /**
+   * \brief Small helper process used to start processes on behalf of the watchdog.
+   *
+   * Forking the watchdog means copying the page tables of a large, multi-threaded process and running code in the
+   * child that is not async-signal-safe before execve is called. Therefore the helper is forked once during start-up,
+   * while the watchdog is still single-threaded. The ProcessHandler sends spawn requests to the helper via a Unix
+   * socket. The helper forks, prepares the child (see execChild) and sends back the PID once execve succeeded.
+   * The helper also reaps its children and sends their exit status to the watchdog.
+   *
+   * If the helper is not started (e.g. in tests or if it is disabled) the ProcessHandler forks the process itself. If
+   * the helper died no processes are started any more, since forking the watchdog is not safe once threads run.
+   */
+  class SpawnHelper {
+   public:
+    /**
+     * Fork the helper process. Call this as early as possible, before any thread is started.
+     * Calling it again if the helper is running does nothing.
+     * \return True if the helper is running.
+     */
+    static bool start();
+
+    /**
+     * \return True if the helper is running and can be used to spawn processes.
+     */
+    static bool isRunning();
+
+    /**
+     * \return True if the helper was started successfully, even if it is not running any more.
+     */
+    static bool wasStarted();
+
+    /**
+     * Start a process using the helper.
+     * \param request The process to be started.
+     * \param error Reason why the process could not be started.
+     * \param outputFD Set to the read end of the output pipe if Request::captureOutput is set, else -1. The caller
+     * takes ownership of the file descriptor.
+     * \param spawnID Set to the number of this spawn, which is used to get the exit status of the process. Unlike
+     * the PID it is never reused.
+     * \return PID of the started process or -1 in case of an error. If the helper itself failed isRunning() returns
+     * false afterwards.
+     *
+     * The lock is not held while waiting for the reply, so other threads can use the helper in the meantime.
+     */
+    static pid_t spawn(
+        const Request& request, std::string& error, int* outputFD = nullptr, uint64_t* spawnID = nullptr);
+
+    /**
+     * Get the exit status of a process started by the helper. The stored status is removed afterwards.
+     * \param spawnID Number of the spawn as returned by spawn().
+     * \param status The status as returned by waitpid.
+     * \return False if the helper did not report the exit of the process (yet).
+     */
+    static bool getExitStatus(uint64_t spawnID, int& status);
+
+    /**
+     * Forget a process started by the helper, e.g. because it is not controlled any more. Its exit status is dropped
+     * if it was already reported and ignored if it is reported later.
+     * \param spawnID Number of the spawn as returned by spawn().
+     */
+    static void forget(uint64_t spawnID);
+
+   private:
+    static SpawnHelper& instance();
+
+    /**
+     * Reply of the helper to a spawn request.
+     */
+    struct Reply {
+      pid_t pid{-1};       ///< PID of the started process, -1 in case of an error
+      uint64_t spawnID{0}; ///< Spawn ID assigned to the process
+      std::string error;   ///< Reason why the process could not be started
+      int outputFD{-1};    ///< Read end of the output pipe, -1 if the output is not captured
+    };
+
+    /**
+     * Read a single message sent by the helper. Exit notifications of known children are stored in _exitStatus,
+     * replies to spawn requests in _replies. The lock is released while waiting for the message.
+     * \param lock Lock of _mutex, it is held when the function is called and when it returns.
+     * \param blocking If true wait for the next message.
+     * \return True if a message was received.
+     */
+    bool receive(std::unique_lock<std::mutex>& lock, bool blocking);
+
+    /** Close the connection to the helper after a communication error. */
+    void disconnect();
+
+    std::mutex _mutex;                   ///< Protects all other members
+    std::condition_variable _received;   ///< Notified when a thread stopped receiving
+    int _socket{-1};                     ///< Socket connected to the helper
+    bool _started{false};                ///< The helper was started, processes are not forked by the ProcessHandler
+    bool _receiving{false};              ///< A thread is receiving from the socket without holding the lock
+    uint32_t _nRequests{0};              ///< Number of spawn requests, used as request ID
+    uint64_t _nSpawns{0};                ///< Number of successful spawns, used as spawn ID
+    std::map<int32_t, Reply> _replies;   ///< Replies not yet collected per request ID
+    std::map<pid_t, uint64_t> _children; ///< Spawn ID of running children per PID
+    std::map<uint64_t, int> _exitStatus; ///< Exit status of terminated children per spawn ID
+  };
+} // namespace spawn
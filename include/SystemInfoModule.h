@@ -9,11 +9,20 @@
  *      Author: Klaus Zenker (HZDR)
  */
 
+#include "CpuLoad.h"
+#include "CpuTopology.h"
+#include "DiskStats.h"
+#include "NetStats.h"
+#include "NumaMemory.h"
+#include "Pressure.h"
+#include "SystemSnapshot.h"
 #include "sys_stat.h"
 
 #include <ChimeraTK/ApplicationCore/ApplicationCore.h>
 #include <ChimeraTK/ApplicationCore/Logging.h>
 
+#include <chrono>
+#include <memory>
 #include <unordered_set>
 
 namespace ctk = ChimeraTK;
@@ -31,40 +40,67 @@ class SystemInfoModule : public ctk::ApplicationModule {
   SysInfo sysInfo;
 
   /**
-   * CPU usage parameters needed to calculate the cpu usage.
-   * These vales are read from \c /proc/stat
+   * Reads \c /proc/stat, \c /proc/meminfo, \c /proc/vmstat, \c /proc/loadavg and \c /proc/uptime using persistent
+   * file descriptors.
    */
-  struct cpu {
-    unsigned long long totalUser{0};
-    unsigned long long totalUserLow{0};
-    unsigned long long totalSys{0};
-    unsigned long long totalIdle{0};
-    cpu(unsigned long long totUser = 0, unsigned long long totUserLow = 0, unsigned long long TotSys = 0,
-        unsigned long long TotIdle = 0)
-    : totalUser(totUser), totalUserLow(totUserLow), totalSys(TotSys), totalIdle(TotIdle) {}
-  };
-#ifdef WITH_PROCPS
+  SystemSnapshot _snapshot;
+
+  /**
+   * Virtual memory counters of the last update and its time, used to calculate the rates.
+   */
+  SystemSnapshot::Vmstat _lastVmstat;
+  std::chrono::steady_clock::time_point _lastVmstatUpdate;
+
+  /**
+   * Calculates the CPU usage and the share of the CPU states from the ticks read by the snapshot.
+   */
+  CpuLoad _cpuLoad;
+
+  /**
+   * Assignment of the CPUs to sockets, NUMA nodes and core types, read once on construction.
+   */
+  CpuTopology _topology;
+
   /**
-   * CPU usage parameters (see cpu) for the total system and the individual cores.
-   * Therefore, the size of this vector is nCores + 1
+   * Buffers reused to publish the CPU usage of the topology groups.
    */
-  std::vector<cpu> lastInfo;
+  std::array<std::vector<double>, CpuTopology::N_LEVELS> _groupUsage;
 
   /**
-   * Read values from the \c /proc/stat for all cpu cores (cpux) and overall values (cpu).
+   * Reads the memory statistics of the NUMA nodes.
    */
-  void readCPUInfo(std::vector<cpu>& vcpu);
-#else
-  struct stat_info* infoptr{nullptr};
-#endif
+  NumaMemory _numa;
 
   /**
-   * Calculates the percentage of cpu usage.
-   * This is done in total and for core found on the system.
+   * Allocation counters of the last update and its time, used to calculate the allocation rates of the NUMA nodes.
+   */
+  std::vector<NumaMemory::Node> _lastNodes;
+  std::chrono::steady_clock::time_point _lastNumaUpdate;
+
+  /**
+   * Buffers reused to publish the NUMA node statistics.
+   */
+  std::vector<uint64_t> _nodeTotal, _nodeFree, _nodeUsed;
+  std::vector<double> _nodeMiss, _nodeForeign, _nodeOther, _nodeRemote;
+
+  /**
+   * Buffer reused to publish the load average.
+   */
+  std::vector<double> _loadAvg = std::vector<double>(3);
+
+  /**
+   * Publishes the percentage of cpu usage and of the individual CPU states (iowait, irq, softirq, steal, guest)
+   * calculated by _cpuLoad from the ticks read by the last update of the snapshot.
+   * This is done in total, for core found on the system and for each socket, NUMA node and core type.
    * If cpu usage is set to -1 there was an overflow in the \c /proc/stat file.
    */
   void calculatePCPU();
 
+  /**
+   * Publish the memory of the NUMA nodes and the rates of the allocation counters since the last update.
+   */
+  void updateNuma();
+
  public:
   SystemInfoModule(ctk::ModuleGroup* owner, const std::string& name, const std::string& description,
       const std::unordered_set<std::string>& tags = {}, const std::string& pathToTrigger = "/Trigger/tick");
@@ -81,6 +117,13 @@ class SystemInfoModule : public ctk::ApplicationModule {
     ctk::ScalarOutput<uint> ticksPerSecond{this, "ticksPerSecond", "Hz", "Number of clock ticks per second",
         {"ProcessModuleInput"}}; ///< Number of clock ticks per second
     ctk::ScalarOutput<uint> nCPU{this, "nCPU", "", "Number of CPUs"};
+    /**
+     * \name Names of the sockets, NUMA nodes and core types used by the aggregated CPU usage
+     * @{
+     */
+    std::unique_ptr<ctk::ArrayOutput<std::string>> cpuSockets, cpuNodes, cpuCoreTypes;
+    /** @} */
+    std::unique_ptr<ctk::ArrayOutput<std::string>> numaNodes; ///< IDs of the NUMA nodes used in numa
   } info{this, "info", "Static system information"};
   /** @} */
   /**
@@ -100,6 +143,29 @@ class SystemInfoModule : public ctk::ApplicationModule {
     ctk::ScalarOutput<uint64_t> usedSwap{this, "usedSwap", "kB", "Used swap", {"DAQ", "history"}};
     ctk::ScalarOutput<double> memoryUsage{this, "memoryUsage", "%", "Relative memory usage", {"DAQ", "history"}};
     ctk::ScalarOutput<double> swapUsage{this, "swapUsage", "%", "Relative swap usage", {"DAQ", "history"}};
+    ctk::ScalarOutput<uint64_t> availableMem{
+        this, "availableMem", "kB", "Memory available for new processes without swapping", {"DAQ", "history"}};
+    ctk::ScalarOutput<uint64_t> dirtyMem{
+        this, "dirtyMem", "kB", "Memory waiting to be written back to disk", {"DAQ", "history"}};
+    ctk::ScalarOutput<uint64_t> writebackMem{
+        this, "writebackMem", "kB", "Memory actively being written back to disk", {"DAQ", "history"}};
+    ctk::ScalarOutput<uint64_t> slabMem{this, "slabMem", "kB", "Memory used by the kernel slab allocator", {"DAQ"}};
+    ctk::ScalarOutput<uint64_t> hugePagesTotal{this, "hugePagesTotal", "", "Number of huge pages"};
+    ctk::ScalarOutput<uint64_t> hugePagesFree{this, "hugePagesFree", "", "Number of free huge pages", {"DAQ"}};
+    ctk::ScalarOutput<uint64_t> hugePageSize{this, "hugePageSize", "kB", "Size of a huge page"};
+    /**
+     * \name Rates of virtual memory events that cause latency spikes (see \c /proc/vmstat)
+     * @{
+     */
+    ctk::ScalarOutput<double> majorFaults{
+        this, "majorFaults", "1/s", "Page faults that required reading from disk", {"DAQ", "history"}};
+    ctk::ScalarOutput<double> swapIn{this, "swapIn", "1/s", "Pages swapped in", {"DAQ", "history"}};
+    ctk::ScalarOutput<double> swapOut{this, "swapOut", "1/s", "Pages swapped out", {"DAQ", "history"}};
+    ctk::ScalarOutput<double> allocStalls{
+        this, "allocStalls", "1/s", "Allocations stalled by direct memory reclaim", {"DAQ", "history"}};
+    ctk::ScalarOutput<double> compactStalls{
+        this, "compactStalls", "1/s", "Allocations stalled by direct memory compaction", {"DAQ", "history"}};
+    /** @} */
     //\todo: Implement the following as long!
     ctk::ScalarOutput<uint64_t> startTime{
         this, "startTime", "s", "start time of system with respect to EPOCH", {"ProcessModuleInput"}};
@@ -112,9 +178,51 @@ class SystemInfoModule : public ctk::ApplicationModule {
     ctk::ScalarOutput<uint> uptime_sec{this, "uptimeSec", "s", "Seconds up"};
     std::unique_ptr<ctk::ArrayOutput<double>> cpu_use;
     ctk::ScalarOutput<double> cpu_useTotal{this, "cpuTotal", "%", "Total CPU usage", {"DAQ", "history"}};
+    /**
+     * \name Share of the time spend in individual CPU states for each processor and in total
+     * Guest time is included in the user time and thus in the CPU usage, iowait is not.
+     * @{
+     */
+    std::unique_ptr<ctk::ArrayOutput<double>> cpuIowait, cpuIrq, cpuSoftirq, cpuSteal, cpuGuest;
+    ctk::ScalarOutput<double> cpuIowaitTotal{
+        this, "cpuIowaitTotal", "%", "Total time idle while waiting for I/O", {"DAQ", "history"}};
+    ctk::ScalarOutput<double> cpuIrqTotal{
+        this, "cpuIrqTotal", "%", "Total time servicing interrupts", {"DAQ", "history"}};
+    ctk::ScalarOutput<double> cpuSoftirqTotal{
+        this, "cpuSoftirqTotal", "%", "Total time servicing soft interrupts", {"DAQ", "history"}};
+    ctk::ScalarOutput<double> cpuStealTotal{
+        this, "cpuStealTotal", "%", "Total time stolen by the hypervisor", {"DAQ", "history"}};
+    ctk::ScalarOutput<double> cpuGuestTotal{
+        this, "cpuGuestTotal", "%", "Total time running virtual CPUs of guests", {"DAQ", "history"}};
+    /** @} */
+    /**
+     * \name CPU usage aggregated per socket, NUMA node and core type (see info for the names)
+     * An imbalanced group is visible here even if the total CPU usage is low.
+     * @{
+     */
+    std::unique_ptr<ctk::ArrayOutput<double>> cpuSocket, cpuNode, cpuCoreType;
+    /** @} */
     ctk::ArrayOutput<double> loadAvg{
         this, "loadAvg", "", 3, "Average load within last min, 5min, 15min", {"DAQ", "history"}};
   } status{this, "status", "status of the system"};
+
+  /**
+   * Memory statistics of each NUMA node, see info.numaNodes for the node IDs. The variables are only created on
+   * systems supporting NUMA.
+   */
+  struct Numa : public ctk::VariableGroup {
+    using ctk::VariableGroup::VariableGroup;
+    std::unique_ptr<ctk::ArrayOutput<uint64_t>> memTotal, memFree, memUsed;
+    /**
+     * \name Allocation rates in pages per second
+     * Allocations a process did not get on its own node show up as miss on the node used and as foreign on the node
+     * intended. High rates mean memory is accessed across nodes, which reduces the throughput.
+     * @{
+     */
+    std::unique_ptr<ctk::ArrayOutput<double>> numaMiss, numaForeign, otherNode;
+    /** @} */
+    std::unique_ptr<ctk::ArrayOutput<double>> remoteShare; ///< Share of allocations by processes on other nodes
+  } numa{this, "numa", "Memory statistics of the NUMA nodes"};
   /** @} */
 
   /**
@@ -131,6 +239,220 @@ class SystemInfoModule : public ctk::ApplicationModule {
   void mainLoop() override;
 };
 
+/**
+ * \brief Module reading throughput, latency and utilisation of all block devices from \c /proc/diskstats.
+ *
+ * In contrast to the NetworkModule a single module handles all devices, so \c /proc/diskstats is read only once per
+ * trigger. The results are published in arrays, the device of each element is given by status/devices. The arrays
+ * have one element per device found on construction and nSpareSlots additional elements for devices that are plugged
+ * in later. The element of a removed device is set to 0 and its name is cleared.
+ * The "SYS" tag is used for all variables that are updated in the main loop.
+ */
+struct DiskStatsModule : public ctk::ApplicationModule {
+  /**
+   * \param nSpareSlots Number of additional array elements for devices plugged in after the start.
+   */
+  DiskStatsModule(ctk::ModuleGroup* owner, const std::string& name, const std::string& description,
+      size_t nSpareSlots = 4, const std::unordered_set<std::string>& tags = {},
+      const std::string& pathToTrigger = "/Trigger/tick");
+
+  struct Status : public ctk::VariableGroup {
+    using ctk::VariableGroup::VariableGroup;
+    std::unique_ptr<ctk::ArrayOutput<std::string>> devices;
+    std::unique_ptr<ctk::ArrayOutput<double>> readIOPS, writeIOPS, readThroughput, writeThroughput, readLatency,
+        writeLatency, queueDepth, inFlight, utilisation;
+    ctk::ScalarOutput<uint> nDevices{this, "nDevices", "", "Number of devices currently present"};
+    ctk::ScalarOutput<uint> nDropped{
+        this, "nDropped", "", "Number of devices not published since all array elements are used", {"DAQ"}};
+  } status{this, "status", "Statistics of the block devices"};
+
+  ctk::ScalarPushInput<uint64_t> trigger;
+
+  /**
+   * \name Logging
+   * @{
+   */
+  boost::shared_ptr<logging::Logger> logger{new logging::Logger(this, "logging")};
+  /** @} */
+
+  /**
+   * Main loop function.
+   */
+  void mainLoop() override;
+
+ private:
+  DiskStats _stats;                         ///< Reads /proc/diskstats
+  std::vector<std::string> _devices;        ///< Devices published, used to log added and removed devices
+  std::vector<std::vector<double>> _values; ///< Buffers reused to publish the results
+
+  /**
+   * Publish the device names and log added and removed devices.
+   */
+  void updateDevices();
+};
+
+/**
+ * \brief Module reading the pressure stall information (PSI) of cpu, memory and io.
+ *
+ * The pressure is published system wide and for the cgroup (v2) of the watchdog, which includes all processes started
+ * by the watchdog unless they are moved to another cgroup. The cgroup variables are 0 if no cgroup is found.
+ *
+ * The module publishes the pressure on every trigger and on every PSI event reported by PressureTriggerModule, which
+ * it reads from \c pathToEvents. Use PressureGroup to get both modules connected.
+ *
+ * A stall is logged once when it starts and once when no PSI event was seen for two trigger windows, so a continuous
+ * stall does not flood the log.
+ */
+struct PressureModule : public ctk::ApplicationModule {
+  /**
+   * \param pathToEvents PSI events published by PressureTriggerModule.
+   */
+  PressureModule(ctk::ModuleGroup* owner, const std::string& name, const std::string& description,
+      const std::string& pathToEvents, const std::unordered_set<std::string>& tags = {},
+      const std::string& pathToTrigger = "/Trigger/tick");
+
+  /**
+   * Pressure of a single line of a PSI file.
+   */
+  struct StallGroup : public ctk::VariableGroup {
+    using ctk::VariableGroup::VariableGroup;
+    ctk::ScalarOutput<double> avg10{
+        this, "avg10", "%", "Share of time stalled within the last 10 s", {"DAQ", "history"}};
+    ctk::ScalarOutput<double> avg60{this, "avg60", "%", "Share of time stalled within the last 60 s", {"DAQ"}};
+    ctk::ScalarOutput<uint64_t> totalDelta{
+        this, "totalDelta", "us", "Time stalled since the last update", {"DAQ", "history"}};
+  };
+
+  /**
+   * Pressure of a single resource.
+   */
+  struct ResourceGroup : public ctk::VariableGroup {
+    using ctk::VariableGroup::VariableGroup;
+    StallGroup some{this, "some", "At least one task stalled"};
+    StallGroup full{this, "full", "All non-idle tasks stalled at the same time"};
+  };
+
+  /**
+   * Pressure of all resources read from the same source.
+   */
+  struct SourceGroup : public ctk::VariableGroup {
+    using ctk::VariableGroup::VariableGroup;
+    ResourceGroup cpu{this, "cpu", "CPU pressure"};
+    ResourceGroup memory{this, "memory", "Memory pressure"};
+    ResourceGroup io{this, "io", "IO pressure"};
+  };
+
+  SourceGroup system{this, "system", "System wide pressure"};
+  SourceGroup cgroup{this, "cgroup", "Pressure of the cgroup of the watchdog"};
+
+  struct Status : public ctk::VariableGroup {
+    using ctk::VariableGroup::VariableGroup;
+    ctk::ScalarOutput<std::string> cgroupPath{
+        this, "cgroupPath", "", "Directory of the cgroup, empty if no cgroup providing pressure files is found"};
+    ctk::ScalarOutput<uint64_t> triggerEvents{
+        this, "triggerEvents", "", "Number of PSI trigger events since the start", {"DAQ", "history"}};
+  } status{this, "status", "Status of the pressure module"};
+
+  ctk::ScalarPushInput<uint64_t> trigger;
+  ctk::ScalarPushInput<uint> psiEvents;
+
+  /**
+   * \name Logging
+   * @{
+   */
+  boost::shared_ptr<logging::Logger> logger{new logging::Logger(this, "logging")};
+  /** @} */
+
+  /**
+   * Main loop function.
+   */
+  void mainLoop() override;
+
+ private:
+  /**
+   * Read the pressure of a source and publish it.
+   * \param last Total stall times of the last update, used to calculate totalDelta.
+   */
+  void publish(Pressure& pressure, SourceGroup& group, std::array<Pressure::Values, Pressure::N_RESOURCES>& last);
+
+  /**
+   * Log the start and the end of stalls.
+   * \param fired Bit mask of the resources whose PSI trigger fired, 0 if none fired.
+   */
+  void logStalls(unsigned int fired);
+
+  std::string _cgroupPath;                                                      ///< Directory of the cgroup
+  Pressure _system;                                                             ///< System wide pressure files
+  Pressure _cgroup;                                                             ///< Pressure files of the cgroup
+  std::array<Pressure::Values, Pressure::N_RESOURCES> _lastSystem, _lastCgroup; ///< Pressure of the last update
+
+  unsigned int _stalled{0}; ///< Bit mask of the stalled resources
+  /** Time of the last PSI event of each resource */
+  std::array<std::chrono::steady_clock::time_point, Pressure::N_RESOURCES> _lastEvent;
+};
+
+/**
+ * \brief Module waiting for the PSI triggers of the system wide pressure.
+ *
+ * A trigger fires if tasks stalled for more than triggerThreshold within triggerWindow. The module blocks until one
+ * of the triggers fires and publishes the fired resources in \c events, so PressureModule can wait for its trigger
+ * and PSI events at the same time. If the kernel does not accept the PSI triggers, e.g. because CAP_SYS_RESOURCE is
+ * missing on kernels older than 6.4, no events are published. Without that capability the window has to be a
+ * multiple of 2 s.
+ */
+struct PressureTriggerModule : public ctk::ApplicationModule {
+  /**
+   * \param enableTriggers Register the PSI triggers. If false, no events are published.
+   */
+  PressureTriggerModule(ctk::ModuleGroup* owner, const std::string& name, const std::string& description,
+      bool enableTriggers = true, const std::unordered_set<std::string>& tags = {});
+
+  static constexpr uint64_t triggerThreshold = 200000; ///< Stall time in us that fires a PSI trigger
+  static constexpr uint64_t triggerWindow = 2000000;   ///< Time window of the PSI triggers in us
+
+  ctk::ScalarOutput<uint> events{
+      this, "events", "", "Bit mask of the resources whose PSI triggers fired (1: cpu, 2: memory, 4: io)"};
+  ctk::ScalarOutput<uint> nTriggers{this, "nTriggers", "", "Number of registered PSI triggers"};
+
+  /**
+   * \name Logging
+   * @{
+   */
+  boost::shared_ptr<logging::Logger> logger{new logging::Logger(this, "logging")};
+  /** @} */
+
+  /**
+   * Main loop function.
+   */
+  void mainLoop() override;
+
+  /**
+   * Wake up the main loop blocked in waiting for the PSI triggers, so the module can be stopped.
+   */
+  void terminate() override;
+
+ private:
+  bool _enableTriggers; ///< Register PSI triggers
+  Pressure _triggers;   ///< System wide pressure files the triggers are registered on
+};
+
+/**
+ * \brief Pressure stall information published by PressureModule, with PSI events reported by PressureTriggerModule.
+ *
+ * The PressureModule is merged into the group, the PressureTriggerModule is placed in \c triggers.
+ */
+struct PressureGroup : public ctk::ModuleGroup {
+  /**
+   * \param enableTriggers Register PSI triggers to publish the pressure as soon as tasks stall.
+   */
+  PressureGroup(ctk::ModuleGroup* owner, const std::string& name, const std::string& description,
+      bool enableTriggers = true, const std::unordered_set<std::string>& tags = {},
+      const std::string& pathToTrigger = "/Trigger/tick");
+
+  PressureTriggerModule triggers;
+  PressureModule pressure;
+};
+
 /*
  * Return the current time in a formatted way:
  * WATCHDOG_SERVER: 2018-Oct-25 11:22:29.411611  -> "module name" ->
@@ -231,18 +553,22 @@ struct FileSystemGroup : public ctk::ModuleGroup {
  * - received data (byte, packates)
  * - transmitted data (byte, packates)
  * - dropped data (transmitted and received)
- * - collisions
- *
+ * - errors, fifo errors and collisions
+ * - receiver overruns and missed packets (only if the counters are read using RTNETLINK, see NetStats)
+ * - received multicast packets
  *
- * Hard disk devices are mounted at a certain location. The statfs that is used
- * internally to read information needs the mount point and not the device itself.
- * E.g. /dev/sdb1 mounted at /media/data -> statfs works on /media/data.
- * Therefore the module might be used multiple times for different mount point to
- * be monitored.
+ * The counters are taken from a NetStats object shared by all NetworkModules of the NetworkGroup, so the counters of
+ * all devices are read only once per trigger. Each module monitors the device assigned to its slot of the NetStats.
+ * Devices that appear, disappear or are renamed at runtime change the assignment, in that case \c deviceName is
+ * updated. Free slots publish an empty device name and rates of 0.
  * The "SYS" tag is used for all variables that are updated in the main loop.
  */
 struct NetworkModule : public ctk::ApplicationModule {
-  NetworkModule(const std::string& device, ctk::ModuleGroup* owner, const std::string& name,
+  /**
+   * \param slot Slot of the NetStats monitored by this module.
+   * \param stats Counters shared by all NetworkModules.
+   */
+  NetworkModule(size_t slot, std::shared_ptr<NetStats> stats, ctk::ModuleGroup* owner, const std::string& name,
       const std::string& description, const std::unordered_set<std::string>& tags = {},
       const std::string& pathToTrigger = "/Trigger/tick");
 
@@ -266,26 +592,10 @@ struct NetworkModule : public ctk::ApplicationModule {
 
   const double MiB = 1. / 1024 / 1024; ///< Conversion to MiB (not to be mixed up with MB!)
 
-  struct raw {
-    std::vector<unsigned long long> data;       ///< Used to store raw data read from sys files
-    std::vector<std::string> files;             ///< Names of the sys files used to get networking information
-    std::vector<boost::posix_time::ptime> time; ///< Safe individual time stamps of reading a certain sys file
-    raw(const std::string& device) {
-      data = std::vector<unsigned long long>(7);
-      std::string src_base("/sys/class/net/");
-      files.push_back(src_base + device + "/statistics/rx_packets");
-      files.push_back(src_base + device + "/statistics/tx_packets");
-      files.push_back(src_base + device + "/statistics/rx_bytes");
-      files.push_back(src_base + device + "/statistics/tx_bytes");
-      files.push_back(src_base + device + "/statistics/rx_dropped");
-      files.push_back(src_base + device + "/statistics/tx_dropped");
-      files.push_back(src_base + device + "/statistics/collisions");
-      time = std::vector<boost::posix_time::ptime>(7);
-    }
-    raw() = default;
-  };
-
-  raw previousData; ///< Last data collected
+  size_t _slot;                     ///< Slot of the NetStats monitored by this module
+  std::shared_ptr<NetStats> _stats; ///< Counters shared by all NetworkModules
+  NetStats::Sample _last;           ///< Counters of the last update
+  bool _hasLast{false};             ///< True if _last is valid
 
   /**
    * \name Logging
@@ -306,11 +616,22 @@ struct NetworkModule : public ctk::ApplicationModule {
 };
 
 /**
- * \brief This group includes one NetworkModule per network device.
+ * \brief This group includes one NetworkModule per slot of the shared NetStats, i.e. one per network device found on
+ * start and additional modules for devices plugged in later.
  */
 struct NetworkGroup : public ctk::ModuleGroup {
   using ctk::ModuleGroup::ModuleGroup;
 
+  /**
+   * Counters of all network devices, shared by the modules.
+   */
+  std::shared_ptr<NetStats> stats{std::make_shared<NetStats>()};
+
+  /**
+   * Number of modules in addition to the devices found on start, used for devices plugged in later.
+   */
+  static constexpr size_t nSpareMonitors = 4;
+
   /**
    * Modules monitoring disks usage of system drives.
    */
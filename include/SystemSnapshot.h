@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * SystemSnapshot.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * \brief Reads the system metrics of a single trigger from \c /proc.
+ *
+ * The files \c stat, \c meminfo, \c vmstat, \c loadavg and \c uptime are kept open. An update reads each of them
+ * using a single pread into a buffer that is reused, and parses the data in place without creating strings. Thus,
+ * after the first update all metrics are collected using five system calls and without allocating memory.
+ *
+ * The directory is configurable, so recorded files can be used for testing.
+ */
+class SystemSnapshot {
+ public:
+  /**
+   * Time spend by a CPU in the different states, given in clock ticks (see \c /proc/stat).
+   */
+  struct Cpu {
+    uint64_t user{0};      ///< Normal processes in user mode, including guest
+    uint64_t nice{0};      ///< Niced processes in user mode, including guest_nice
+    uint64_t system{0};    ///< Processes in kernel mode
+    uint64_t idle{0};      ///< Idle
+    uint64_t iowait{0};    ///< Idle while waiting for I/O
+    uint64_t irq{0};       ///< Servicing interrupts
+    uint64_t softirq{0};   ///< Servicing soft interrupts
+    uint64_t steal{0};     ///< Stolen by the hypervisor
+    uint64_t guest{0};     ///< Running a virtual CPU of a guest
+    uint64_t guestNice{0}; ///< Running a niced virtual CPU of a guest
+
+    /** \return Ticks spend busy, i.e. not idle and not waiting for I/O. */
+    uint64_t busy() const { return user + nice + system + irq + softirq + steal; }
+    /** \return All ticks, guest time is already included in user and nice. */
+    uint64_t total() const { return busy() + idle + iowait; }
+  };
+
+  /**
+   * Ticks of the individual CPUs stored as structure of arrays, so a field of all CPUs can be processed in a single
+   * loop. The index is the CPU number, see Cpu for the fields.
+   */
+  struct CpuArray {
+    std::vector<uint64_t> user, nice, system, idle, iowait, irq, softirq, steal, guest, guestNice;
+
+    /** \return Number of CPUs. */
+    size_t size() const { return user.size(); }
+    /** Change the number of CPUs, new CPUs are 0. */
+    void resize(size_t n);
+    /** Set all ticks to 0 without changing the number of CPUs. */
+    void clear();
+    /** \return The ticks of a single CPU. */
+    Cpu get(size_t index) const;
+  };
+
+  /**
+   * Memory information given in kB, except for the number of huge pages (see \c /proc/meminfo).
+   */
+  struct Memory {
+    uint64_t total{0};          ///< MemTotal
+    uint64_t free{0};           ///< MemFree
+    uint64_t available{0};      ///< MemAvailable
+    uint64_t buffers{0};        ///< Buffers
+    uint64_t cached{0};         ///< Cached
+    uint64_t sReclaimable{0};   ///< SReclaimable
+    uint64_t shmem{0};          ///< Shmem
+    uint64_t swapTotal{0};      ///< SwapTotal
+    uint64_t swapFree{0};       ///< SwapFree
+    uint64_t dirty{0};          ///< Dirty, waiting to be written back
+    uint64_t writeback{0};      ///< Writeback, actively being written back
+    uint64_t slab{0};           ///< Slab, kernel data structures
+    uint64_t hugePagesTotal{0}; ///< HugePages_Total
+    uint64_t hugePagesFree{0};  ///< HugePages_Free
+    uint64_t hugePageSize{0};   ///< Hugepagesize
+  };
+
+  /**
+   * Event counters since boot (see \c /proc/vmstat).
+   */
+  struct Vmstat {
+    uint64_t majorFaults{0};   ///< pgmajfault, page faults that required reading from disk
+    uint64_t swapIn{0};        ///< pswpin, pages swapped in
+    uint64_t swapOut{0};       ///< pswpout, pages swapped out
+    uint64_t allocStalls{0};   ///< Sum of all allocstall* counters, direct reclaims by allocating processes
+    uint64_t compactStalls{0}; ///< compact_stall, direct compactions by allocating processes
+  };
+
+  /**
+   * Open the files.
+   * \param procPath Directory containing the files.
+   */
+  explicit SystemSnapshot(const std::string& procPath = "/proc");
+  ~SystemSnapshot();
+  SystemSnapshot(const SystemSnapshot&) = delete;
+  SystemSnapshot& operator=(const SystemSnapshot&) = delete;
+  /** Move the opened files, so modules owning a SystemSnapshot stay movable like all ApplicationModules. */
+  SystemSnapshot(SystemSnapshot&& other) noexcept;
+  SystemSnapshot& operator=(SystemSnapshot&& other) noexcept;
+
+  /**
+   * Read and parse all files. Values of files that could not be read or parsed are kept.
+   * \return False if a file could not be read or parsed. Use getError() to get the reason.
+   */
+  bool update();
+
+  /** \return Summary of all CPUs. */
+  const Cpu& getTotal() const { return _total; }
+
+  /** \return Individual CPUs, the index is the CPU number. CPUs not found in \c /proc/stat are 0. */
+  const CpuArray& getCpus() const { return _cpus; }
+
+  /** \return Memory information. */
+  const Memory& getMemory() const { return _memory; }
+
+  /** \return Event counters of the virtual memory. */
+  const Vmstat& getVmstat() const { return _vmstat; }
+
+  /** \return Load average of the last 1, 5 and 15 minutes. */
+  const std::array<double, 3>& getLoadAvg() const { return _loadAvg; }
+
+  /** \return Uptime of the system in seconds. */
+  double getUptime() const { return _uptime; }
+
+  /** \return Boot time of the system in seconds since EPOCH. */
+  uint64_t getBootTime() const { return _bootTime; }
+
+  /** \return The reason of the last failed update. */
+  const std::string& getError() const { return _error; }
+
+ private:
+  /** Index of the files in _fds */
+  enum File { STAT, MEMINFO, VMSTAT, LOADAVG, UPTIME, N_FILES };
+
+  /**
+   * Read the complete file into _buffer using procfs::readFile. The buffer is enlarged if the file does not fit.
+   * \return The data or an empty view if the file could not be read.
+   */
+  std::string_view read(File file);
+
+  bool parseStat(std::string_view data);
+  bool parseMeminfo(std::string_view data);
+  bool parseVmstat(std::string_view data);
+  bool parseLoadavg(std::string_view data);
+  bool parseUptime(std::string_view data);
+
+  /** Set _error and return false. */
+  bool fail(File file, const char* reason);
+
+  /** Close all files. */
+  void close();
+
+  std::string _procPath;          ///< Directory containing the files
+  std::array<int, N_FILES> _fds;  ///< Opened files, -1 if a file could not be opened
+  std::string _buffer;            ///< Buffer reused for reading the files
+  Cpu _total;                     ///< Summary of all CPUs
+  CpuArray _cpus;                 ///< Individual CPUs
+  Memory _memory;                 ///< Memory information
+  Vmstat _vmstat;                 ///< Virtual memory event counters
+  std::array<double, 3> _loadAvg; ///< Load average
+  double _uptime{0};              ///< Uptime in seconds
+  uint64_t _bootTime{0};          ///< Boot time in seconds since EPOCH
+  std::string _error;             ///< Reason of the last failed update
+};
@@ -62,12 +62,21 @@ struct WatchdogServer : public ctk::Application {
 
   SystemInfoModule info{this, "system", "Module reading system information"};
 
+  /**
+   * PSI triggers are used unless disabled in the config file:
+   * <variable name="enablePressureTriggers" type="uint32" value="0" />
+   */
+  PressureGroup pressure{this, "pressure", "Module reading the pressure stall information",
+      config.get<uint>("Configuration/enablePressureTriggers", (uint)1) != 0};
+
   ProcessGroup processGroup{this, "processes", "Process module group"};
 
   FileSystemGroup filesystemGroup{this, "filesystem", "File system module group"};
 
   NetworkGroup networkGroup{this, "network", "Network module group"};
 
+  DiskStatsModule diskStats{this, "disks", "Module reading block device statistics"};
+
   WatchdogModuleGroup watchdog{this, "watchdog", "Module monitoring the watchdog process"};
 
   ctk::DataLossCounter<uint64_t> dataLossCounter{
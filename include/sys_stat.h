@@ -71,6 +71,13 @@ namespace proc_util {
   size_t getNChilds(const size_t& PGID, pids_info* infoptr, std::ostream& os = std::cout);
 #endif
 
+  /**
+   * Count the open file descriptors of a process by listing \c /proc/PID/fd.
+   * \param PID pid of the process to be considered.
+   * \return Number of open file descriptors. 0 if the directory can not be read (e.g. missing permissions).
+   */
+  size_t getNFDs(const size_t& PID);
+
 } // namespace proc_util
 
 /**
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * CpuLoad.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "CpuLoad.h"
+
+#include <algorithm>
+
+CpuLoad::CpuLoad(size_t nCpus) : _nCpus(nCpus) {
+  for(size_t state = 0; state < N_STATES; ++state) {
+    _ticks[state].assign(nCpus, 0);
+    _lastTicks[state].assign(nCpus, 0);
+    _shares[state].assign(nCpus, 0);
+  }
+  _allTicks.assign(nCpus, 0);
+  _lastAllTicks.assign(nCpus, 0);
+  _scale.assign(nCpus, 0);
+  _invalid.assign(nCpus, 0);
+}
+
+void CpuLoad::update(const SystemSnapshot::Cpu& total, const SystemSnapshot::CpuArray& cpus) {
+  size_t n = std::min(_nCpus, cpus.size());
+  uint64_t* busy = _ticks[USAGE].data();
+  uint64_t* all = _allTicks.data();
+  for(size_t i = 0; i < n; ++i) {
+    busy[i] = cpus.user[i] + cpus.nice[i] + cpus.system[i] + cpus.irq[i] + cpus.softirq[i] + cpus.steal[i];
+    all[i] = busy[i] + cpus.idle[i] + cpus.iowait[i];
+  }
+  std::copy_n(cpus.iowait.data(), n, _ticks[IOWAIT].data());
+  std::copy_n(cpus.irq.data(), n, _ticks[IRQ].data());
+  std::copy_n(cpus.softirq.data(), n, _ticks[SOFTIRQ].data());
+  std::copy_n(cpus.steal.data(), n, _ticks[STEAL].data());
+  std::copy_n(cpus.guest.data(), n, _ticks[GUEST].data());
+  // CPUs not found are 0
+  for(auto& ticks : _ticks) std::fill(ticks.begin() + n, ticks.end(), 0);
+  std::fill(_allTicks.begin() + n, _allTicks.end(), 0);
+
+  const uint64_t* lastAll = _lastAllTicks.data();
+  for(size_t i = 0; i < _nCpus; ++i) {
+    double passed = static_cast<double>(static_cast<int64_t>(all[i] - lastAll[i]));
+    _invalid[i] = all[i] < lastAll[i];
+    _scale[i] = passed > 0 ? 100. / passed : 0.;
+  }
+  for(size_t state = 0; state < N_STATES; ++state) {
+    calculate(_ticks[state].data(), _lastTicks[state].data(), _shares[state].data());
+  }
+  std::swap(_ticks, _lastTicks);
+  std::swap(_allTicks, _lastAllTicks);
+
+  // the summary uses the same definitions
+  uint64_t totalNow[N_STATES] = {total.busy(), total.iowait, total.irq, total.softirq, total.steal, total.guest};
+  uint64_t totalLast[N_STATES] = {
+      _lastTotal.busy(), _lastTotal.iowait, _lastTotal.irq, _lastTotal.softirq, _lastTotal.steal, _lastTotal.guest};
+  bool invalid = total.total() < _lastTotal.total();
+  double passed = static_cast<double>(total.total() - _lastTotal.total());
+  for(size_t state = 0; state < N_STATES; ++state) {
+    if(invalid || totalNow[state] < totalLast[state]) _totalShares[state] = -1.;
+    else _totalShares[state] = passed > 0 ? 100. * (totalNow[state] - totalLast[state]) / passed : 0.;
+  }
+  _lastTotal = total;
+}
+
+void CpuLoad::calculate(const uint64_t* now, const uint64_t* last, double* share) const {
+  const double* scale = _scale.data();
+  const uint8_t* invalid = _invalid.data();
+  for(size_t i = 0; i < _nCpus; ++i) {
+    double passed = static_cast<double>(static_cast<int64_t>(now[i] - last[i]));
+    share[i] = ((now[i] < last[i]) | invalid[i]) ? -1. : passed * scale[i];
+  }
+}
+
+void CpuLoad::aggregate(State state, const std::vector<size_t>& mapping, std::vector<double>& shares) {
+  // after the update the current ticks are stored in the last ticks
+  const uint64_t* now = _lastTicks[state].data();
+  const uint64_t* last = _ticks[state].data();
+  const uint64_t* all = _lastAllTicks.data();
+  const uint64_t* lastAll = _allTicks.data();
+  _groupTicks.assign(shares.size(), 0);
+  _groupAllTicks.assign(shares.size(), 0);
+  _groupValid.assign(shares.size(), 0);
+  for(size_t i = 0; i < std::min(_nCpus, mapping.size()); ++i) {
+    size_t group = mapping[i];
+    if(group >= shares.size() || now[i] < last[i] || all[i] < lastAll[i]) continue;
+    _groupTicks[group] += now[i] - last[i];
+    _groupAllTicks[group] += all[i] - lastAll[i];
+    _groupValid[group] = 1;
+  }
+  for(size_t group = 0; group < shares.size(); ++group) {
+    if(!_groupValid[group]) shares[group] = -1.;
+    else shares[group] = _groupAllTicks[group] > 0 ? 100. * _groupTicks[group] / _groupAllTicks[group] : 0.;
+  }
+}
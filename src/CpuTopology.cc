@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * CpuTopology.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "CpuTopology.h"
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+namespace {
+  constexpr size_t unassigned = std::numeric_limits<size_t>::max();
+
+  /** \return The first line of a file or an empty string if it can not be read. */
+  std::string readLine(const std::string& file) {
+    std::ifstream in(file);
+    std::string line;
+    std::getline(in, line);
+    boost::trim(line);
+    return line;
+  }
+} // namespace
+
+CpuTopology::CpuTopology(size_t nCpus, const std::string& sysPath) {
+  for(auto& mapping : _mapping) mapping.assign(nCpus, unassigned);
+  std::string cpuPath = sysPath + "/devices/system/cpu/cpu";
+
+  for(size_t cpu = 0; cpu < nCpus; ++cpu) {
+    auto id = readLine(cpuPath + std::to_string(cpu) + "/topology/physical_package_id");
+    if(!id.empty()) assign(SOCKET, cpu, id);
+  }
+
+  for(auto& node : listNodes(sysPath)) {
+    for(auto cpu : parseList(readLine(sysPath + "/devices/system/node/node" + node + "/cpulist"))) {
+      if(cpu < nCpus) assign(NODE, cpu, node);
+    }
+  }
+
+  bool hybrid = false;
+  for(auto type : {"core", "atom"}) {
+    for(auto cpu : parseList(readLine(sysPath + "/devices/cpu_" + type + "/cpus"))) {
+      if(cpu < nCpus) {
+        assign(CORE_TYPE, cpu, type);
+        hybrid = true;
+      }
+    }
+  }
+  if(!hybrid) {
+    for(size_t cpu = 0; cpu < nCpus; ++cpu) {
+      auto capacity = readLine(cpuPath + std::to_string(cpu) + "/cpu_capacity");
+      if(!capacity.empty()) assign(CORE_TYPE, cpu, "capacity" + capacity);
+    }
+    // all cores are equal
+    if(_groups[CORE_TYPE].size() == 1) {
+      _groups[CORE_TYPE].clear();
+      _mapping[CORE_TYPE].assign(nCpus, unassigned);
+    }
+  }
+
+  fillMissing(SOCKET, "0");
+  fillMissing(NODE, "0");
+  fillMissing(CORE_TYPE, "default");
+}
+
+std::vector<size_t> CpuTopology::parseList(const std::string& list) {
+  std::vector<size_t> cpus;
+  std::vector<std::string> ranges;
+  boost::split(ranges, list, boost::is_any_of(","));
+  for(auto& range : ranges) {
+    try {
+      auto pos = range.find('-');
+      size_t first = std::stoul(range.substr(0, pos));
+      size_t last = pos == std::string::npos ? first : std::stoul(range.substr(pos + 1));
+      for(size_t cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    catch(std::logic_error&) {
+      // skip empty or invalid ranges
+    }
+  }
+  return cpus;
+}
+
+std::vector<std::string> CpuTopology::listNodes(const std::string& sysPath) {
+  std::vector<std::string> nodes;
+  boost::system::error_code ec;
+  for(boost::filesystem::directory_iterator it(sysPath + "/devices/system/node", ec), end; !ec && it != end;
+      it.increment(ec)) {
+    auto name = it->path().filename().string();
+    if(name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+        std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+      nodes.push_back(name.substr(4));
+    }
+  }
+  // node10 after node9
+  std::sort(nodes.begin(), nodes.end(), [](const std::string& a, const std::string& b) {
+    return a.size() != b.size() ? a.size() < b.size() : a < b;
+  });
+  return nodes;
+}
+
+void CpuTopology::assign(Level level, size_t cpu, const std::string& group) {
+  auto& groups = _groups[level];
+  auto it = std::find(groups.begin(), groups.end(), group);
+  _mapping[level][cpu] = it - groups.begin();
+  if(it == groups.end()) groups.push_back(group);
+}
+
+void CpuTopology::fillMissing(Level level, const std::string& fallback) {
+  for(size_t cpu = 0; cpu < _mapping[level].size(); ++cpu) {
+    if(_mapping[level][cpu] == unassigned) assign(level, cpu, fallback);
+  }
+  if(_groups[level].empty()) _groups[level].push_back(fallback);
+}
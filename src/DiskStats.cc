@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * DiskStats.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "DiskStats.h"
+
+#include "ProcFile.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <iterator>
+
+namespace {
+  /** Fields of a line following the device name, nullptr for fields that are not used */
+  constexpr uint64_t DiskStats::Counters::*fields[] = {&DiskStats::Counters::reads, nullptr,
+      &DiskStats::Counters::sectorsRead, &DiskStats::Counters::msReading, &DiskStats::Counters::writes, nullptr,
+      &DiskStats::Counters::sectorsWritten, &DiskStats::Counters::msWriting, &DiskStats::Counters::inFlight,
+      &DiskStats::Counters::msBusy, &DiskStats::Counters::msWeighted};
+
+  /** \return Difference of two counters, 0 if the counter decreased. */
+  double delta(uint64_t current, uint64_t last) {
+    return current > last ? static_cast<double>(current - last) : 0.;
+  }
+} // namespace
+
+DiskStats::DiskStats(size_t nSlots, const std::string& procPath, const std::string& sysPath)
+: _fileName(procPath + "/diskstats"), _sysPath(sysPath), _buffer(16 * 1024, '\0'), _names(nSlots),
+  _counters(nSlots), _rates(nSlots), _seen(nSlots) {
+  _fd = ::open(_fileName.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+DiskStats::~DiskStats() {
+  close();
+}
+
+DiskStats::DiskStats(DiskStats&& other) noexcept {
+  *this = std::move(other);
+}
+
+DiskStats& DiskStats::operator=(DiskStats&& other) noexcept {
+  if(this == &other) return *this;
+  close();
+  _fileName = std::move(other._fileName);
+  _sysPath = std::move(other._sysPath);
+  _fd = other._fd;
+  _buffer = std::move(other._buffer);
+  _names = std::move(other._names);
+  _counters = std::move(other._counters);
+  _rates = std::move(other._rates);
+  _seen = std::move(other._seen);
+  _accepted = std::move(other._accepted);
+  _pending = std::move(other._pending);
+  _lastUpdate = other._lastUpdate;
+  _namesChanged = other._namesChanged;
+  _nDropped = other._nDropped;
+  _error = std::move(other._error);
+  other._fd = -1;
+  return *this;
+}
+
+void DiskStats::close() {
+  if(_fd >= 0) ::close(_fd);
+  _fd = -1;
+}
+
+std::vector<std::string> DiskStats::findDevices(const std::string& procPath, const std::string& sysPath) {
+  DiskStats stats(256, procPath, sysPath);
+  stats.update();
+  std::vector<std::string> devices;
+  std::copy_if(stats._names.begin(), stats._names.end(), std::back_inserter(devices),
+      [](const std::string& name) { return !name.empty(); });
+  return devices;
+}
+
+bool DiskStats::accept(std::string_view name) {
+  // the result is cached, so each device name is only checked once
+  std::string key(name);
+  auto it = _accepted.find(key);
+  if(it != _accepted.end()) return it->second;
+  bool accepted = key.compare(0, 4, "loop") != 0 && key.compare(0, 3, "ram") != 0 &&
+      key.compare(0, 4, "zram") != 0 && access((_sysPath + "/block/" + key).c_str(), F_OK) == 0;
+  _accepted.emplace(key, accepted);
+  return accepted;
+}
+
+bool DiskStats::update(std::chrono::steady_clock::time_point now) {
+  _namesChanged = false;
+  _nDropped = 0;
+  if(_fd < 0) {
+    _error = _fileName + ": can not be opened";
+    return false;
+  }
+  auto data = procfs::readFile(_fd, _buffer);
+  if(data.empty()) {
+    _error = _fileName + ": can not be read";
+    return false;
+  }
+  double dt = std::chrono::duration<double>(now - _lastUpdate).count();
+  _lastUpdate = now;
+
+  std::fill(_seen.begin(), _seen.end(), 0);
+  _pending.clear();
+  bool ok = true;
+  while(!data.empty()) {
+    auto line = procfs::nextLine(data);
+    // major and minor number
+    procfs::nextWord(line);
+    procfs::nextWord(line);
+    auto name = procfs::nextWord(line);
+    if(name.empty()) continue;
+    if(!accept(name)) continue;
+    Counters counters;
+    bool valid = true;
+    for(auto field : fields) {
+      uint64_t value;
+      auto word = procfs::nextWord(line);
+      valid = std::from_chars(word.data(), word.data() + word.size(), value).ec == std::errc();
+      if(!valid) break;
+      if(field) counters.*field = value;
+    }
+    // an invalid device keeps its slot and its last rates
+    if(!valid) {
+      _error = _fileName + ": invalid line for " + std::string(name);
+      ok = false;
+      auto slot = std::find(_names.begin(), _names.end(), name) - _names.begin();
+      if(static_cast<size_t>(slot) < _names.size()) _seen[slot] = 1;
+      continue;
+    }
+
+    auto slot = std::find(_names.begin(), _names.end(), name) - _names.begin();
+    if(static_cast<size_t>(slot) == _names.size()) {
+      // new devices get a slot once the slots of removed devices are freed
+      _pending.emplace_back(name, counters);
+      continue;
+    }
+    _seen[slot] = 1;
+    calculate(slot, counters, dt);
+    _counters[slot] = counters;
+  }
+
+  // free the slots of removed devices
+  for(size_t slot = 0; slot < _names.size(); ++slot) {
+    if(_seen[slot] || _names[slot].empty()) continue;
+    _names[slot].clear();
+    _counters[slot] = Counters{};
+    _rates[slot] = Rates{};
+    _namesChanged = true;
+  }
+
+  // new devices use the first free slot and start with rates of 0
+  for(auto& device : _pending) {
+    auto slot = std::find(_names.begin(), _names.end(), std::string()) - _names.begin();
+    if(static_cast<size_t>(slot) == _names.size()) {
+      _nDropped++;
+      continue;
+    }
+    _names[slot] = device.first;
+    _counters[slot] = device.second;
+    _rates[slot] = Rates{};
+    _rates[slot].inFlight = device.second.inFlight;
+    _namesChanged = true;
+  }
+  _pending.clear();
+  return ok;
+}
+
+void DiskStats::calculate(size_t slot, const Counters& current, double dt) {
+  auto& last = _counters[slot];
+  auto& rates = _rates[slot];
+  double reads = delta(current.reads, last.reads);
+  double writes = delta(current.writes, last.writes);
+  rates.readIOPS = dt > 0 ? reads / dt : 0.;
+  rates.writeIOPS = dt > 0 ? writes / dt : 0.;
+  rates.readBytes = dt > 0 ? delta(current.sectorsRead, last.sectorsRead) * 512 / dt : 0.;
+  rates.writeBytes = dt > 0 ? delta(current.sectorsWritten, last.sectorsWritten) * 512 / dt : 0.;
+  rates.readLatency = reads > 0 ? delta(current.msReading, last.msReading) / reads : 0.;
+  rates.writeLatency = writes > 0 ? delta(current.msWriting, last.msWriting) / writes : 0.;
+  rates.queueDepth = dt > 0 ? delta(current.msWeighted, last.msWeighted) / (dt * 1000) : 0.;
+  rates.inFlight = current.inFlight;
+  rates.utilisation = dt > 0 ? std::min(delta(current.msBusy, last.msBusy) / (dt * 10), 100.) : 0.;
+}
@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * ExecSpec.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "ExecSpec.h"
+
+#include <unistd.h>
+
+#include <stdexcept>
+
+// environ is a variable declared in unistd.h
+extern char** environ;
+
+ExecSpec::ExecSpec(const std::string& path, const std::string& cmd, const std::string& environment, bool overwriteEnv)
+: _path(path), _cmd(cmd), _environment(environment), _overwriteEnv(overwriteEnv) {
+  _args = parseArguments(cmd);
+  if(_args.empty()) {
+    throw std::runtime_error("Command is empty.");
+  }
+
+  for(char** var = environ; var != nullptr && *var != nullptr; ++var) {
+    _env.emplace_back(*var);
+  }
+  for(auto& envArg : parseArguments(environment, ",")) {
+    std::size_t sep = envArg.find_first_of("=");
+    if(sep == std::string::npos || sep == 0) {
+      _ignoredEnv.push_back(envArg);
+      continue;
+    }
+    auto it = _env.begin();
+    for(; it != _env.end(); ++it) {
+      if(it->compare(0, sep + 1, envArg, 0, sep + 1) == 0) break;
+    }
+    if(it == _env.end()) {
+      _env.push_back(envArg);
+    }
+    else if(overwriteEnv) {
+      *it = envArg;
+    }
+  }
+  prepare();
+}
+
+ExecSpec::ExecSpec(const std::string& path, std::vector<std::string> args, std::vector<std::string> env)
+: _path(path), _args(std::move(args)), _env(std::move(env)) {
+  if(_args.empty()) {
+    throw std::runtime_error("Command is empty.");
+  }
+  prepare();
+}
+
+void ExecSpec::prepare() {
+  _file = _path;
+  if(_file.empty() || _file.back() != '/') _file.append("/");
+  _file.append(_args.front());
+
+  _argv.clear();
+  for(auto& arg : _args) _argv.push_back(&arg[0]);
+  _argv.push_back(nullptr);
+  _envp.clear();
+  for(auto& var : _env) _envp.push_back(&var[0]);
+  _envp.push_back(nullptr);
+}
+
+bool ExecSpec::matches(
+    const std::string& path, const std::string& cmd, const std::string& environment, bool overwriteEnv) const {
+  return path == _path && cmd == _cmd && environment == _environment && overwriteEnv == _overwriteEnv;
+}
+
+std::vector<std::string> ExecSpec::parseArguments(const std::string& input, const std::string& separators) {
+  std::vector<std::string> out;
+  std::string current;
+  // needed to keep empty quoted arguments like ""
+  bool hasArgument = false;
+  char quote = 0;
+  for(size_t i = 0; i < input.size(); ++i) {
+    char c = input[i];
+    if(quote == '\'') {
+      if(c == '\'')
+        quote = 0;
+      else
+        current.push_back(c);
+    }
+    else if(c == '\\') {
+      if(++i == input.size()) {
+        throw std::runtime_error("Trailing backslash in: " + input);
+      }
+      // inside double quotes only quotes and backslashes are escaped
+      if(quote == '"' && input[i] != '"' && input[i] != '\\') current.push_back(c);
+      current.push_back(input[i]);
+      hasArgument = true;
+    }
+    else if(quote == '"') {
+      if(c == '"')
+        quote = 0;
+      else
+        current.push_back(c);
+    }
+    else if(c == '"' || c == '\'') {
+      quote = c;
+      hasArgument = true;
+    }
+    else if(separators.find(c) != std::string::npos) {
+      if(hasArgument) out.push_back(current);
+      current.clear();
+      hasArgument = false;
+    }
+    else {
+      current.push_back(c);
+      hasArgument = true;
+    }
+  }
+  if(quote != 0) {
+    throw std::runtime_error("Missing closing quote in: " + input);
+  }
+  if(hasArgument) out.push_back(current);
+  return out;
+}
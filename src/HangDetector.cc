@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * HangDetector.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "HangDetector.h"
+
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+bool HangDetector::update(uint64_t heartbeat, unsigned int timeout, std::chrono::steady_clock::time_point now) {
+  if(!_valid || heartbeat != _lastHeartbeat) {
+    _valid = true;
+    _lastHeartbeat = heartbeat;
+    _lastChange = now;
+    return false;
+  }
+  if(timeout == 0) return false;
+  return now - _lastChange > std::chrono::seconds(timeout);
+}
+
+double HangDetector::getStallTime(std::chrono::steady_clock::time_point now) const {
+  if(!_valid) return 0.;
+  return std::chrono::duration<double>(now - _lastChange).count();
+}
+
+bool HangDetector::readHeartbeat(Source source, const std::string& fileName, uint64_t& heartbeat) {
+  if(fileName.empty()) return false;
+  if(source == Source::FileMTime) {
+    struct stat st;
+    if(stat(fileName.c_str(), &st) != 0) return false;
+    heartbeat = (uint64_t)st.st_mtim.tv_sec * 1000000000ULL + (uint64_t)st.st_mtim.tv_nsec;
+    return true;
+  }
+  if(source == Source::Counter) {
+    int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0) return false;
+    uint64_t value{0};
+    bool ok = pread(fd, &value, sizeof(value), 0) == (ssize_t)sizeof(value);
+    close(fd);
+    if(ok) heartbeat = value;
+    return ok;
+  }
+  return false;
+}
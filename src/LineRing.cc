@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * LineRing.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "LineRing.h"
+
+#include <cstring>
+
+void LineRing::setCapacity(size_t capacity) {
+  _capacity = capacity;
+  while(_lines.size() > _capacity) _lines.pop_front();
+}
+
+void LineRing::add(const char* data, size_t size) {
+  const char* end = data + size;
+  while(data < end) {
+    auto newline = static_cast<const char*>(memchr(data, '\n', end - data));
+    if(newline == nullptr) {
+      _partial.append(data, end);
+      return;
+    }
+    _partial.append(data, newline);
+    _lines.push_back(std::move(_partial));
+    _partial.clear();
+    if(_lines.size() > _capacity) _lines.pop_front();
+    data = newline + 1;
+  }
+}
+
+void LineRing::clear() {
+  _lines.clear();
+  _partial.clear();
+}
+
+std::string LineRing::format() const {
+  std::string tail;
+  if(_capacity == 0) return tail;
+  // an incomplete last line counts as a line
+  size_t nComplete = _partial.empty() ? _capacity : _capacity - 1;
+  size_t skip = _lines.size() > nComplete ? _lines.size() - nComplete : 0;
+  for(auto it = _lines.begin() + skip; it != _lines.end(); ++it) {
+    tail.append(*it);
+    tail.push_back('\n');
+  }
+  if(!_partial.empty()) {
+    tail.append(_partial);
+    tail.push_back('\n');
+  }
+  return tail;
+}
@@ -10,49 +10,71 @@
 
 #include "LogFileReader.h"
 
-void LogFileModule::mainLoop() {
-  logFile.read();
-  //  std::string currentFile = (std::string)logFile;
-  logFileBuffer.reset(new std::filebuf);
-  logFileBuffer->open((std::string)logFile, std::ios::in);
-  std::stringstream messageTail;
-  while(1) {
-    readAll();
-    messageTail.clear();
-    messageTail.str("");
-    if(config.tailLength < 1) {
-      messageTail << "Tail length is <1. No messages from the log file read." << std::endl;
+#include <algorithm>
+
+bool LogPage::update(const std::string& fileName) {
+  if(nLines == 0) {
+    // paging is disabled -> do not index the log file at all
+    if(_nLines == 0) return false;
+    // an empty file name closes the file and drops the index
+    _index.update("");
+    _nLines = 0;
+    page = "";
+    pageFirstLine = 0;
+    totalLines = 0;
+    return true;
+  }
+  bool changed = _index.update(fileName);
+  if(!changed && _firstLine == firstLine && _nLines == nLines && _startTime == (const std::string&)startTime &&
+      _endTime == (const std::string&)endTime) {
+    return false;
+  }
+  _firstLine = firstLine;
+  _nLines = nLines;
+  _startTime = (const std::string&)startTime;
+  _endTime = (const std::string&)endTime;
+
+  size_t total = _index.getNLines();
+  size_t first = 0;
+  size_t n = std::min(_nLines, maxLines);
+  int64_t time;
+  std::string error;
+  if(!_startTime.empty()) {
+    if(LogIndex::parseTimestamp(_startTime, time)) first = _index.findTime(time);
+    else error = "Can not parse startTime: " + _startTime + "\n";
+  }
+  else if(_firstLine < 0) {
+    first = total - std::min<size_t>(total, -_firstLine);
+  }
+  else {
+    first = _firstLine;
+  }
+  if(!_endTime.empty()) {
+    if(LogIndex::parseTimestamp(_endTime, time)) {
+      size_t end = _index.findTime(time);
+      n = end > first ? std::min(n, end - first) : 0;
     }
     else {
-      if(((std::string)logFile).empty()) {
-        messageTail << "No log file is set. Try starting the process and setting a LogFile." << std::endl;
-      }
-      else {
-        /**
-         * Always reopen the file buffer.
-         * If the file buffer is only opened in case the log file name changes the following problem arises:
-         * When the process is stopped the buffer is not updated anymore, which is ok. But if the log file is deleted
-         * and the process is started again a new log file is created. The buffer will not recognize this and still
-         * show the last update (of the log file that was deleted). Updates of the new log file would not be
-         * updated here.
-         */
-        logFileBuffer->open((std::string)logFile, std::ios::in);
-        if(logFileBuffer->is_open()) {
-          std::istream i(&(*logFileBuffer));
-          logging::formatLogTail(i, messageTail, config.tailLength);
-        }
-        else {
-          messageTail << "Can not open file: " << (std::string)logFile << std::endl;
-        }
-        logFileBuffer->close();
-      }
+      error = "Can not parse endTime: " + _endTime + "\n";
     }
-    status.logTailExtern = messageTail.str();
-    status.logTailExtern.write();
   }
+  page = error.empty() ? _index.readLines(first, n) : error;
+  pageFirstLine = first;
+  totalLines = total;
+  return true;
 }
 
-void LogFileModule::terminate() {
-  if((logFileBuffer.get() != nullptr) && (logFileBuffer->is_open())) logFileBuffer->close();
-  ApplicationModule::terminate();
+void LogFileModule::mainLoop() {
+  while(1) {
+    readAll();
+    if(_logTail.update((std::string)logFile, config.tailLength)) {
+      status.logTailExtern = _logTail.getTail();
+      status.logTailExtern.write();
+    }
+    if(logPage.update((std::string)logFile)) {
+      logPage.page.write();
+      logPage.pageFirstLine.write();
+      logPage.totalLines.write();
+    }
+  }
 }
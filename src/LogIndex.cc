@@ -0,0 +1,303 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * LogIndex.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "LogIndex.h"
+
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+  /** Size of the chunks read from the file */
+  constexpr size_t chunkSize = 64 * 1024;
+  /** Number of characters at the beginning of a line kept to parse the time stamp */
+  constexpr size_t headLength = 32;
+  /** Lines read from the file are cut after this number of characters */
+  constexpr size_t maxLineLength = 1024 * 1024;
+
+  bool parseNumber(std::string_view text, size_t pos, size_t length, int& value) {
+    if(pos + length > text.size()) return false;
+    value = 0;
+    for(size_t i = pos; i < pos + length; ++i) {
+      if(text[i] < '0' || text[i] > '9') return false;
+      value = value * 10 + (text[i] - '0');
+    }
+    return true;
+  }
+
+  bool parseMonth(std::string_view text, size_t pos, int& month) {
+    static constexpr std::string_view months[] = {
+        "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    if(pos + 3 > text.size()) return false;
+    for(int i = 0; i < 12; ++i) {
+      if(text.substr(pos, 3) == months[i]) {
+        month = i + 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** Days since 1970-01-01 of the given date in the proleptic Gregorian calendar. */
+  int64_t daysFromCivil(int64_t y, int m, int d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int64_t yoe = y - era * 400;
+    const int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+  }
+} // namespace
+
+LogIndex::LogIndex(size_t stride, size_t maxBytesPerUpdate)
+: _stride(std::max<size_t>(stride, 1)), _maxBytesPerUpdate(std::max<size_t>(maxBytesPerUpdate, 1)) {
+  clear();
+}
+
+LogIndex::~LogIndex() {
+  close();
+}
+
+LogIndex::LogIndex(LogIndex&& other) noexcept {
+  *this = std::move(other);
+}
+
+LogIndex& LogIndex::operator=(LogIndex&& other) noexcept {
+  if(this == &other) return *this;
+  close();
+  _stride = other._stride;
+  _maxBytesPerUpdate = other._maxBytesPerUpdate;
+  _fileName = std::move(other._fileName);
+  _fd = other._fd;
+  _reactor = std::move(other._reactor);
+  _watch = std::move(other._watch);
+  _device = other._device;
+  _inode = other._inode;
+  _offset = other._offset;
+  _pending = other._pending;
+  _lineStart = other._lineStart;
+  _nLines = other._nLines;
+  _latest = other._latest;
+  _head = std::move(other._head);
+  _entries = std::move(other._entries);
+  other._fd = -1;
+  other._watch.reset();
+  other.clear();
+  return *this;
+}
+
+bool LogIndex::update(const std::string& fileName) {
+  auto nLines = _nLines;
+  bool reset = false;
+  if(fileName != _fileName) {
+    reset = _offset > 0;
+    close();
+    _fileName = fileName;
+  }
+  bool modified = true;
+  if(_fd >= 0 && checkReopen(modified)) {
+    // the file was moved or deleted, e.g. by log rotation
+    reset |= _offset > 0;
+    close();
+  }
+  // nothing changed since the last update and everything is indexed
+  if(_fd >= 0 && !modified && !_pending) return reset;
+  struct stat st;
+  if(_fd < 0 && !_fileName.empty()) {
+    _fd = ::open(_fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if(_fd >= 0) {
+      // watch before reading the size, so no data written in between is missed
+      if(_reactor == nullptr) _reactor = LogWatchReactor::get();
+      if(_reactor != nullptr) _watch = _reactor->watch(_fileName);
+      if(fstat(_fd, &st) == 0) {
+        _device = st.st_dev;
+        _inode = st.st_ino;
+      }
+    }
+  }
+  if(_fd < 0 || fstat(_fd, &st) != 0) return reset || nLines != _nLines;
+  if(st.st_size < _offset) {
+    // truncated, e.g. by copy-truncate log rotation
+    reset = true;
+    clear();
+  }
+  std::string buffer;
+  size_t budget = _maxBytesPerUpdate;
+  while(_offset < st.st_size && budget > 0) {
+    if(buffer.empty()) buffer.resize(chunkSize);
+    size_t n = std::min({chunkSize, static_cast<size_t>(st.st_size - _offset), budget});
+    auto nRead = pread(_fd, buffer.data(), n, _offset);
+    if(nRead <= 0) break;
+    add(buffer.data(), nRead);
+    budget -= nRead;
+  }
+  _pending = _offset < st.st_size;
+  return reset || nLines != _nLines;
+}
+
+bool LogIndex::checkReopen(bool& modified) {
+  struct stat st;
+  if(_watch == nullptr) {
+    // no inotify -> compare the file found by name with the opened one
+    modified = true;
+    return stat(_fileName.c_str(), &st) != 0 || st.st_dev != _device || st.st_ino != _inode;
+  }
+  unsigned int events = _watch->takeEvents();
+  if(events & LogWatchReactor::Reopen) return true;
+  modified = (events & LogWatchReactor::Modified) != 0;
+  // deleting the file only changes the link count as long as it is opened here
+  return (events & LogWatchReactor::Attributes) && fstat(_fd, &st) == 0 && st.st_nlink == 0;
+}
+
+void LogIndex::clear() {
+  _offset = 0;
+  _pending = false;
+  _lineStart = 0;
+  _nLines = 0;
+  _latest = INT64_MIN;
+  _head.clear();
+  _entries.assign(1, Entry{0, 0, INT64_MIN});
+}
+
+void LogIndex::close() {
+  if(_watch != nullptr) _reactor->unwatch(_watch);
+  _watch.reset();
+  if(_fd >= 0) ::close(_fd);
+  _fd = -1;
+  clear();
+}
+
+void LogIndex::add(const char* data, size_t size) {
+  const char* end = data + size;
+  const char* pos = data;
+  while(pos < end) {
+    auto lineFeed = static_cast<const char*>(memchr(pos, '\n', end - pos));
+    const char* lineEnd = lineFeed != nullptr ? lineFeed : end;
+    if(_head.size() < headLength) _head.append(pos, std::min<size_t>(lineEnd - pos, headLength - _head.size()));
+    if(lineFeed == nullptr) break;
+    int64_t time;
+    if(parseTimestamp(_head, time) && time > _latest) _latest = time;
+    _head.clear();
+    _nLines++;
+    _lineStart = _offset + (lineFeed + 1 - data);
+    if(_nLines % _stride == 0) _entries.push_back(Entry{_nLines, _lineStart, _latest});
+    pos = lineFeed + 1;
+  }
+  _offset += size;
+}
+
+const LogIndex::Entry& LogIndex::findEntry(size_t line) const {
+  auto it = std::upper_bound(
+      _entries.begin(), _entries.end(), line, [](size_t value, const Entry& entry) { return value < entry.line; });
+  // the first entry is line 0, so it is never returned by upper_bound
+  return *(it - 1);
+}
+
+template<typename FUNC>
+void LogIndex::forEachLine(off_t offset, FUNC&& function) const {
+  std::string buffer(chunkSize, '\0');
+  std::string pending;
+  while(offset < _lineStart) {
+    size_t n = std::min(chunkSize, static_cast<size_t>(_lineStart - offset));
+    auto nRead = pread(_fd, buffer.data(), n, offset);
+    if(nRead <= 0) return;
+    offset += nRead;
+    std::string_view data(buffer.data(), nRead);
+    while(!data.empty()) {
+      auto lineFeed = data.find('\n');
+      auto line = data.substr(0, lineFeed == std::string_view::npos ? data.size() : lineFeed + 1);
+      data.remove_prefix(line.size());
+      if(lineFeed == std::string_view::npos || !pending.empty()) {
+        // line continues in the next chunk
+        pending.append(line.substr(0, maxLineLength - std::min(pending.size(), maxLineLength)));
+        if(lineFeed == std::string_view::npos) break;
+        bool proceed = function(std::string_view(pending));
+        pending.clear();
+        if(!proceed) return;
+      }
+      else if(!function(line)) {
+        return;
+      }
+    }
+  }
+}
+
+std::string LogIndex::readLines(size_t first, size_t n, size_t maxBytes) const {
+  std::string result;
+  if(_fd < 0 || first >= _nLines || n == 0) return result;
+  const auto& entry = findEntry(first);
+  size_t line = entry.line;
+  size_t last = std::min(first + n, _nLines);
+  forEachLine(entry.offset, [&](std::string_view text) {
+    if(line >= first) {
+      if(result.size() + text.size() > maxBytes) {
+        if(result.empty()) result.append(text.substr(0, maxBytes));
+        return false;
+      }
+      result.append(text);
+    }
+    return ++line < last;
+  });
+  return result;
+}
+
+size_t LogIndex::findTime(int64_t time) const {
+  if(_fd < 0 || _nLines == 0) return _nLines;
+  // the time stamps are carried forward, so they are sorted even if the clock jumped back
+  auto it = std::partition_point(
+      _entries.begin(), _entries.end(), [time](const Entry& entry) { return entry.before < time; });
+  if(it == _entries.begin()) return 0;
+  const auto& entry = *(it - 1);
+  size_t line = entry.line;
+  int64_t latest = entry.before;
+  size_t result = _nLines;
+  forEachLine(entry.offset, [&](std::string_view text) {
+    int64_t lineTime;
+    if(parseTimestamp(text, lineTime) && lineTime > latest) latest = lineTime;
+    if(latest >= time) {
+      result = line;
+      return false;
+    }
+    return ++line < _nLines;
+  });
+  return result;
+}
+
+bool LogIndex::parseTimestamp(std::string_view line, int64_t& time) {
+  if(!line.empty() && line[0] == '[') line.remove_prefix(1);
+  int year, month, day, hour, minute, second;
+  if(!parseNumber(line, 0, 4, year) || line.size() < 5 || line[4] != '-') return false;
+  size_t pos;
+  if(parseNumber(line, 5, 2, month)) {
+    // 2026-10-19
+    pos = 7;
+  }
+  else if(parseMonth(line, 5, month)) {
+    // 2026-Oct-19
+    pos = 8;
+  }
+  else {
+    return false;
+  }
+  if(line.size() < pos + 12 || line[pos] != '-' || (line[pos + 3] != ' ' && line[pos + 3] != 'T') ||
+      line[pos + 6] != ':' || line[pos + 9] != ':') {
+    return false;
+  }
+  if(!parseNumber(line, pos + 1, 2, day) || !parseNumber(line, pos + 4, 2, hour) ||
+      !parseNumber(line, pos + 7, 2, minute) || !parseNumber(line, pos + 10, 2, second)) {
+    return false;
+  }
+  if(month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) return false;
+  time = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+  return true;
+}
@@ -0,0 +1,289 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * LogRotator.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "LogRotator.h"
+
+#include <sys/stat.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+  /**
+   * Copy the content of a file using copy_file_range, which avoids copying the data to user space.
+   */
+  bool copyFile(int in, int out) {
+    while(true) {
+      ssize_t n = copy_file_range(in, nullptr, out, nullptr, 1 << 30, 0);
+      if(n == 0) return true;
+      if(n > 0) continue;
+      if(errno == EINTR) continue;
+      if(errno != EXDEV && errno != ENOSYS && errno != EINVAL) return false;
+      // fall back to read/write, e.g. if the files are on different file systems
+      char buffer[65536];
+      while((n = read(in, buffer, sizeof(buffer))) > 0) {
+        if(write(out, buffer, n) != n) return false;
+      }
+      return n == 0;
+    }
+  }
+
+  std::string rotatedName(const std::string& fileName) {
+    char timeString[32];
+    time_t t = time(nullptr);
+    struct tm local;
+    localtime_r(&t, &local);
+    strftime(timeString, sizeof(timeString), "%Y%m%d-%H%M%S", &local);
+    std::string name = fileName + "." + timeString;
+    // avoid overwriting files rotated within the same second
+    std::string candidate = name;
+    for(size_t i = 1; access(candidate.c_str(), F_OK) == 0 || access((candidate + ".gz").c_str(), F_OK) == 0; i++) {
+      candidate = name + "-" + std::to_string(i);
+    }
+    return candidate;
+  }
+
+  /**
+   * Copy the log file to the rotated file and truncate it afterwards.
+   * \return The reason of the failure, empty on success.
+   */
+  std::string copyTruncate(const std::string& fileName, const std::string& rotated) {
+    int in = open(fileName.c_str(), O_RDWR | O_CLOEXEC);
+    if(in < 0) return "Failed to open log file " + fileName + ": " + strerror(errno);
+    struct stat st;
+    int out = -1;
+    if(fstat(in, &st) == 0) out = open(rotated.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, st.st_mode & 0777);
+    if(out < 0) {
+      close(in);
+      return "Failed to create rotated log file " + rotated + ": " + strerror(errno);
+    }
+    bool ok = copyFile(in, out);
+    close(out);
+    if(ok) ok = ftruncate(in, 0) == 0;
+    close(in);
+    if(!ok) {
+      std::string error = "Failed to copy log file " + fileName + " to " + rotated + ": " + strerror(errno);
+      remove(rotated.c_str());
+      return error;
+    }
+    return "";
+  }
+} // namespace
+
+class LogRotator::Worker {
+ public:
+  struct Job {
+    std::string rotatedFile; ///< File to be compressed
+    bool compress;
+    std::string logFile; ///< Log file used to find the rotated files
+    uint64_t retention;  ///< Budget in bytes, 0 means unlimited
+    std::shared_ptr<CopyState> copy; ///< If set the log file is copied to rotatedFile and truncated first
+  };
+
+  static std::shared_ptr<Worker> get() {
+    static std::mutex mutex;
+    static std::weak_ptr<Worker> instance;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto worker = instance.lock();
+    if(!worker) {
+      worker = std::make_shared<Worker>();
+      instance = worker;
+    }
+    return worker;
+  }
+
+  Worker() : _thread(&Worker::run, this) {}
+
+  ~Worker() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _condition.notify_all();
+    _thread.join();
+  }
+
+  void add(Job job) {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _jobs.push_back(std::move(job));
+    }
+    _condition.notify_all();
+  }
+
+  void waitIdle() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this] { return _jobs.empty() && !_busy; });
+  }
+
+ private:
+  void run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(true) {
+      _condition.wait(lock, [this] { return _stop || !_jobs.empty(); });
+      if(_jobs.empty()) return;
+      Job job = std::move(_jobs.front());
+      _jobs.pop_front();
+      _busy = true;
+      lock.unlock();
+      bool copied = true;
+      if(job.copy) {
+        std::string error = copyTruncate(job.logFile, job.rotatedFile);
+        copied = error.empty();
+        std::lock_guard<std::mutex> copyLock(job.copy->mutex);
+        job.copy->error = std::move(error);
+        job.copy->done = true;
+      }
+      if(job.compress && copied) compressFile(job.rotatedFile);
+      if(job.retention > 0) enforceRetention(job.logFile, job.retention);
+      lock.lock();
+      _busy = false;
+      _condition.notify_all();
+    }
+  }
+
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  std::deque<Job> _jobs;
+  bool _busy{false};
+  bool _stop{false};
+  std::thread _thread;
+};
+
+LogRotator::LogRotator() : _worker(Worker::get()) {}
+
+std::string LogRotator::check(
+    const std::string& fileName, const Settings& settings, Method method, std::chrono::steady_clock::time_point now) {
+  if(_copy) {
+    std::string error;
+    {
+      std::lock_guard<std::mutex> lock(_copy->mutex);
+      // the file is still large until the copy is done, so it must not be rotated again
+      if(!_copy->done) return "";
+      error = std::move(_copy->error);
+    }
+    _copy.reset();
+    if(!error.empty()) throw std::runtime_error(error);
+  }
+  if(fileName != _fileName) {
+    _fileName = fileName;
+    _since = now;
+  }
+  if(fileName.empty() || (settings.maxSize == 0 && settings.maxAge == 0)) return "";
+  struct stat st;
+  if(stat(fileName.c_str(), &st) != 0 || st.st_size == 0) return "";
+  bool rotate = settings.maxSize > 0 && (uint64_t)st.st_size > settings.maxSize * 1024;
+  rotate |= settings.maxAge > 0 && now - _since >= std::chrono::seconds(settings.maxAge);
+  if(!rotate) return "";
+
+  std::string rotated = rotatedName(fileName);
+  if(method == Method::Rename) {
+    if(rename(fileName.c_str(), rotated.c_str()) != 0) {
+      throw std::runtime_error("Failed to rename log file " + fileName + ": " + strerror(errno));
+    }
+  }
+  else {
+    // copying a large file takes a while, so it is done by the worker like the compression
+    _copy = std::make_shared<CopyState>();
+  }
+  _since = now;
+  if(settings.compress || settings.retention > 0 || _copy) {
+    _worker->add({rotated, settings.compress, fileName, settings.retention * 1024, _copy});
+  }
+  return rotated;
+}
+
+void LogRotator::waitForBackgroundJobs() {
+  Worker::get()->waitIdle();
+}
+
+bool LogRotator::compressFile(const std::string& fileName) {
+  int in = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+  if(in < 0) return false;
+  std::string target = fileName + ".gz";
+  gzFile out = gzopen(target.c_str(), "wb");
+  if(out == nullptr) {
+    close(in);
+    return false;
+  }
+  char buffer[65536];
+  ssize_t n;
+  bool ok = true;
+  while((n = read(in, buffer, sizeof(buffer))) > 0) {
+    if(gzwrite(out, buffer, n) != n) {
+      ok = false;
+      break;
+    }
+  }
+  ok &= n >= 0;
+  ok &= gzclose(out) == Z_OK;
+  close(in);
+  if(!ok) {
+    remove(target.c_str());
+    return false;
+  }
+  remove(fileName.c_str());
+  return true;
+}
+
+std::vector<std::string> LogRotator::findRotatedFiles(const std::string& fileName) {
+  std::vector<std::pair<struct timespec, std::string>> found;
+  auto sep = fileName.find_last_of('/');
+  std::string dir = sep == std::string::npos ? "." : fileName.substr(0, sep + 1);
+  std::string prefix = (sep == std::string::npos ? fileName : fileName.substr(sep + 1)) + ".";
+  DIR* d = opendir(dir.c_str());
+  if(d == nullptr) return {};
+  while(struct dirent* entry = readdir(d)) {
+    std::string name = entry->d_name;
+    // rotated files start with the date: <logfile>.YYYYMMDD-HHMMSS
+    if(name.size() < prefix.size() + 15 || name.compare(0, prefix.size(), prefix) != 0 ||
+        !isdigit(name[prefix.size()]) || name[prefix.size() + 8] != '-') {
+      continue;
+    }
+    std::string path = sep == std::string::npos ? name : dir + name;
+    struct stat st;
+    if(stat(path.c_str(), &st) == 0) found.emplace_back(st.st_mtim, path);
+  }
+  closedir(d);
+  std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) {
+    if(a.first.tv_sec != b.first.tv_sec) return a.first.tv_sec < b.first.tv_sec;
+    if(a.first.tv_nsec != b.first.tv_nsec) return a.first.tv_nsec < b.first.tv_nsec;
+    return a.second < b.second;
+  });
+  std::vector<std::string> out;
+  for(auto& f : found) out.push_back(f.second);
+  return out;
+}
+
+void LogRotator::enforceRetention(const std::string& fileName, uint64_t budget) {
+  auto files = findRotatedFiles(fileName);
+  std::vector<uint64_t> sizes;
+  uint64_t total = 0;
+  for(auto& file : files) {
+    struct stat st;
+    sizes.push_back(stat(file.c_str(), &st) == 0 ? st.st_size : 0);
+    total += sizes.back();
+  }
+  for(size_t i = 0; i < files.size() && total > budget; i++) {
+    if(remove(files[i].c_str()) == 0) total -= sizes[i];
+  }
+}
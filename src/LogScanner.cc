@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * LogScanner.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "LogScanner.h"
+
+#include <cstring>
+#include <queue>
+#include <stdexcept>
+
+void LogScanner::setPatterns(const std::vector<std::string>& patterns) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if(patterns == _patterns && !_transitions.empty()) return;
+  if(patterns.size() > maxPatterns) {
+    throw std::runtime_error("Too many log patterns. Maximum is " + std::to_string(maxPatterns) + ".");
+  }
+
+  std::vector<std::pair<size_t, std::regex>> regex;
+  // trie of the literal patterns, -1 marks a missing edge
+  std::vector<int32_t> transitions(256, -1);
+  std::vector<uint32_t> output(1, 0);
+  for(size_t i = 0; i < patterns.size(); ++i) {
+    const auto& pattern = patterns[i];
+    if(pattern.size() > 2 && pattern.front() == '/' && pattern.back() == '/') {
+      try {
+        regex.emplace_back(i, std::regex(pattern.substr(1, pattern.size() - 2), std::regex::optimize));
+      }
+      catch(std::regex_error& e) {
+        throw std::runtime_error("Invalid log pattern " + pattern + ": " + e.what());
+      }
+      continue;
+    }
+    if(pattern.empty()) throw std::runtime_error("Empty log pattern.");
+    int32_t state = 0;
+    for(unsigned char c : pattern) {
+      if(transitions[state * 256 + c] < 0) {
+        transitions[state * 256 + c] = output.size();
+        transitions.resize(transitions.size() + 256, -1);
+        output.push_back(0);
+      }
+      state = transitions[state * 256 + c];
+    }
+    output[state] |= 1u << i;
+  }
+
+  // turn the trie into a complete automaton using breadth first search over the failure links
+  std::vector<int32_t> fail(output.size(), 0);
+  std::queue<int32_t> queue;
+  for(size_t c = 0; c < 256; ++c) {
+    if(transitions[c] < 0) {
+      transitions[c] = 0;
+    }
+    else {
+      queue.push(transitions[c]);
+    }
+  }
+  while(!queue.empty()) {
+    int32_t state = queue.front();
+    queue.pop();
+    output[state] |= output[fail[state]];
+    for(size_t c = 0; c < 256; ++c) {
+      int32_t& next = transitions[state * 256 + c];
+      if(next < 0) {
+        next = transitions[fail[state] * 256 + c];
+      }
+      else {
+        fail[next] = transitions[fail[state] * 256 + c];
+        queue.push(next);
+      }
+    }
+  }
+
+  _patterns = patterns;
+  _transitions.swap(transitions);
+  _output.swap(output);
+  _regex.swap(regex);
+  _state = 0;
+  _lineMatches = 0;
+  _line.clear();
+  _counts.assign(patterns.size(), 0);
+}
+
+void LogScanner::add(const char* data, size_t size) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if(_patterns.empty()) return;
+  const char* end = data + size;
+  while(data < end) {
+    auto newline = static_cast<const char*>(memchr(data, '\n', end - data));
+    const char* lineEnd = newline ? newline : end;
+    for(const char* c = data; c < lineEnd; ++c) {
+      _state = _transitions[_state * 256 + static_cast<unsigned char>(*c)];
+      _lineMatches |= _output[_state];
+    }
+    if(!_regex.empty()) _line.append(data, std::min<size_t>(lineEnd - data, maxLineLength - _line.size()));
+    if(newline == nullptr) break;
+    endLine();
+    data = newline + 1;
+  }
+}
+
+void LogScanner::endLine() {
+  for(auto& r : _regex) {
+    if(std::regex_search(_line, r.second)) _lineMatches |= 1u << r.first;
+  }
+  for(uint32_t matches = _lineMatches; matches != 0; matches &= matches - 1) {
+    ++_counts[__builtin_ctz(matches)];
+  }
+  _state = 0;
+  _lineMatches = 0;
+  _line.clear();
+}
+
+std::vector<uint64_t> LogScanner::getCounts() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _counts;
+}
@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * LogTail.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "LogTail.h"
+
+#include "Logging.h"
+
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <utility>
+
+LogTail::~LogTail() {
+  close();
+}
+
+LogTail::LogTail(LogTail&& other) noexcept {
+  *this = std::move(other);
+}
+
+LogTail& LogTail::operator=(LogTail&& other) noexcept {
+  if(this == &other) return *this;
+  close();
+  _fileName = std::move(other._fileName);
+  _tailLength = other._tailLength;
+  _fd = other._fd;
+  _reactor = std::move(other._reactor);
+  _watch = std::move(other._watch);
+  _offset = other._offset;
+  _device = other._device;
+  _inode = other._inode;
+  _lines = std::move(other._lines);
+  _tail = std::move(other._tail);
+  _scanner = std::move(other._scanner);
+  _opened = other._opened;
+  other._fd = -1;
+  other._watch.reset();
+  return *this;
+}
+
+bool LogTail::update(const std::string& fileName, size_t tailLength) {
+  if(tailLength < 1) {
+    close();
+    _fileName.clear();
+    return setMessage("Tail length is <1. No messages from the log file read.\n");
+  }
+  if(fileName.empty()) {
+    close();
+    _fileName.clear();
+    return setMessage("No log file is set. Try starting the process and setting a LogFile.\n");
+  }
+  if(fileName != _fileName || tailLength != _tailLength) {
+    close();
+    _opened = false;
+    _fileName = fileName;
+    _tailLength = tailLength;
+    _lines.setCapacity(tailLength);
+  }
+
+  bool changed = false;
+  if(_fd >= 0) {
+    bool modified = false;
+    if(checkReopen(modified)) {
+      close();
+    }
+    else if(modified) {
+      changed = readAppended();
+    }
+  }
+  if(_fd < 0) {
+    if(!open()) {
+      return setMessage("Can not open file: " + _fileName + "\n");
+    }
+    changed = true;
+  }
+  if(changed) _tail = _lines.format();
+  return changed;
+}
+
+bool LogTail::open() {
+  _fd = ::open(_fileName.c_str(), O_RDONLY | O_CLOEXEC);
+  if(_fd < 0) return false;
+  struct stat st;
+  // a replaced file is read completely, since all of its content is new for the scanner
+  bool scan = _opened && _scanner != nullptr;
+  if(fstat(_fd, &st) == 0) {
+    _device = st.st_dev;
+    _inode = st.st_ino;
+    // only read the lines needed for the tail
+    if(!scan) _offset = logging::findTailOffset(_fd, st.st_size, _tailLength);
+  }
+  if(_reactor == nullptr) _reactor = LogWatchReactor::get();
+  if(_reactor != nullptr) _watch = _reactor->watch(_fileName);
+  readAppended(scan);
+  _opened = true;
+  return true;
+}
+
+void LogTail::close() {
+  if(_watch != nullptr) _reactor->unwatch(_watch);
+  _watch.reset();
+  if(_fd >= 0) ::close(_fd);
+  _fd = -1;
+  _offset = 0;
+  _lines.clear();
+}
+
+bool LogTail::checkReopen(bool& modified) {
+  struct stat st;
+  if(_watch == nullptr) {
+    // no inotify -> compare the file found by name with the opened one
+    if(stat(_fileName.c_str(), &st) != 0 || st.st_dev != _device || st.st_ino != _inode) return true;
+    modified = st.st_size != _offset;
+    return false;
+  }
+  unsigned int events = _watch->takeEvents();
+  if(events & LogWatchReactor::Reopen) return true;
+  if(events & LogWatchReactor::Modified) modified = true;
+  // deleting the file only changes the link count as long as it is opened here
+  return (events & LogWatchReactor::Attributes) && fstat(_fd, &st) == 0 && st.st_nlink == 0;
+}
+
+bool LogTail::readAppended(bool scan) {
+  struct stat st;
+  if(fstat(_fd, &st) == 0 && st.st_size < _offset) {
+    // file was truncated -> start from the beginning
+    _offset = 0;
+    _lines.clear();
+  }
+  bool newData = false;
+  char buffer[65536];
+  ssize_t n;
+  while((n = pread(_fd, buffer, sizeof(buffer), _offset)) > 0) {
+    _lines.add(buffer, n);
+    if(scan && _scanner != nullptr) _scanner->add(buffer, n);
+    _offset += n;
+    newData = true;
+  }
+  return newData;
+}
+
+bool LogTail::setMessage(const std::string& message) {
+  if(_tail == message) return false;
+  _tail = message;
+  return true;
+}
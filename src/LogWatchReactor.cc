@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * LogWatchReactor.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "LogWatchReactor.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+
+std::shared_ptr<LogWatchReactor> LogWatchReactor::get() {
+  static std::mutex mutex;
+  static std::weak_ptr<LogWatchReactor> instance;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto reactor = instance.lock();
+  if(reactor) return reactor;
+
+  int inotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  int epollFD = epoll_create1(EPOLL_CLOEXEC);
+  int stopFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if(inotifyFD < 0 || epollFD < 0 || stopFD < 0) {
+    if(inotifyFD >= 0) close(inotifyFD);
+    if(epollFD >= 0) close(epollFD);
+    if(stopFD >= 0) close(stopFD);
+    return nullptr;
+  }
+  struct epoll_event event {};
+  event.events = EPOLLIN;
+  event.data.fd = inotifyFD;
+  epoll_ctl(epollFD, EPOLL_CTL_ADD, inotifyFD, &event);
+  event.data.fd = stopFD;
+  epoll_ctl(epollFD, EPOLL_CTL_ADD, stopFD, &event);
+  reactor.reset(new LogWatchReactor(inotifyFD, epollFD, stopFD));
+  instance = reactor;
+  return reactor;
+}
+
+LogWatchReactor::LogWatchReactor(int inotifyFD, int epollFD, int stopFD)
+: _inotifyFD(inotifyFD), _epollFD(epollFD), _stopFD(stopFD) {
+  _thread = std::thread(&LogWatchReactor::run, this);
+}
+
+LogWatchReactor::~LogWatchReactor() {
+  if(std::this_thread::get_id() == _thread.get_id()) {
+    // A reader dropped the last reference, so the thread cannot be joined. It returns once the reader is done.
+    *_destroyed = true;
+    _thread.detach();
+  }
+  else {
+    uint64_t stop = 1;
+    if(write(_stopFD, &stop, sizeof(stop)) < 0) {
+      // the thread is still joined, it will only stop once it wakes up again
+    }
+    _thread.join();
+  }
+  close(_stopFD);
+  close(_epollFD);
+  close(_inotifyFD);
+}
+
+std::shared_ptr<LogWatchReactor::Watch> LogWatchReactor::watch(const std::string& fileName) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  // If the same file is watched multiple times the same watch descriptor is returned.
+  int wd = inotify_add_watch(_inotifyFD, fileName.c_str(), IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+  if(wd < 0) return nullptr;
+  auto watch = std::make_shared<Watch>();
+  watch->wd = wd;
+  _watches[wd].push_back(watch);
+  return watch;
+}
+
+void LogWatchReactor::unwatch(const std::shared_ptr<Watch>& watch) {
+  if(!watch) return;
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto it = _watches.find(watch->wd);
+  if(it == _watches.end()) return;
+  auto& list = it->second;
+  list.erase(std::remove_if(list.begin(), list.end(),
+                 [&](const std::weak_ptr<Watch>& w) { return w.expired() || w.lock() == watch; }),
+      list.end());
+  if(list.empty()) {
+    inotify_rm_watch(_inotifyFD, watch->wd);
+    _watches.erase(it);
+  }
+}
+
+bool LogWatchReactor::addReader(int fd, std::function<bool()> onReadable) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  struct epoll_event event {};
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  if(epoll_ctl(_epollFD, EPOLL_CTL_ADD, fd, &event) != 0) return false;
+  _readers[fd] = std::move(onReadable);
+  return true;
+}
+
+void LogWatchReactor::removeReader(int fd) {
+  std::function<bool()> reader;
+  std::unique_lock<std::mutex> lock(_mutex);
+  auto it = _readers.find(fd);
+  if(it != _readers.end()) {
+    reader = std::move(it->second);
+    _readers.erase(it);
+    epoll_ctl(_epollFD, EPOLL_CTL_DEL, fd, nullptr);
+  }
+  // Wait for a running call of the reader, unless it is the reader itself removing the file descriptor.
+  if(std::this_thread::get_id() != _thread.get_id()) {
+    _readerDone.wait(lock, [&] { return _activeReader != fd; });
+  }
+  lock.unlock();
+  // the reader is destroyed without holding the lock, since it might own objects removing their readers
+}
+
+void LogWatchReactor::run() {
+  bool destroyed = false;
+  _destroyed = &destroyed;
+  struct epoll_event events[16];
+  while(true) {
+    int n = epoll_wait(_epollFD, events, 16, -1);
+    if(n < 0) {
+      if(errno == EINTR) continue;
+      return;
+    }
+    for(int i = 0; i < n; i++) {
+      int fd = events[i].data.fd;
+      if(fd == _stopFD) return;
+      if(fd == _inotifyFD) {
+        dispatch();
+        continue;
+      }
+      if(!callReader(fd, destroyed)) return;
+    }
+  }
+}
+
+bool LogWatchReactor::callReader(int fd, const bool& destroyed) {
+  {
+    // The reader is called without holding the lock: it might drop the last reference to its owner, which then
+    // removes the reader from within the call.
+    std::function<bool()> reader;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto it = _readers.find(fd);
+      if(it == _readers.end()) return true;
+      reader = it->second;
+      _activeReader = fd;
+    }
+    bool keep = reader();
+    if(destroyed) return false;
+    std::function<bool()> removed;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _activeReader = -1;
+      auto it = _readers.find(fd);
+      if(!keep && it != _readers.end()) {
+        removed = std::move(it->second);
+        _readers.erase(it);
+        epoll_ctl(_epollFD, EPOLL_CTL_DEL, fd, nullptr);
+      }
+    }
+    _readerDone.notify_all();
+  }
+  // Releasing the copies above might have destroyed the reactor.
+  return !destroyed;
+}
+
+void LogWatchReactor::dispatch() {
+  alignas(struct inotify_event) char buffer[4096];
+  ssize_t n;
+  while((n = read(_inotifyFD, buffer, sizeof(buffer))) > 0) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for(char* ptr = buffer; ptr < buffer + n;) {
+      auto event = reinterpret_cast<struct inotify_event*>(ptr);
+      ptr += sizeof(struct inotify_event) + event->len;
+      auto it = _watches.find(event->wd);
+      if(it == _watches.end()) continue;
+      unsigned int flags = 0;
+      if(event->mask & IN_MODIFY) flags |= Modified;
+      if(event->mask & IN_ATTRIB) flags |= Attributes;
+      if(event->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED)) flags |= Reopen;
+      for(auto& w : it->second) {
+        if(auto watch = w.lock()) watch->events.fetch_or(flags);
+      }
+      // the kernel removed the watch, e.g. because the file was deleted
+      if(event->mask & IN_IGNORED) _watches.erase(it);
+    }
+  }
+}
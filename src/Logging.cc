@@ -11,7 +11,13 @@
 
 #include "boost/date_time/posix_time/posix_time.hpp"
 
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 
 namespace logging {
@@ -62,40 +68,52 @@ namespace logging {
     }
   }
 
-  std::vector<Message> stripMessages(std::stringstream& msg, const size_t maxCharacters) {
-    std::vector<Message> messages;
-    char* s = new char[maxCharacters];
-    while(msg.good()) {
-      Message singleMsg;
-      msg.getline(s, maxCharacters);
-      if(std::string(s).empty()) continue;
-      if(msg.eof()) {
-        break;
-      }
-      if(msg.fail()) {
-        singleMsg.message << s << "|\n The above line was cut by logger!" << std::endl;
-      }
-      else {
-        singleMsg.message << s;
-      }
-
-      std::vector<LogLevel> levelNames = {LogLevel::INFO, LogLevel::WARNING, LogLevel::ERROR, LogLevel::DEBUG};
-      for(auto it = levelNames.begin(); it != levelNames.end(); ++it) {
-        std::stringstream ss;
-        ss << (*it);
-        size_t pos = singleMsg.message.str().find(ss.str());
-        if(pos != std::string::npos) {
-          singleMsg.logLevel = (*it);
-          singleMsg.message.str(
-              singleMsg.message.str().substr(pos + ss.str().length() - 1, singleMsg.message.str().length()));
-          break;
-        }
+  off_t findTailOffset(int fd, off_t fileSize, size_t numberOfLines, size_t blockSize) {
+    if(numberOfLines == 0) return fileSize;
+    std::vector<char> buffer(blockSize);
+    size_t line = 0;
+    // skip the last byte -> a trailing newline does not start a new line
+    off_t end = fileSize - 1;
+    while(end > 0) {
+      off_t start = std::max(end - (off_t)blockSize, (off_t)0);
+      size_t size = end - start;
+      ssize_t n = pread(fd, buffer.data(), size, start);
+      if(n != (ssize_t)size) return 0;
+      const char* data = buffer.data();
+      while(size > 0) {
+        auto newline = static_cast<const char*>(memrchr(data, '\n', size));
+        if(newline == nullptr) break;
+        size = newline - data;
+        if(++line == numberOfLines) return start + size + 1;
       }
+      end = start;
+    }
+    return 0;
+  }
 
-      messages.push_back(std::move(singleMsg));
+  bool readLogTail(const std::string& fileName, std::ostream& os, size_t numberOfLines) {
+    int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0) return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+      close(fd);
+      return false;
+    }
+    off_t offset = findTailOffset(fd, st.st_size, numberOfLines);
+    std::string data(st.st_size - offset, '\0');
+    ssize_t n = data.empty() ? 0 : pread(fd, &data[0], data.size(), offset);
+    close(fd);
+    if(n < 0) return false;
+    data.resize(n);
+    size_t pos = 0;
+    for(size_t i = 0; i < numberOfLines && pos < data.size(); i++) {
+      size_t newline = data.find('\n', pos);
+      if(newline == std::string::npos) newline = data.size();
+      os.write(data.data() + pos, newline - pos);
+      os << std::endl;
+      pos = newline + 1;
     }
-    delete[] s;
-    return messages;
+    return true;
   }
 
   Message::Message(const std::string& msg, const LogLevel& level) : logLevel(level) {
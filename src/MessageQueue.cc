@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * MessageQueue.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "MessageQueue.h"
+
+namespace logging {
+
+  MessageQueue::MessageQueue(size_t capacity) {
+    size_t size = 1;
+    while(size < capacity) size <<= 1;
+    _slots.resize(size);
+    _mask = size - 1;
+  }
+
+  bool MessageQueue::push(LogLevel level, std::string text) {
+    size_t head = _head.load(std::memory_order_relaxed);
+    if(head - _tail.load(std::memory_order_acquire) > _mask) {
+      _dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    Record& slot = _slots[head & _mask];
+    slot.level = level;
+    slot.text.swap(text);
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool MessageQueue::pop(Record& record) {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    if(tail == _head.load(std::memory_order_acquire)) return false;
+    Record& slot = _slots[tail & _mask];
+    record.level = slot.level;
+    // swap to hand the buffer of record to the slot
+    record.text.swap(slot.text);
+    slot.text.clear();
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+} // namespace logging
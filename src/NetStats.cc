@@ -0,0 +1,428 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * NetStats.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "NetStats.h"
+
+#include "ProcFile.h"
+
+#include <fcntl.h>
+#include <linux/if_link.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+  /** Fields of a line of /proc/net/dev following the interface name, in the order of the file */
+  constexpr uint64_t NetStats::Counters::*fields[] = {&NetStats::Counters::rxBytes, &NetStats::Counters::rxPackets,
+      &NetStats::Counters::rxErrors, &NetStats::Counters::rxDropped, &NetStats::Counters::rxFifo,
+      &NetStats::Counters::rxFrame, &NetStats::Counters::rxCompressed, &NetStats::Counters::multicast,
+      &NetStats::Counters::txBytes, &NetStats::Counters::txPackets, &NetStats::Counters::txErrors,
+      &NetStats::Counters::txDropped, &NetStats::Counters::txFifo, &NetStats::Counters::collisions,
+      &NetStats::Counters::txCarrier, &NetStats::Counters::txCompressed};
+
+  /** \return Counters taken from the statistics of a link message. */
+  NetStats::Counters toCounters(const rtnl_link_stats64& stats) {
+    NetStats::Counters counters;
+    counters.rxBytes = stats.rx_bytes;
+    counters.rxPackets = stats.rx_packets;
+    counters.rxErrors = stats.rx_errors;
+    counters.rxDropped = stats.rx_dropped;
+    counters.rxFifo = stats.rx_fifo_errors;
+    counters.rxFrame = stats.rx_frame_errors;
+    counters.rxCompressed = stats.rx_compressed;
+    counters.multicast = stats.multicast;
+    counters.txBytes = stats.tx_bytes;
+    counters.txPackets = stats.tx_packets;
+    counters.txErrors = stats.tx_errors;
+    counters.txDropped = stats.tx_dropped;
+    counters.txFifo = stats.tx_fifo_errors;
+    counters.collisions = stats.collisions;
+    counters.txCarrier = stats.tx_carrier_errors;
+    counters.txCompressed = stats.tx_compressed;
+    counters.rxMissed = stats.rx_missed_errors;
+    counters.rxOver = stats.rx_over_errors;
+    return counters;
+  }
+
+  /**
+   * Call function(type, index, name, stats) for all RTM_NEWLINK and RTM_DELLINK messages in a netlink datagram. stats
+   * is nullptr if the message does not contain statistics.
+   * \param sequence Messages with another sequence number are skipped, 0 to use all messages.
+   * \return -1 if an error message was found, 1 if the end of a dump was found, 0 otherwise.
+   */
+  template<class Function>
+  int forEachLink(const char* data, size_t size, uint32_t sequence, Function function) {
+    int length = static_cast<int>(size);
+    for(auto header = reinterpret_cast<const nlmsghdr*>(data); NLMSG_OK(header, length);
+        header = NLMSG_NEXT(header, length)) {
+      if(sequence != 0 && header->nlmsg_seq != sequence) continue;
+      if(header->nlmsg_type == NLMSG_DONE) return 1;
+      if(header->nlmsg_type == NLMSG_ERROR) return -1;
+      if(header->nlmsg_type != RTM_NEWLINK && header->nlmsg_type != RTM_DELLINK) continue;
+      if(header->nlmsg_len < NLMSG_LENGTH(sizeof(ifinfomsg))) continue;
+      auto info = static_cast<const ifinfomsg*>(NLMSG_DATA(header));
+      std::string_view name;
+      rtnl_link_stats64 stats{};
+      bool hasStats = false;
+      int attributesLength = IFLA_PAYLOAD(header);
+      for(auto attribute = IFLA_RTA(info); RTA_OK(attribute, attributesLength);
+          attribute = RTA_NEXT(attribute, attributesLength)) {
+        auto payload = static_cast<const char*>(RTA_DATA(attribute));
+        if(attribute->rta_type == IFLA_IFNAME) {
+          name = std::string_view(payload, strnlen(payload, RTA_PAYLOAD(attribute)));
+        }
+        else if(attribute->rta_type == IFLA_STATS64) {
+          // attributes are only 4 byte aligned, older kernels provide less counters
+          std::memcpy(&stats, payload, std::min<size_t>(RTA_PAYLOAD(attribute), sizeof(stats)));
+          hasStats = true;
+        }
+      }
+      function(header->nlmsg_type, info->ifi_index, name, hasStats ? &stats : nullptr);
+    }
+    return 0;
+  }
+
+  /**
+   * \return True if both refer to the same interface. Interfaces are compared by index if both indices are known,
+   * otherwise by name.
+   */
+  bool sameInterface(int index1, std::string_view name1, int index2, std::string_view name2) {
+    return index1 != 0 && index2 != 0 ? index1 == index2 : name1 == name2;
+  }
+
+  /** \return Opened netlink route socket or -1. */
+  int openNetlink(uint32_t groups, int flags) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | flags, NETLINK_ROUTE);
+    if(fd < 0) return -1;
+    sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = groups;
+    if(bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+      ::close(fd);
+      return -1;
+    }
+    return fd;
+  }
+} // namespace
+
+NetStats::NetStats(const std::string& procPath, const std::string& sysPath)
+: _fileName(procPath + "/net/dev"), _sysPath(sysPath), _buffer(8 * 1024, '\0') {
+  _fd = ::open(_fileName.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+NetStats::~NetStats() {
+  for(int fd : {_fd, _dumpSocket, _notificationSocket}) {
+    if(fd >= 0) ::close(fd);
+  }
+}
+
+bool NetStats::useNetlink() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if(_dumpSocket >= 0) return true;
+  _dumpSocket = openNetlink(0, 0);
+  if(_dumpSocket < 0) {
+    _error = std::string("netlink: can not be opened: ") + std::strerror(errno);
+    return false;
+  }
+  // do not wait forever for an incomplete dump
+  timeval timeout{1, 0};
+  setsockopt(_dumpSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  // a dump message contains all interfaces fitting into a page, the buffer must not truncate it
+  if(_buffer.size() < 64 * 1024) _buffer.resize(64 * 1024);
+  _valid = false;
+  return true;
+}
+
+void NetStats::setSlots(const std::vector<std::string>& interfaces, size_t nSlots) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _slots.assign(std::max(nSlots, interfaces.size()), Slot{});
+  _waiting.clear();
+  for(size_t i = 0; i < interfaces.size(); ++i) _slots[i].name = interfaces[i];
+}
+
+bool NetStats::watchLinks() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if(_notificationSocket >= 0) return true;
+  _notificationSocket = openNetlink(RTMGRP_LINK, SOCK_NONBLOCK);
+  if(_notificationSocket < 0) {
+    _error = std::string("netlink: can not subscribe to link notifications: ") + std::strerror(errno);
+    return false;
+  }
+  // interfaces might have changed since the slots were set
+  _lostNotifications = true;
+  return true;
+}
+
+bool NetStats::update(uint64_t tick) {
+  // modules lagging behind use the newer snapshot instead of reading the interfaces again
+  if(!_valid || tick > _tick) {
+    _tick = tick;
+    _valid = read();
+  }
+  return _valid;
+}
+
+bool NetStats::get(uint64_t tick, const std::string& interface, Sample& sample) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if(!update(tick)) return false;
+  for(size_t i = 0; i < _nInterfaces; ++i) {
+    if(_interfaces[i].name != interface) continue;
+    sample.counters = _interfaces[i].counters;
+    sample.time = _time;
+    sample.interface = interface;
+    sample.generation = 0;
+    return true;
+  }
+  _error = "interface " + interface + " not found";
+  return false;
+}
+
+bool NetStats::get(uint64_t tick, size_t slot, Sample& sample) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if(!update(tick)) return false;
+  if(slot >= _slots.size()) {
+    _error = "slot " + std::to_string(slot) + " does not exist";
+    return false;
+  }
+  auto& assigned = _slots[slot];
+  sample.interface = assigned.name;
+  sample.generation = assigned.generation;
+  sample.time = _time;
+  sample.counters = Counters{};
+  if(assigned.name.empty()) return true;
+  for(size_t i = 0; i < _nInterfaces; ++i) {
+    auto& interface = _interfaces[i];
+    if(!sameInterface(interface.index, interface.name, assigned.index, assigned.name)) continue;
+    sample.counters = interface.counters;
+    return true;
+  }
+  _error = "interface " + assigned.name + " not found";
+  return false;
+}
+
+std::vector<std::string> NetStats::getInterfaces() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::vector<std::string> names;
+  for(size_t i = 0; i < _nInterfaces; ++i) names.push_back(_interfaces[i].name);
+  return names;
+}
+
+size_t NetStats::getNReads() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _nReads;
+}
+
+size_t NetStats::getNWaiting() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _waiting.size();
+}
+
+std::string NetStats::getError() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _error;
+}
+
+bool NetStats::handleNotifications(const char* data, size_t size) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return applyNotifications(data, size);
+}
+
+bool NetStats::applyNotifications(const char* data, size_t size) {
+  auto result = forEachLink(data, size, 0, [&](uint16_t type, int index, std::string_view name, auto) {
+    if(type == RTM_NEWLINK) linkAdded(index, name);
+    else linkRemoved(index, name);
+  });
+  if(result < 0) _error = "netlink: error message received";
+  return result >= 0;
+}
+
+bool NetStats::read() {
+  _nInterfaces = 0;
+  if(!(_dumpSocket >= 0 ? readNetlink() : readFile())) return false;
+  _time = std::chrono::steady_clock::now();
+  ++_nReads;
+
+  if(_notificationSocket >= 0) receiveNotifications();
+  if(_lostNotifications) resync();
+  // interfaces set by setSlots() get their index from the first snapshot
+  for(auto& slot : _slots) {
+    if(slot.index != 0 || slot.name.empty()) continue;
+    for(size_t i = 0; i < _nInterfaces; ++i) {
+      if(_interfaces[i].name == slot.name) slot.index = _interfaces[i].index;
+    }
+  }
+  return true;
+}
+
+NetStats::Interface& NetStats::nextInterface() {
+  // elements are reused, so the names only allocate when interfaces are added
+  if(_nInterfaces == _interfaces.size()) _interfaces.emplace_back();
+  return _interfaces[_nInterfaces++];
+}
+
+bool NetStats::readFile() {
+  if(_fd < 0) {
+    _error = _fileName + ": can not be opened";
+    return false;
+  }
+  auto data = procfs::readFile(_fd, _buffer);
+  if(data.empty()) {
+    _error = _fileName + ": can not be read";
+    return false;
+  }
+
+  // two header lines
+  procfs::nextLine(data);
+  procfs::nextLine(data);
+  while(!data.empty()) {
+    auto line = procfs::nextLine(data);
+    auto colon = line.find(':');
+    if(colon == std::string_view::npos) continue;
+    auto nameField = line.substr(0, colon);
+    auto name = procfs::nextWord(nameField);
+    line.remove_prefix(colon + 1);
+    Counters counters;
+    for(auto field : fields) {
+      auto word = procfs::nextWord(line);
+      if(std::from_chars(word.data(), word.data() + word.size(), counters.*field).ec != std::errc()) {
+        _error = _fileName + ": invalid line for " + std::string(name);
+        return false;
+      }
+    }
+    auto& interface = nextInterface();
+    interface.name.assign(name.data(), name.size());
+    interface.index = 0;
+    interface.counters = counters;
+  }
+  return true;
+}
+
+bool NetStats::readNetlink() {
+  struct {
+    nlmsghdr header;
+    ifinfomsg message;
+  } request{};
+  request.header.nlmsg_len = sizeof(request);
+  request.header.nlmsg_type = RTM_GETLINK;
+  request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  request.header.nlmsg_seq = ++_sequence;
+  request.message.ifi_family = AF_UNSPEC;
+  if(send(_dumpSocket, &request, sizeof(request), 0) < 0) {
+    _error = std::string("netlink: can not send request: ") + std::strerror(errno);
+    return false;
+  }
+  while(true) {
+    ssize_t n = recv(_dumpSocket, _buffer.data(), _buffer.size(), 0);
+    if(n < 0 && errno == EINTR) continue;
+    if(n <= 0) {
+      _error = std::string("netlink: can not receive: ") + std::strerror(errno);
+      return false;
+    }
+    auto result = forEachLink(_buffer.data(), n, _sequence,
+        [&](uint16_t type, int index, std::string_view name, const rtnl_link_stats64* stats) {
+          if(type != RTM_NEWLINK) return;
+          auto& interface = nextInterface();
+          interface.name.assign(name.data(), name.size());
+          interface.index = index;
+          interface.counters = stats ? toCounters(*stats) : Counters{};
+        });
+    if(result < 0) {
+      _error = "netlink: error message received";
+      return false;
+    }
+    if(result > 0) return true;
+  }
+}
+
+void NetStats::receiveNotifications() {
+  while(true) {
+    ssize_t n = recv(_notificationSocket, _buffer.data(), _buffer.size(), MSG_DONTWAIT);
+    if(n < 0 && errno == EINTR) continue;
+    // the socket buffer overflowed, notifications are lost
+    if(n < 0 && errno == ENOBUFS) {
+      _lostNotifications = true;
+      continue;
+    }
+    if(n <= 0) return;
+    applyNotifications(_buffer.data(), n);
+  }
+}
+
+void NetStats::resync() {
+  _lostNotifications = false;
+  auto present = [&](const Slot& slot) {
+    for(size_t i = 0; i < _nInterfaces; ++i) {
+      auto& interface = _interfaces[i];
+      if(sameInterface(interface.index, interface.name, slot.index, slot.name)) return true;
+    }
+    return false;
+  };
+  _waiting.erase(std::remove_if(_waiting.begin(), _waiting.end(), [&](const Slot& s) { return !present(s); }),
+      _waiting.end());
+  for(auto& slot : _slots) {
+    if(!slot.name.empty() && !present(slot)) linkRemoved(slot.index, slot.name);
+  }
+  for(size_t i = 0; i < _nInterfaces; ++i) linkAdded(_interfaces[i].index, _interfaces[i].name);
+}
+
+void NetStats::linkAdded(int index, std::string_view name) {
+  if(name.empty()) return;
+  // known interface, it might have been renamed
+  for(auto* list : {&_slots, &_waiting}) {
+    for(auto& slot : *list) {
+      if(slot.name.empty() || !sameInterface(slot.index, slot.name, index, name)) continue;
+      if(slot.index == 0) slot.index = index;
+      if(slot.name != name) slot.name.assign(name.data(), name.size());
+      return;
+    }
+  }
+  if(!accept(name)) return;
+  for(auto& slot : _slots) {
+    if(!slot.name.empty()) continue;
+    slot.name.assign(name.data(), name.size());
+    slot.index = index;
+    slot.generation++;
+    return;
+  }
+  _waiting.push_back(Slot{std::string(name), index, 0});
+}
+
+void NetStats::linkRemoved(int index, std::string_view name) {
+  auto matches = [&](const Slot& slot) {
+    return !slot.name.empty() && sameInterface(slot.index, slot.name, index, name);
+  };
+  _waiting.erase(std::remove_if(_waiting.begin(), _waiting.end(), matches), _waiting.end());
+  for(auto& slot : _slots) {
+    if(!matches(slot)) continue;
+    slot.name.clear();
+    slot.index = 0;
+    slot.generation++;
+    // the first waiting interface takes the free slot
+    if(!_waiting.empty()) {
+      slot.name = std::move(_waiting.front().name);
+      slot.index = _waiting.front().index;
+      _waiting.erase(_waiting.begin());
+    }
+  }
+}
+
+bool NetStats::accept(std::string_view name) {
+  std::string path = _sysPath + "/class/net/" + std::string(name);
+  char resolved[PATH_MAX];
+  if(!realpath(path.c_str(), resolved)) return false;
+  return std::string_view(resolved).find("/virtual/") == std::string_view::npos;
+}
@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * NumaMemory.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "NumaMemory.h"
+
+#include "CpuTopology.h"
+#include "ProcFile.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <iterator>
+
+namespace {
+  /** Fields of the node meminfo file that are used, the lines are prefixed with "Node N " */
+  const std::pair<std::string_view, uint64_t NumaMemory::Node::*> meminfoFields[] = {
+      {"MemTotal", &NumaMemory::Node::total}, {"MemFree", &NumaMemory::Node::free},
+      {"MemUsed", &NumaMemory::Node::used}};
+
+  /** Fields of the numastat file */
+  const std::pair<std::string_view, uint64_t NumaMemory::Node::*> numastatFields[] = {
+      {"numa_hit", &NumaMemory::Node::numaHit}, {"numa_miss", &NumaMemory::Node::numaMiss},
+      {"numa_foreign", &NumaMemory::Node::numaForeign}, {"interleave_hit", &NumaMemory::Node::interleaveHit},
+      {"local_node", &NumaMemory::Node::localNode}, {"other_node", &NumaMemory::Node::otherNode}};
+} // namespace
+
+NumaMemory::NumaMemory(const std::string& sysPath)
+: _nodePath(sysPath + "/devices/system/node/node"), _ids(CpuTopology::listNodes(sysPath)), _buffer(16 * 1024, '\0') {
+  for(auto& id : _ids) {
+    _meminfo.push_back(::open((_nodePath + id + "/meminfo").c_str(), O_RDONLY | O_CLOEXEC));
+    _numastat.push_back(::open((_nodePath + id + "/numastat").c_str(), O_RDONLY | O_CLOEXEC));
+  }
+  _nodes.resize(_ids.size());
+}
+
+NumaMemory::~NumaMemory() {
+  close();
+}
+
+NumaMemory::NumaMemory(NumaMemory&& other) noexcept {
+  *this = std::move(other);
+}
+
+NumaMemory& NumaMemory::operator=(NumaMemory&& other) noexcept {
+  if(this == &other) return *this;
+  close();
+  _nodePath = std::move(other._nodePath);
+  _ids = std::move(other._ids);
+  _meminfo = std::move(other._meminfo);
+  _numastat = std::move(other._numastat);
+  _buffer = std::move(other._buffer);
+  _nodes = std::move(other._nodes);
+  _error = std::move(other._error);
+  other._meminfo.clear();
+  other._numastat.clear();
+  return *this;
+}
+
+void NumaMemory::close() {
+  for(auto fds : {&_meminfo, &_numastat}) {
+    for(auto& fd : *fds) {
+      if(fd >= 0) ::close(fd);
+      fd = -1;
+    }
+  }
+}
+
+bool NumaMemory::update() {
+  // parse all files even if one fails
+  bool ok = true;
+  for(size_t i = 0; i < _nodes.size(); ++i) {
+    auto data = procfs::readFile(_meminfo[i], _buffer);
+    if(data.empty()) ok = fail(i, "meminfo", "can not be read");
+    else if(!parseMeminfo(data, _nodes[i])) ok = fail(i, "meminfo", "missing fields");
+    data = procfs::readFile(_numastat[i], _buffer);
+    if(data.empty()) ok = fail(i, "numastat", "can not be read");
+    else if(!parseNumastat(data, _nodes[i])) ok = fail(i, "numastat", "missing fields");
+  }
+  return ok;
+}
+
+bool NumaMemory::fail(size_t node, const char* file, const char* reason) {
+  _error = _nodePath + _ids[node] + "/" + file + ": " + reason;
+  return false;
+}
+
+bool NumaMemory::parseMeminfo(std::string_view data, Node& node) {
+  size_t found = 0;
+  while(!data.empty()) {
+    auto line = procfs::nextLine(data);
+    auto colon = line.find(':');
+    if(colon == std::string_view::npos) continue;
+    // the key is the last word before the colon
+    auto key = line.substr(0, colon);
+    key.remove_prefix(key.rfind(' ') + 1);
+    for(auto& field : meminfoFields) {
+      if(field.first != key) continue;
+      auto value = line.substr(colon + 1);
+      if(procfs::parseNumber(value, node.*field.second)) found++;
+      break;
+    }
+  }
+  return found == std::size(meminfoFields);
+}
+
+bool NumaMemory::parseNumastat(std::string_view data, Node& node) {
+  size_t found = 0;
+  while(!data.empty()) {
+    auto line = procfs::nextLine(data);
+    auto space = line.find(' ');
+    if(space == std::string_view::npos) continue;
+    auto key = line.substr(0, space);
+    for(auto& field : numastatFields) {
+      if(field.first != key) continue;
+      auto value = line.substr(space);
+      if(procfs::parseNumber(value, node.*field.second)) found++;
+      break;
+    }
+  }
+  return found == std::size(numastatFields);
+}
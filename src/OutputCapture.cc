@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * OutputCapture.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "OutputCapture.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+OutputCapture::OutputCapture(size_t maxPending) : _reactor(LogWatchReactor::get()), _maxPending(maxPending) {}
+
+OutputCapture::~OutputCapture() {
+  detach();
+  if(_logFD >= 0) close(_logFD);
+}
+
+void OutputCapture::attach(int fd) {
+  detach();
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _fd = fd;
+  }
+  if(_reactor) {
+    std::weak_ptr<OutputCapture> self = shared_from_this();
+    _reactor->addReader(fd, [self]() {
+      auto capture = self.lock();
+      return capture && capture->read();
+    });
+  }
+}
+
+void OutputCapture::detach() {
+  int fd;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    fd = _fd;
+    _fd = -1;
+  }
+  if(fd < 0) return;
+  // must not hold _mutex here, since removeReader() waits for a running read()
+  if(_reactor) _reactor->removeReader(fd);
+  close(fd);
+}
+
+bool OutputCapture::read() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if(_fd < 0) return false;
+  char buffer[65536];
+  ssize_t n;
+  while((n = ::read(_fd, buffer, sizeof(buffer))) > 0) {
+    _lines.add(buffer, n);
+    if(_scanner != nullptr) _scanner->add(buffer, n);
+    _changed = true;
+    if(!_logFileName.empty()) {
+      size_t keep = std::min((size_t)n, _maxPending - std::min(_maxPending, _pending.size()));
+      _pending.append(buffer, keep);
+      _dropped += n - keep;
+    }
+  }
+  return n != 0 && (errno == EAGAIN || errno == EINTR);
+}
+
+void OutputCapture::setTailLength(size_t tailLength) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if(tailLength == _lines.getCapacity()) return;
+  _lines.setCapacity(tailLength);
+  _changed = true;
+}
+
+void OutputCapture::setLogFile(const std::string& fileName) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if(fileName == _logFileName) return;
+  if(_logFD >= 0) close(_logFD);
+  _logFD = -1;
+  _logFileName = fileName;
+  if(_logFileName.empty()) _pending.clear();
+}
+
+void OutputCapture::setScanner(std::shared_ptr<LogScanner> scanner) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _scanner = std::move(scanner);
+}
+
+void OutputCapture::reopenLogFile() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if(_logFD >= 0) close(_logFD);
+  _logFD = -1;
+}
+
+void OutputCapture::flush() {
+  std::string data;
+  int fd;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(_pending.empty() || _logFileName.empty()) return;
+    if(_logFD < 0) {
+      _logFD = open(_logFileName.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+          S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+    }
+    data.swap(_pending);
+    fd = _logFD;
+  }
+  // write without holding the lock, so the reactor can continue reading
+  size_t written = 0;
+  while(fd >= 0 && written < data.size()) {
+    ssize_t n = write(fd, data.data() + written, data.size() - written);
+    if(n < 0) {
+      if(errno == EINTR) continue;
+      break;
+    }
+    written += n;
+  }
+  if(written < data.size()) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _dropped += data.size() - written;
+  }
+}
+
+bool OutputCapture::update(std::string& tail) {
+  if(!_reactor) read();
+  std::lock_guard<std::mutex> lock(_mutex);
+  if(!_changed) return false;
+  tail = _lines.format();
+  _changed = false;
+  return true;
+}
+
+size_t OutputCapture::getDroppedBytes() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _dropped;
+}
@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * Pressure.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "Pressure.h"
+
+#include "ProcFile.h"
+
+#include <sys/eventfd.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+namespace {
+  /** Cut line up to the value of key=value. \return False if the key is not found. */
+  bool findField(std::string_view& line, std::string_view key) {
+    auto pos = line.find(key);
+    if(pos == std::string_view::npos) return false;
+    line.remove_prefix(pos + key.size());
+    return true;
+  }
+
+  /** Parse the value of key=value within line, the averages have two decimal places, e.g. 12.34. */
+  bool parseField(std::string_view line, std::string_view key, double& value) {
+    return findField(line, key) && procfs::parseDecimal(line, value);
+  }
+
+  bool parseField(std::string_view line, std::string_view key, uint64_t& value) {
+    return findField(line, key) && procfs::parseNumber(line, value);
+  }
+
+  bool parseStall(std::string_view line, Pressure::Stall& stall) {
+    return parseField(line, "avg10=", stall.avg10) && parseField(line, "avg60=", stall.avg60) &&
+        parseField(line, "avg300=", stall.avg300) && parseField(line, "total=", stall.total);
+  }
+} // namespace
+
+Pressure::Pressure(const std::string& directory, const std::string& suffix) : _directory(directory), _suffix(suffix) {
+  _fds.fill(-1);
+  _triggerFds.fill(-1);
+  _wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if(_directory.empty()) return;
+  for(size_t i = 0; i < N_RESOURCES; ++i) {
+    _fds[i] = ::open(fileName(Resource(i)).c_str(), O_RDONLY | O_CLOEXEC);
+  }
+}
+
+Pressure::~Pressure() {
+  close();
+}
+
+Pressure::Pressure(Pressure&& other) noexcept {
+  _fds.fill(-1);
+  _triggerFds.fill(-1);
+  *this = std::move(other);
+}
+
+Pressure& Pressure::operator=(Pressure&& other) noexcept {
+  if(this == &other) return *this;
+  close();
+  _directory = std::move(other._directory);
+  _suffix = std::move(other._suffix);
+  _fds = other._fds;
+  _triggerFds = other._triggerFds;
+  _wakeFd = other._wakeFd;
+  _values = other._values;
+  _error = std::move(other._error);
+  other._fds.fill(-1);
+  other._triggerFds.fill(-1);
+  other._wakeFd = -1;
+  return *this;
+}
+
+void Pressure::close() {
+  for(auto fds : {&_fds, &_triggerFds}) {
+    for(auto& fd : *fds) {
+      if(fd >= 0) ::close(fd);
+      fd = -1;
+    }
+  }
+  if(_wakeFd >= 0) ::close(_wakeFd);
+  _wakeFd = -1;
+}
+
+std::string Pressure::fileName(Resource resource) const {
+  return _directory + "/" + names[resource] + _suffix;
+}
+
+bool Pressure::fail(Resource resource, const std::string& reason) {
+  _error = fileName(resource) + ": " + reason;
+  return false;
+}
+
+bool Pressure::update() {
+  // parse all files even if one fails
+  bool ok = true;
+  for(size_t i = 0; i < N_RESOURCES; ++i) {
+    auto resource = Resource(i);
+    if(_fds[i] < 0) {
+      ok = fail(resource, "can not be opened");
+      continue;
+    }
+    auto data = procfs::readFile(_fds[i], _buffer);
+    if(data.empty()) ok = fail(resource, "can not be read");
+    else if(!parse(data, _values[i])) ok = fail(resource, "invalid format");
+  }
+  return ok;
+}
+
+bool Pressure::parse(std::string_view data, Values& values) {
+  bool found = false;
+  while(!data.empty()) {
+    auto line = procfs::nextLine(data);
+    if(line.substr(0, 5) == "some ") {
+      if(!parseStall(line, values.some)) return false;
+      found = true;
+    }
+    // kernels older than 5.13 do not report full for cpu
+    else if(line.substr(0, 5) == "full ") {
+      if(!parseStall(line, values.full)) return false;
+    }
+  }
+  return found;
+}
+
+bool Pressure::addTrigger(Resource resource, bool full, uint64_t threshold, uint64_t window) {
+  if(_triggerFds[resource] >= 0) ::close(_triggerFds[resource]);
+  _triggerFds[resource] = ::open(fileName(resource).c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if(_triggerFds[resource] < 0) return fail(resource, std::string("can not be opened: ") + strerror(errno));
+  // the trigger is bound to the file descriptor and is removed when it is closed
+  std::string trigger = std::string(full ? "full " : "some ") + std::to_string(threshold) + " " +
+      std::to_string(window);
+  if(::write(_triggerFds[resource], trigger.c_str(), trigger.size() + 1) < 0) {
+    auto reason = std::string("trigger not accepted: ") + strerror(errno);
+    ::close(_triggerFds[resource]);
+    _triggerFds[resource] = -1;
+    return fail(resource, reason);
+  }
+  return true;
+}
+
+size_t Pressure::getNTriggers() const {
+  size_t n = 0;
+  for(auto fd : _triggerFds) n += fd >= 0;
+  return n;
+}
+
+unsigned int Pressure::wait(int timeout) {
+  std::array<pollfd, N_RESOURCES + 1> fds;
+  for(size_t i = 0; i < N_RESOURCES; ++i) fds[i] = {_triggerFds[i], POLLPRI, 0};
+  fds[N_RESOURCES] = {_wakeFd, POLLIN, 0};
+  // negative file descriptors are ignored by poll
+  if(poll(fds.data(), fds.size(), timeout) <= 0) return 0;
+  // the eventfd is not read, so it keeps waking up all following calls
+  if(fds[N_RESOURCES].revents & POLLIN) return 0;
+  unsigned int fired = 0;
+  for(size_t i = 0; i < N_RESOURCES; ++i) {
+    if(fds[i].revents & POLLERR) {
+      fail(Resource(i), "trigger removed by the kernel");
+      ::close(_triggerFds[i]);
+      _triggerFds[i] = -1;
+    }
+    else if(fds[i].revents & POLLPRI) {
+      fired |= 1U << i;
+    }
+  }
+  return fired;
+}
+
+void Pressure::interrupt() {
+  uint64_t wake = 1;
+  if(::write(_wakeFd, &wake, sizeof(wake)) < 0) {
+    // only fails if the eventfd could not be created
+  }
+}
+
+std::string Pressure::findCgroup(const std::string& selfCgroup, const std::array<std::string, 2>& cgroupRoots) {
+  std::ifstream in(selfCgroup);
+  std::string line;
+  while(std::getline(in, line)) {
+    // the unified hierarchy is listed as 0::/path
+    if(line.compare(0, 3, "0::") != 0) continue;
+    auto path = line.substr(3);
+    if(path.empty() || path == "/") return "";
+    for(auto& root : cgroupRoots) {
+      if(access((root + path + "/cpu.pressure").c_str(), R_OK) == 0) return root + path;
+    }
+  }
+  return "";
+}
@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * ProcFile.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "ProcFile.h"
+
+#include <unistd.h>
+
+#include <charconv>
+
+namespace procfs {
+
+  std::string_view readFile(int fd, std::string& buffer) {
+    if(fd < 0) return {};
+    if(buffer.empty()) buffer.resize(4096);
+    while(true) {
+      auto n = pread(fd, buffer.data(), buffer.size(), 0);
+      if(n < 0) return {};
+      // a full buffer means the file might be larger
+      if(static_cast<size_t>(n) < buffer.size()) return std::string_view(buffer.data(), n);
+      buffer.resize(buffer.size() * 2);
+    }
+  }
+
+  bool parseNumber(std::string_view& text, uint64_t& value) {
+    while(!text.empty() && text.front() == ' ') text.remove_prefix(1);
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    if(result.ec != std::errc()) return false;
+    text.remove_prefix(result.ptr - text.data());
+    return true;
+  }
+
+  bool parseDecimal(std::string_view& text, double& value) {
+    uint64_t integer;
+    if(!parseNumber(text, integer)) return false;
+    value = integer;
+    if(!text.empty() && text.front() == '.') {
+      text.remove_prefix(1);
+      double scale = 0.1;
+      while(!text.empty() && text.front() >= '0' && text.front() <= '9') {
+        value += (text.front() - '0') * scale;
+        scale *= 0.1;
+        text.remove_prefix(1);
+      }
+    }
+    return true;
+  }
+
+} // namespace procfs
@@ -10,6 +10,7 @@
 
 #include "ProcessHandler.h"
 
+#include "SpawnHelper.h"
 #include "sys_stat.h"
 
 #include <sys/wait.h>
@@ -49,9 +50,9 @@ void ProcessHandler::setupHandler() {
 
 #ifdef WITH_PROCPS
 ProcessHandler::ProcessHandler(const std::string& _PIDFileName, const bool _deletePIDFile, int& _PID,
-    std::ostream& _stream, const std::string& _name)
-: pid(-1), pidFile("/tmp/" + _PIDFileName + ".PID"), deletePIDFile(_deletePIDFile), signum(SIGINT), os(_stream),
-  log(logging::LogLevel::DEBUG), name(_name + "/ProcessHandler: "), connected(true), killTimeout(1) {
+    std::shared_ptr<logging::MessageQueue> _messages, const std::string& _name)
+: messages(std::move(_messages)), pid(-1), pidFile("/tmp/" + _PIDFileName + ".PID"), deletePIDFile(_deletePIDFile),
+  signum(SIGINT), log(logging::LogLevel::DEBUG), name(_name + "/ProcessHandler: "), connected(true), killTimeout(1) {
   _PID = -1;
   if(readTempPID(_PID)) {
     if(proc_util::isProcessRunning(_PID))
@@ -61,16 +62,17 @@ ProcessHandler::ProcessHandler(const std::string& _PIDFileName, const bool _dele
   }
 }
 
-ProcessHandler::ProcessHandler(
-    const std::string& _PIDFileName, const bool _deletePIDFile, std::ostream& _stream, const std::string& _name)
-: pid(-1), pidFile("/tmp/" + _PIDFileName + ".PID"), deletePIDFile(_deletePIDFile), signum(SIGINT), os(_stream),
-  log(logging::LogLevel::DEBUG), name(_name + "/ProcessHandler: "), connected(true), killTimeout(1) {}
+ProcessHandler::ProcessHandler(const std::string& _PIDFileName, const bool _deletePIDFile,
+    std::shared_ptr<logging::MessageQueue> _messages, const std::string& _name)
+: messages(std::move(_messages)), pid(-1), pidFile("/tmp/" + _PIDFileName + ".PID"), deletePIDFile(_deletePIDFile),
+  signum(SIGINT), log(logging::LogLevel::DEBUG), name(_name + "/ProcessHandler: "), connected(true), killTimeout(1) {}
 
 #else
 ProcessHandler::ProcessHandler(const std::string& _PIDFileName, pids_info* _infoptr, const bool _deletePIDFile,
-    int& _PID, std::ostream& _stream, const std::string& _name)
-: pid(-1), pidFile("/tmp/" + _PIDFileName + ".PID"), deletePIDFile(_deletePIDFile), signum(SIGINT), os(_stream),
-  log(logging::LogLevel::DEBUG), name(_name + "/ProcessHandler: "), connected(true), killTimeout(1), infoptr(_infoptr) {
+    int& _PID, std::shared_ptr<logging::MessageQueue> _messages, const std::string& _name)
+: messages(std::move(_messages)), pid(-1), pidFile("/tmp/" + _PIDFileName + ".PID"), deletePIDFile(_deletePIDFile),
+  signum(SIGINT), log(logging::LogLevel::DEBUG), name(_name + "/ProcessHandler: "), connected(true), killTimeout(1),
+  infoptr(_infoptr) {
   _PID = -1;
   if(readTempPID(_PID)) {
     if(isProcessRunningWrapper(_PID))
@@ -81,14 +83,17 @@ ProcessHandler::ProcessHandler(const std::string& _PIDFileName, pids_info* _info
 }
 
 ProcessHandler::ProcessHandler(const std::string& _PIDFileName, pids_info* _infoptr, const bool _deletePIDFile,
-    std::ostream& _stream, const std::string& _name)
-: pid(-1), pidFile("/tmp/" + _PIDFileName + ".PID"), deletePIDFile(_deletePIDFile), signum(SIGINT), os(_stream),
-  log(logging::LogLevel::DEBUG), name(_name + "/ProcessHandler: "), connected(true), killTimeout(1), infoptr(_infoptr) {
-}
+    std::shared_ptr<logging::MessageQueue> _messages, const std::string& _name)
+: messages(std::move(_messages)), pid(-1), pidFile("/tmp/" + _PIDFileName + ".PID"), deletePIDFile(_deletePIDFile),
+  signum(SIGINT), log(logging::LogLevel::DEBUG), name(_name + "/ProcessHandler: "), connected(true), killTimeout(1),
+  infoptr(_infoptr) {}
 #endif
 
 ProcessHandler::~ProcessHandler() {
   if(connected) cleanup();
+  if(outputFD >= 0) close(outputFD);
+  // nobody asks for the exit status any more
+  if(spawnID != 0) spawn::SpawnHelper::forget(spawnID);
 }
 
 bool ProcessHandler::isProcessRunningWrapper(const int& _pid) {
@@ -101,19 +106,15 @@ bool ProcessHandler::isProcessRunningWrapper(const int& _pid) {
 
 void ProcessHandler::cleanup() {
   if(pid > 0 && isProcessRunningWrapper(pid)) {
-    if(log == logging::LogLevel::DEBUG) {
-      os << logging::LogLevel::DEBUG << name << logging::getTime() << "Going to kill (" << signum
-         << ") process in the destructor of ProcessHandler for process: " << pid << std::endl;
-    }
+    send(logging::LogLevel::DEBUG, "Going to kill (" + std::to_string(signum) +
+            ") process in the destructor of ProcessHandler for process: " + std::to_string(pid));
     kill(-pid, signum);
     // allow 1s for terminating the process, else it will be killed
     // \ToDo: Verify that 1s is ok...
     bool running = true;
     if(killTimeout < 1) killTimeout = 1;
-    if(log == logging::LogLevel::DEBUG) {
-      os << logging::LogLevel::DEBUG << name << logging::getTime() << "Waiting for the process to exit (no longer than "
-         << killTimeout << "s)." << std::endl;
-    }
+    send(logging::LogLevel::DEBUG,
+        "Waiting for the process to exit (no longer than " + std::to_string(killTimeout) + "s).");
     for(size_t i = 0; i < killTimeout; i++) {
       sleep(1);
       if(!isProcessRunningWrapper(pid)) {
@@ -123,35 +124,35 @@ void ProcessHandler::cleanup() {
     }
 
     if(running) {
-      if(log == logging::LogLevel::DEBUG) {
-        os << logging::LogLevel::DEBUG << name << logging::getTime()
-           << "Going to kill (SIGKILL) process in the destructor of ProcessHandler for process: " << pid << std::endl;
-      }
+      send(logging::LogLevel::DEBUG,
+          "Going to kill (SIGKILL) process in the destructor of ProcessHandler for process: " + std::to_string(pid));
       kill(-pid, SIGKILL);
       usleep(200000);
       if(isProcessRunningWrapper(pid)) {
-        os << logging::LogLevel::ERROR << name << logging::getTime()
-           << "When cleaning up the ProcessHandler the process " << pid
-           << " could not be stopped. Even using signal SIGKILL!" << std::endl;
+        send(logging::LogLevel::ERROR, "When cleaning up the ProcessHandler the process " + std::to_string(pid) +
+                " could not be stopped. Even using signal SIGKILL!");
       }
       else {
-        os << logging::LogLevel::INFO << name << logging::getTime() << "Ok process was terminated." << std::endl;
+        send(logging::LogLevel::INFO, "Ok process was terminated.");
       }
     }
     else {
-      if(log == logging::LogLevel::DEBUG) {
-        os << logging::LogLevel::DEBUG << name << logging::getTime() << "Process exited normally." << std::endl;
-      }
+      send(logging::LogLevel::DEBUG, "Process exited normally.");
     }
   }
-  else if(pid > 0 && log == logging::LogLevel::DEBUG) {
-    os << logging::LogLevel::DEBUG << name << logging::getTime()
-       << "Destructor called for the handler. Seems like process with PID: " << pid << " died (no attemp to kill it)."
-       << std::endl;
+  else if(pid > 0) {
+    send(logging::LogLevel::DEBUG, "Destructor called for the handler. Seems like process with PID: " +
+            std::to_string(pid) + " died (no attemp to kill it).");
   }
   if(!deletePIDFile) remove(pidFile.c_str());
 }
 
+bool ProcessHandler::sendSignal(int sig) {
+  if(pid <= 0) return false;
+  send(logging::LogLevel::DEBUG, "Sending signal " + std::to_string(sig) + " to process: " + std::to_string(pid));
+  return kill(-pid, sig) == 0;
+}
+
 bool ProcessHandler::isPIDFolderWritable() {
   if(access("/tmp", W_OK) == 0) {
     return true;
@@ -166,12 +167,21 @@ size_t ProcessHandler::startProcess(const std::string& path, const std::string&
   if(path.empty() || cmd.empty()) {
     throw std::runtime_error("Path or command not set before starting a process!");
   }
+  return startProcess(std::make_shared<const ExecSpec>(path, cmd, environment, overwriteENV), logfile);
+}
+
+size_t ProcessHandler::startProcess(
+    std::shared_ptr<const ExecSpec> exec, const std::string& logfile, const bool captureOutput) {
+  if(exec == nullptr || exec->getPath().empty()) {
+    throw std::runtime_error("Path or command not set before starting a process!");
+  }
+  for(auto& envArg : exec->getIgnoredEnv()) {
+    send(logging::LogLevel::ERROR, "Failed to interpret environment string: " + envArg);
+  }
   // process could be stopped even if it was present when the ProcessHandler was constructed.
   if(pid > 0 && isProcessRunningWrapper(pid)) {
-    if(log <= logging::LogLevel::ERROR) {
-      os << logging::LogLevel::ERROR << name << logging::getTime()
-         << "There is still a process running that was not cleaned up! I will do a cleanup now." << std::endl;
-    }
+    send(logging::LogLevel::ERROR,
+        "There is still a process running that was not cleaned up! I will do a cleanup now.");
     cleanup();
   }
 
@@ -180,6 +190,44 @@ size_t ProcessHandler::startProcess(const std::string& path, const std::string&
     ss << "Failed to change to the directory where to create the PID file (/tmp).";
     throw std::runtime_error(ss.str());
   }
+  spawn::Request request;
+  request.exec = exec;
+  request.logfile = logfile;
+  request.pidFile = pidFile;
+  request.name = name;
+  request.logLevel = log;
+  request.captureOutput = captureOutput;
+  if(outputFD >= 0) close(outputFD);
+  outputFD = -1;
+  if(spawnID != 0) spawn::SpawnHelper::forget(spawnID);
+  spawnID = 0;
+
+  std::string error;
+  if(spawn::SpawnHelper::isRunning()) {
+    pid_t p = spawn::SpawnHelper::spawn(request, error, &outputFD, &spawnID);
+    if(p > 0) {
+      // the helper only answers after execve succeeded, so the PID file was written already
+      pid = p;
+      send(logging::LogLevel::DEBUG, "Process started by spawn helper. PID:" + std::to_string(pid));
+      if(deletePIDFile) remove(pidFile.c_str());
+      return pid;
+    }
+    if(spawn::SpawnHelper::isRunning()) {
+      throw std::runtime_error("Process is not started! " + error);
+    }
+  }
+  if(spawn::SpawnHelper::wasStarted()) {
+    // forking the multi-threaded watchdog is not safe, so do not fall back to it once the helper died
+    throw std::runtime_error("Process is not started! The spawn helper is not available any more" +
+        (error.empty() ? std::string() : " (" + error + ")") + ". Restart the watchdog to start processes again.");
+  }
+
+  int outputPipe[2] = {-1, -1};
+  if(captureOutput && pipe2(outputPipe, O_CLOEXEC) != 0) {
+    throw std::runtime_error("Failed to create the pipe used to capture the process output.");
+  }
+  request.outputFD = outputPipe[1];
+
   // empty streams before forking to have empty copies in the child.
   std::cout.clear();
   std::cerr.clear();
@@ -188,107 +236,15 @@ size_t ProcessHandler::startProcess(const std::string& path, const std::string&
 
   pid_t p = fork();
   if(p == 0) {
-    if(logfile.empty()) {
-      if(log <= logging::LogLevel::WARNING)
-        std::cout << logging::LogLevel::WARNING << name << logging::getTime()
-                  << "No log file name is set. Process output is dumped to stout/stderr." << std::endl;
-    }
-    else {
-      // open the logfile
-      int fd =
-          open(logfile.c_str(), O_RDWR | O_CREAT | O_APPEND, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
-      if(fd == -1 && log <= logging::LogLevel::ERROR) {
-        std::cerr << logging::LogLevel::ERROR << name << logging::getTime()
-                  << "Failed to open log file. No logfile will be written." << std::endl;
-      }
-      else {
-        dup2(fd, 1); // make stdout go to file
-        dup2(fd, 2); // make stderr go to file
-        close(fd);
-      }
-    }
-    std::cout << logging::LogLevel::INFO << name << logging::getTime() << "Going to start a new process." << std::endl;
-    // Don't throw in the child since the parent will not catch it
-    pid_t child = (int)getpid();
-    if(setpgid(0, child) && log <= logging::LogLevel::ERROR) {
-      std::cerr << logging::LogLevel::ERROR << name << logging::getTime() << "Failed to reset GPID." << std::endl;
-    }
-    if(log == logging::LogLevel::DEBUG) {
-      std::cout << logging::LogLevel::DEBUG << name << logging::getTime() << "Child running and its PID is: " << child
-                << std::endl;
-    }
-    std::ofstream file;
-    file.open(pidFile);
-    if(!file.is_open()) {
-      file.close();
-      if(log <= logging::LogLevel::ERROR) {
-        std::cerr << logging::LogLevel::ERROR << name << logging::getTime() << "Failed to create PID file: " << pidFile
-                  << std::endl;
-      }
-      _exit(0);
-    }
-    else {
-      file << child;
-      file.close();
-    }
-    std::string path_copy = path;
-    if(path.back() != '/') path_copy.append(std::string("/").c_str());
-    if(chdir(path.c_str())) {
-      if(log <= logging::LogLevel::ERROR) {
-        std::cerr << logging::LogLevel::ERROR << name << logging::getTime() << "Failed to change to directory: " << path
-                  << std::endl;
-      }
-      _exit(0);
-    }
-
-    // prepare arguments
-    const auto args = split_arguments(cmd);
-    char* exec_args[args.size()];
-    int arg_count = 0;
-    if(log == logging::LogLevel::DEBUG) {
-      std::cout << logging::LogLevel::DEBUG << name << logging::getTime()
-                << "Going to call: execve with command:" << (path_copy + args.at(0)).c_str() << std::endl;
-      std::cout << logging::LogLevel::DEBUG << name << logging::getTime() << "Adding arguments: ";
-    }
-
-    for(size_t x = 0; x < args.size(); x++) {
-      exec_args[arg_count++] = strdup(args[x].c_str());
-      if(log == logging::LogLevel::DEBUG) std::cout << exec_args[x] << ", ";
-    }
-    exec_args[arg_count++] = 0; // tell it when to stop!
-    if(log == logging::LogLevel::DEBUG) std::cout << "NULL" << std::endl;
-
-    // prepare environment
-    auto env_args = split_arguments(environment, ",");
-    if(log == logging::LogLevel::DEBUG)
-      std::cout << logging::LogLevel::DEBUG << name << logging::getTime() << "Adding " << env_args.size()
-                << " environment variables." << std::endl;
-    for(auto& env_arg : env_args) {
-      std::size_t sep = env_arg.find_first_of("=");
-      if(sep != std::string::npos) {
-        setenv(env_arg.substr(0, sep).c_str(), env_arg.substr(sep + 1, env_arg.length()).c_str(), overwriteENV);
-        if(log == logging::LogLevel::DEBUG)
-          std::cout << logging::LogLevel::DEBUG << name << logging::getTime() << "Setting environment variable "
-                    << env_arg.substr(0, sep) << ": " << env_arg.substr(sep + 1, env_arg.length()) << std::endl;
-      }
-      else if(log == logging::LogLevel::ERROR) {
-        std::cerr << logging::LogLevel::ERROR << name << logging::getTime()
-                  << "Failed to interpret environment string: " << env_arg << std::endl;
-      }
-    }
-    // environ is a variable declared in unistd.h
-    extern char** environ;
-
-    // close file handles when calling execv -> release the OPC UA port
-    setAllFHCloseOnExec();
-    execve((path_copy + args.at(0)).c_str(), exec_args, environ);
-    _exit(0);
+    if(outputPipe[0] >= 0) close(outputPipe[0]);
+    spawn::execChild(request);
   }
   else {
+    if(outputPipe[1] >= 0) close(outputPipe[1]);
+    outputFD = outputPipe[0];
     sleep(1);
     if(readTempPID(pid)) {
-      if(log == logging::LogLevel::DEBUG)
-        os << logging::LogLevel::DEBUG << name << logging::getTime() << "PID was read:" << pid << std::endl;
+      send(logging::LogLevel::DEBUG, "PID was read:" + std::to_string(pid));
       if(deletePIDFile) remove(pidFile.c_str());
     }
     else {
@@ -347,6 +303,28 @@ void ProcessHandler::setAllFHCloseOnExec() {
     if(fd != STDIN_FILENO && fd != STDOUT_FILENO && fd != STDERR_FILENO) fcntl(fd, F_SETFD, FD_CLOEXEC);
 }
 
+void ProcessHandler::send(const logging::LogLevel& level, const std::string& text) {
+  if(level < log) return;
+  if(messages == nullptr) {
+    std::cout << level << name << logging::getTime() << text << std::endl;
+  }
+  else {
+    // dropped messages are counted by the queue
+    messages->push(level, name + text);
+  }
+}
+
+int ProcessHandler::takeOutputFD() {
+  int fd = outputFD;
+  outputFD = -1;
+  return fd;
+}
+
+bool ProcessHandler::getExitStatus(int& status) {
+  if(spawnID == 0) return false;
+  return spawn::SpawnHelper::getExitStatus(spawnID, status);
+}
+
 void ProcessHandler::Disconnect() {
   connected = false;
 }
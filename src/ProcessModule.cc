@@ -10,6 +10,8 @@
 
 #include "ProcessModule.h"
 
+#include "SpawnHelper.h"
+
 #ifndef WITH_PROCPS
 #  include <libproc2/pids.h>
 #endif
@@ -33,9 +35,9 @@ ProcessInfoModule::ProcessInfoModule(ctk::ModuleGroup* owner, const std::string&
       PIDS_TICS_SYSTEM,   // stime
       PIDS_TICS_USER_C,   // utime+cutime
       PIDS_TICS_SYSTEM_C, // stime+cstime
-      PIDS_RSS, PIDS_NICE, PIDS_PRIORITY, PIDS_TIME_START, PIDS_TIME_ELAPSED, PIDS_MEM_RES};
+      PIDS_RSS, PIDS_NICE, PIDS_PRIORITY, PIDS_TIME_START, PIDS_TIME_ELAPSED, PIDS_MEM_RES, PIDS_NLWP};
 
-  if(procps_pids_new(&infoptr, Items, 11) < 0) {
+  if(procps_pids_new(&infoptr, Items, 12) < 0) {
     ctk::runtime_error("Failed to prepare procps in ProcessInfoModule.");
   }
 
@@ -63,8 +65,8 @@ void ProcessInfoModule::mainLoop() {
       uint tmpPID = info.processPID;
       FillProcInfo(&tmpPID);
 #endif
-      logger->sendMessage(
-          std::string("Process is running (PID: ") + std::to_string(info.processPID) + ")", logging::LogLevel::DEBUG);
+      logging::send(logger, logging::LogLevel::DEBUG,
+          [&] { return std::string("Process is running (PID: ") + std::to_string(info.processPID) + ")"; });
     }
     catch(std::runtime_error& e) {
       logger->sendMessage(
@@ -101,6 +103,8 @@ void ProcessInfoModule::FillProcInfo(const std::shared_ptr<proc_t>& infoPtr) {
       statistics.nice = std::stoi(std::to_string(infoPtr->nice));
       statistics.rss = std::stoi(std::to_string(infoPtr->rss));
       statistics.mem = std::stoi(std::to_string(infoPtr->vm_rss));
+      statistics.nThreads = std::stoi(std::to_string(infoPtr->nlwp));
+      updateNFDs(infoPtr->tid);
 
       statistics.memoryUsage = 1. * statistics.mem / system.status.maxMem * 100.;
 
@@ -136,6 +140,9 @@ void ProcessInfoModule::FillProcInfo(const std::shared_ptr<proc_t>& infoPtr) {
     statistics.runtime = 0;
     statistics.mem = 0;
     statistics.memoryUsage = 0.;
+    statistics.nThreads = 0;
+    statistics.nFDs = 0;
+    _fdTicks = 0;
   }
 }
 #else
@@ -164,6 +171,8 @@ void ProcessInfoModule::FillProcInfo(uint* pid) {
 
     statistics.runtime = (uint)PIDS_VAL(9, real, stack->stacks[0], info);
     statistics.mem = PIDS_VAL(10, ul_int, stack->stacks[0], info);
+    statistics.nThreads = PIDS_VAL(11, s_int, stack->stacks[0], info);
+    updateNFDs(*pid);
     statistics.memoryUsage = 1. * statistics.mem / system.status.maxMem * 100.;
 
     // check if it is the first call after process is started (time_stamp  == not_a_date_time)
@@ -192,22 +201,38 @@ void ProcessInfoModule::FillProcInfo(uint* pid) {
     statistics.runtime = 0;
     statistics.mem = 0;
     statistics.memoryUsage = 0.;
+    statistics.nThreads = 0;
+    statistics.nFDs = 0;
+    _fdTicks = 0;
   }
 }
 #endif
+void ProcessInfoModule::updateNFDs(size_t pid) {
+  unsigned int interval = fdCountInterval();
+  if(interval == 0) {
+    statistics.nFDs = 0;
+    _fdTicks = 0;
+    return;
+  }
+  if(_fdTicks % interval == 0) {
+    statistics.nFDs = proc_util::getNFDs(pid);
+    _fdTicks = 0;
+  }
+  _fdTicks++;
+}
+
 void ProcessControlModule::mainLoop() {
-  std::stringstream handlerMessage;
   logger->sendMessage(std::string("New ProcessModule started!"), logging::LogLevel::INFO);
   SetOffline();
   status.nRestarts = 0;
 
   try {
 #ifdef WITH_PROCPS
-    process.reset(new ProcessHandler(getName(), false, info.processPID, handlerMessage));
+    process.reset(new ProcessHandler(getName(), false, info.processPID, _handlerMessages));
 #else
-    process.reset(new ProcessHandler(getName(), infoptrPID, false, info.processPID, handlerMessage));
+    process.reset(new ProcessHandler(getName(), infoptrPID, false, info.processPID, _handlerMessages));
 #endif
-    evaluateMessage(handlerMessage);
+    evaluateMessage();
     if(info.processPID > 0) {
       logger->sendMessage(
           std::string("Found process that is still running. PID is: ") + std::to_string(info.processPID),
@@ -245,13 +270,15 @@ void ProcessControlModule::mainLoop() {
      * -> to reset turn off/on the process
      */
     if(_stop) {
-      logger->sendMessage(std::string("Process sleeping. Fails: ") + std::to_string(status.nFailed) + "/" +
-              std::to_string(config.maxFails) + ", Restarts: " + std::to_string(status.nRestarts) + "/" +
-              std::to_string(config.maxRestarts),
-          logging::LogLevel::DEBUG);
+      logging::send(logger, logging::LogLevel::DEBUG, [&] {
+        return std::string("Process sleeping. Fails: ") + std::to_string(status.nFailed) + "/" +
+            std::to_string(config.maxFails) + ", Restarts: " + std::to_string(status.nRestarts) + "/" +
+            std::to_string(config.maxRestarts);
+      });
 
       if(_historyOn) FillProcInfo(nullptr);
-      writeAll();
+      updateLogTail();
+      writeStatus();
       group.readUntil(trigger.getId());
       continue;
     }
@@ -261,6 +288,16 @@ void ProcessControlModule::mainLoop() {
      */
     if(info.processPID > 0 && enableProcess) {
       CheckIsOnline(info.processPID);
+      /**
+       * A hung process is stopped here and afterwards handled like a process that terminated.
+       */
+      if(status.isRunning && CheckIsHung()) {
+        status.nHangs += 1;
+        if(process.get() != nullptr) {
+          resetProcessHandler();
+        }
+        SetOffline();
+      }
       if(!status.isRunning) {
         if(config.maxRestarts == 0) {
           _stop = true;
@@ -286,16 +323,17 @@ void ProcessControlModule::mainLoop() {
      * Check number of restarts in case it is set
      */
     if(config.maxRestarts != 0 && status.nRestarts == config.maxRestarts) {
-      logger->sendMessage(std::string("Maximum number of restarts reached. Restarts: ") +
-              std::to_string(status.nRestarts) + "/" + std::to_string(config.maxRestarts),
-          logging::LogLevel::DEBUG);
+      logging::send(logger, logging::LogLevel::DEBUG, [&] {
+        return std::string("Maximum number of restarts reached. Restarts: ") + std::to_string(status.nRestarts) +
+            "/" + std::to_string(config.maxRestarts);
+      });
       // Only stop if the process terminated. This ensures that the process status is updated.
       if(status.isRunning == 0) {
         _stop = true;
         logger->sendMessage(std::string("Process terminated after maximum number of restarts reached. Restarts: ") +
                 std::to_string(status.nRestarts) + "/" + std::to_string(config.maxRestarts),
             logging::LogLevel::ERROR);
-        resetProcessHandler(&handlerMessage);
+        resetProcessHandler();
       }
       else {
         _restartRequired = false;
@@ -318,19 +356,31 @@ void ProcessControlModule::mainLoop() {
               logging::LogLevel::INFO);
           // log level of the process handler is DEBUG per default. So all messages will end up here
 #ifdef WITH_PROCPS
-          process.reset(new ProcessHandler(getName(), false, handlerMessage, this->getName()));
+          process.reset(new ProcessHandler(getName(), false, _handlerMessages, this->getName()));
 #else
-          process.reset(new ProcessHandler(getName(), infoptrPID, false, handlerMessage, this->getName()));
+          process.reset(new ProcessHandler(getName(), infoptrPID, false, _handlerMessages, this->getName()));
 #endif
-          SetOnline(process->startProcess((std::string)config.path, (std::string)config.cmd,
-              (std::string)config.externalLogfile, (std::string)config.env, config.overwriteEnv));
-          evaluateMessage(handlerMessage);
+          // the capture mode is only changed after a successful start, updateLogTail() relies on _capture being set
+          uint captureMode = config.captureOutput;
+          auto pid = process->startProcess(getExecSpec(), (std::string)config.externalLogfile, captureMode != 0);
+          if(captureMode != 0) {
+            if(_capture == nullptr) {
+              _capture = std::make_shared<OutputCapture>();
+              _capture->setScanner(_scanner);
+            }
+            _capture->attach(process->takeOutputFD());
+          }
+          _captureMode = captureMode;
+          SetOnline(pid);
+          evaluateMessage();
+          // the children are only listed for debugging, so the list is send directly without parsing it again
+          std::stringstream children;
 #ifdef WITH_PROCPS
-          status.nChilds = proc_util::getNChilds(info.processPID, handlerMessage);
+          status.nChilds = proc_util::getNChilds(info.processPID, children);
 #else
-          status.nChilds = proc_util::getNChilds(info.processPID, infoptrPID, handlerMessage);
+          status.nChilds = proc_util::getNChilds(info.processPID, infoptrPID, children);
 #endif
-          logger->sendMessage(handlerMessage.str(), logging::LogLevel::DEBUG);
+          logging::send(logger, logging::LogLevel::DEBUG, [&] { return children.str(); });
         }
         catch(std::runtime_error& e) {
           logger->sendMessage(e.what(), logging::LogLevel::ERROR);
@@ -340,9 +390,10 @@ void ProcessControlModule::mainLoop() {
       }
       else if(info.processPID > 0) {
         // process should run and is running
-        logger->sendMessage(std::string("Process is running...") + std::to_string(status.isRunning) +
-                " PID: " + std::to_string(info.processPID),
-            logging::LogLevel::DEBUG);
+        logging::send(logger, logging::LogLevel::DEBUG, [&] {
+          return std::string("Process is running...") + std::to_string(status.isRunning) +
+              " PID: " + std::to_string(info.processPID);
+        });
 
         try {
 #ifdef WITH_PROCPS
@@ -351,6 +402,7 @@ void ProcessControlModule::mainLoop() {
           uint tmpPID = info.processPID + config.pidOffset;
           FillProcInfo(&tmpPID);
 #endif
+          CheckLimits();
         }
         catch(std::runtime_error& e) {
           logger->sendMessage(std::string("Failed to read information for process ") +
@@ -364,9 +416,9 @@ void ProcessControlModule::mainLoop() {
       if(info.processPID < 0) {
         // process should not run and is not running
         status.isRunning = 0;
-        logger->sendMessage(
-            std::string("Process Running: ") + std::to_string(status.isRunning) + ". Process is not running...OK",
-            logging::LogLevel::DEBUG);
+        logging::send(logger, logging::LogLevel::DEBUG, [&] {
+          return std::string("Process Running: ") + std::to_string(status.isRunning) + ". Process is not running...OK";
+        });
         if(_historyOn) FillProcInfo(nullptr);
       }
       else {
@@ -376,12 +428,13 @@ void ProcessControlModule::mainLoop() {
         // Here the process is stopped in case enableProcess is set to 0. If it is already reset due to restart stop
         // don't do anything here
         if(process.get() != nullptr) {
-          resetProcessHandler(&handlerMessage);
+          resetProcessHandler();
         }
         SetOffline();
       }
     }
-    writeAll();
+    updateLogTail();
+    writeStatus();
     group.readUntil(trigger.getId());
   }
 #ifndef WITH_PROCPS
@@ -400,6 +453,11 @@ void ProcessControlModule::SetOnline(const int& pid) {
     status.path = (std::string)config.path;
     status.cmd = (std::string)config.cmd;
     status.env = (std::string)config.env;
+    _hangDetector.reset();
+    _heartbeatError = false;
+    _fdTicks = 0;
+    _limiter.reset();
+    status.limitStatus = 0;
     logger->sendMessage(std::string("Ok process is started successfully with PID: ") + std::to_string(info.processPID),
         logging::LogLevel::INFO);
   }
@@ -441,8 +499,8 @@ void ProcessControlModule::Failed() {
 }
 
 void ProcessControlModule::CheckIsOnline(const int pid) {
-  logger->sendMessage(
-      std::string("Checking process status for process: ") + std::to_string(pid), logging::LogLevel::DEBUG);
+  logging::send(logger, logging::LogLevel::DEBUG,
+      [&] { return std::string("Checking process status for process: ") + std::to_string(pid); });
 #ifdef WITH_PROCPS
   if(!proc_util::isProcessRunning(pid)) {
 #else
@@ -451,6 +509,12 @@ void ProcessControlModule::CheckIsOnline(const int pid) {
     logger->sendMessage(std::string("Child process with PID  ") + std::to_string(info.processPID) +
             " is not running, but it should run!",
         logging::LogLevel::ERROR);
+    int exitStatus;
+    if(process.get() != nullptr && process->getExitStatus(exitStatus)) {
+      logger->sendMessage(std::string("Child process with PID  ") + std::to_string(info.processPID) +
+              " terminated with " + spawn::describeExitStatus(exitStatus),
+          logging::LogLevel::ERROR);
+    }
     SetOffline();
   }
   else {
@@ -458,7 +522,93 @@ void ProcessControlModule::CheckIsOnline(const int pid) {
   }
 }
 
-void ProcessControlModule::resetProcessHandler(std::stringstream* handlerMessage) {
+bool ProcessControlModule::CheckIsHung() {
+  if(config.hangTimeout == 0) {
+    _hangDetector.reset();
+    return false;
+  }
+  if(config.heartbeatSource > HangDetector::maxSource) {
+    if(!_heartbeatError) {
+      logger->sendMessage(std::string("Unknown heartbeat source ") + std::to_string((uint)config.heartbeatSource) +
+              ". Hang detection is disabled.",
+          logging::LogLevel::ERROR);
+      _heartbeatError = true;
+    }
+    _hangDetector.reset();
+    return false;
+  }
+  uint64_t heartbeat = _hangDetector.getLastHeartbeat();
+  auto source = static_cast<HangDetector::Source>((uint)config.heartbeatSource);
+  if(source == HangDetector::Source::CPUTime) {
+    heartbeat = (uint64_t)statistics.utime + statistics.stime + statistics.cutime + statistics.cstime;
+  }
+  else {
+    std::string file = (std::string)config.heartbeatFile;
+    if(!file.empty() && file.front() != '/') file = (std::string)config.path + "/" + file;
+    if(!HangDetector::readHeartbeat(source, file, heartbeat)) {
+      if(!_heartbeatError) {
+        logger->sendMessage(std::string("Failed to read heartbeat file: ") + file, logging::LogLevel::WARNING);
+        _heartbeatError = true;
+      }
+      else {
+        logging::send(
+            logger, logging::LogLevel::DEBUG, [&] { return std::string("Failed to read heartbeat file: ") + file; });
+      }
+      // A file that was never read since the process started is a configuration error and no hang, so the process
+      // is not restarted. Afterwards the last heartbeat is passed again, so a missing heartbeat counts as no progress.
+      if(!_hangDetector.hasHeartbeat()) return false;
+    }
+  }
+  if(_hangDetector.update(heartbeat, config.hangTimeout)) {
+    logger->sendMessage(std::string("Process with PID ") + std::to_string(info.processPID) +
+            " did not make any progress for " + std::to_string((uint)_hangDetector.getStallTime()) +
+            "s. It is considered hung and will be restarted.",
+        logging::LogLevel::ERROR);
+    return true;
+  }
+  return false;
+}
+
+void ProcessControlModule::CheckLimits() {
+  ResourceLimiter::Limits limits;
+  limits.maxMem = config.maxMem;
+  limits.maxCPU = config.maxCPU;
+  limits.cpuWindow = config.cpuWindow;
+  limits.maxFDs = config.maxFDs;
+  limits.maxThreads = config.maxThreads;
+  limits.nTicks = config.limitTicks;
+  ResourceLimiter::Sample sample;
+  sample.mem = statistics.mem;
+  sample.pcpu = statistics.pcpu;
+  sample.nFDs = statistics.nFDs;
+  sample.nThreads = statistics.nThreads;
+
+  auto action = _limiter.update(sample, limits);
+  status.limitStatus = static_cast<uint>(_limiter.getLevel());
+  if(action == ResourceLimiter::Action::Warning) {
+    logger->sendMessage(std::string("Process with PID ") + std::to_string(info.processPID) +
+            " exceeds its resource limits: " + _limiter.getBreach(),
+        logging::LogLevel::WARNING);
+  }
+  else if(action == ResourceLimiter::Action::Restart) {
+    uint sig = config.killSig < 1 ? SIGINT : (uint)config.killSig;
+    logger->sendMessage(std::string("Process with PID ") + std::to_string(info.processPID) +
+            " still exceeds its resource limits: " + _limiter.getBreach() + ". Stopping it using signal " +
+            std::to_string(sig) + " in order to restart it.",
+        logging::LogLevel::ERROR);
+    if(process.get() != nullptr) process->sendSignal(sig);
+  }
+  else if(action == ResourceLimiter::Action::Kill) {
+    logger->sendMessage(std::string("Process with PID ") + std::to_string(info.processPID) +
+            " did not stop and still exceeds its resource limits: " + _limiter.getBreach() +
+            ". Killing it using SIGKILL.",
+        logging::LogLevel::ERROR);
+    if(process.get() != nullptr) process->sendSignal(SIGKILL);
+  }
+  evaluateMessage();
+}
+
+void ProcessControlModule::resetProcessHandler() {
   // ToDo: Set default to 2!
   if(config.killSig < 1)
     process->setSigNum(2);
@@ -466,7 +616,104 @@ void ProcessControlModule::resetProcessHandler(std::stringstream* handlerMessage
     process->setSigNum(config.killSig);
   process->setKillTimeout(config.killTimeout);
   process.reset(nullptr);
-  evaluateMessage(*handlerMessage);
+  evaluateMessage();
+}
+
+std::shared_ptr<const ExecSpec> ProcessControlModule::getExecSpec() {
+  if((std::string)config.path == "" || (std::string)config.cmd == "") {
+    throw std::runtime_error("Path or command not set before starting a process!");
+  }
+  if(_execSpec == nullptr ||
+      !_execSpec->matches(config.path, config.cmd, config.env, config.overwriteEnv)) {
+    logging::send(
+        logger, logging::LogLevel::DEBUG, [&] { return std::string("Preparing command: ") + (std::string)config.cmd; });
+    _execSpec = std::make_shared<const ExecSpec>(config.path, config.cmd, config.env, config.overwriteEnv);
+  }
+  return _execSpec;
+}
+
+void ProcessControlModule::updateLogTail() {
+  // the log file is only written by the watchdog in capture mode 2, so it can be reopened after renaming it
+  if(_captureMode != 1) {
+    LogRotator::Settings settings{config.logMaxSize, config.logMaxAge, config.logRetention, config.logCompress != 0};
+    try {
+      auto rotated = _rotator.check((std::string)config.externalLogfile, settings,
+          _captureMode == 2 ? LogRotator::Method::Rename : LogRotator::Method::CopyTruncate);
+      if(!rotated.empty()) {
+        if(_captureMode == 2 && _capture != nullptr) _capture->reopenLogFile();
+        status.nLogRotations += 1;
+        logging::send(logger, logging::LogLevel::DEBUG, [&] { return std::string("Rotated log file to ") + rotated; });
+      }
+    }
+    catch(std::runtime_error& e) {
+      logger->sendMessage(e.what(), logging::LogLevel::ERROR);
+    }
+  }
+  if(logPage.update(_captureMode == 1 ? "" : (std::string)config.externalLogfile)) {
+    logPage.page.write();
+    logPage.pageFirstLine.write();
+    logPage.totalLines.write();
+  }
+  if(_captureMode == 0 || _capture == nullptr) {
+    _logTail.setScanner(_scanner);
+    if(_logTail.update((std::string)config.externalLogfile, config.tailLength)) {
+      logStatus.logTailExtern = _logTail.getTail();
+      logStatus.logTailExtern.write();
+    }
+    updateLogPatterns();
+    return;
+  }
+  _logTail.setScanner(nullptr);
+  _capture->setTailLength(config.tailLength);
+  _capture->setLogFile(_captureMode == 2 ? (std::string)config.externalLogfile : "");
+  _capture->flush();
+  std::string tail;
+  if(_capture->update(tail)) {
+    logStatus.logTailExtern = tail;
+    logStatus.logTailExtern.write();
+  }
+  auto dropped = _capture->getDroppedBytes();
+  if(dropped != status.logBytesDropped) {
+    logger->sendMessage(std::string("Failed to write ") + std::to_string(dropped - status.logBytesDropped) +
+            " bytes of the process output to the log file.",
+        logging::LogLevel::WARNING);
+    status.logBytesDropped = dropped;
+  }
+  updateLogPatterns();
+}
+
+void ProcessControlModule::writeStatus() {
+  // the logger writes its messages itself, logStatus and logPage are written by updateLogTail()
+  info.writeAll();
+  statistics.writeAll();
+  status.writeAll();
+}
+
+void ProcessControlModule::updateLogPatterns() {
+  auto now = std::chrono::steady_clock::now();
+  if((std::string)config.logPatterns != _logPatterns) {
+    _logPatterns = config.logPatterns;
+    try {
+      _scanner->setPatterns(ExecSpec::parseArguments(_logPatterns, ","));
+    }
+    catch(std::runtime_error& e) {
+      logger->sendMessage(std::string("Failed to set log patterns: ") + e.what(), logging::LogLevel::ERROR);
+      _scanner->setPatterns({});
+    }
+    _lastPatternCounts.clear();
+  }
+  auto counts = _scanner->getCounts();
+  double dt = std::chrono::duration<double>(now - _lastPatternUpdate).count();
+  std::vector<uint64_t> outCounts(LogScanner::maxPatterns, 0);
+  std::vector<double> outRates(LogScanner::maxPatterns, 0);
+  for(size_t i = 0; i < counts.size(); ++i) {
+    outCounts[i] = counts[i];
+    if(i < _lastPatternCounts.size() && dt > 0) outRates[i] = (counts[i] - _lastPatternCounts[i]) / dt;
+  }
+  status.logPatternCounts = outCounts;
+  status.logPatternRates = outRates;
+  _lastPatternCounts = counts;
+  _lastPatternUpdate = now;
 }
 
 void ProcessControlModule::terminate() {
@@ -482,11 +729,13 @@ void ProcessControlModule::terminate() {
   ProcessInfoModule::terminate();
 }
 
-void ProcessControlModule::evaluateMessage(std::stringstream& msg) {
-  auto list = logging::stripMessages(msg);
-  for(auto& message : list) {
-    logger->sendMessage(message.message.str(), message.logLevel);
+void ProcessControlModule::evaluateMessage() {
+  while(_handlerMessages->pop(_handlerRecord)) {
+    logger->sendMessage(_handlerRecord.text, _handlerRecord.level);
+  }
+  auto dropped = _handlerMessages->takeDropped();
+  if(dropped > 0) {
+    logger->sendMessage(std::to_string(dropped) + " messages of the ProcessHandler were dropped.",
+        logging::LogLevel::WARNING);
   }
-  msg.clear();
-  msg.str("");
 }
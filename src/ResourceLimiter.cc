@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * ResourceLimiter.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "ResourceLimiter.h"
+
+#include <algorithm>
+#include <numeric>
+
+ResourceLimiter::Action ResourceLimiter::update(const Sample& sample, const Limits& limits) {
+  // average CPU usage over the window
+  size_t window = std::max(limits.cpuWindow, 1U);
+  if(_cpuHistory.size() != window) {
+    _cpuHistory.assign(window, 0.);
+    _cpuPos = 0;
+    _cpuEntries = 0;
+  }
+  _cpuHistory[_cpuPos] = sample.pcpu;
+  _cpuPos = (_cpuPos + 1) % window;
+  _cpuEntries = std::min(_cpuEntries + 1, window);
+  double avgCPU = std::accumulate(_cpuHistory.begin(), _cpuHistory.end(), 0.) / _cpuEntries;
+
+  _breach.clear();
+  if(limits.maxMem > 0 && sample.mem > limits.maxMem) {
+    _breach += "mem: " + std::to_string(sample.mem) + "kB > " + std::to_string(limits.maxMem) + "kB ";
+  }
+  // only judge the CPU usage once the window is filled
+  if(limits.maxCPU > 0 && _cpuEntries == window && avgCPU > limits.maxCPU) {
+    _breach += "cpu: " + std::to_string(avgCPU) + "% > " + std::to_string(limits.maxCPU) + "% ";
+  }
+  if(limits.maxFDs > 0 && sample.nFDs > limits.maxFDs) {
+    _breach += "fds: " + std::to_string(sample.nFDs) + " > " + std::to_string(limits.maxFDs) + " ";
+  }
+  if(limits.maxThreads > 0 && sample.nThreads > limits.maxThreads) {
+    _breach += "threads: " + std::to_string(sample.nThreads) + " > " + std::to_string(limits.maxThreads) + " ";
+  }
+
+  if(_breach.empty()) {
+    _breachTicks = 0;
+    _level = Action::None;
+    return Action::None;
+  }
+
+  _breachTicks++;
+  unsigned int nTicks = std::max(limits.nTicks, 1U);
+  Action reached = Action::None;
+  if(_breachTicks >= 3 * nTicks)
+    reached = Action::Kill;
+  else if(_breachTicks >= 2 * nTicks)
+    reached = Action::Restart;
+  else if(_breachTicks >= nTicks)
+    reached = Action::Warning;
+
+  if(reached > _level) {
+    _level = reached;
+    return reached;
+  }
+  return Action::None;
+}
+
+void ResourceLimiter::reset() {
+  _cpuHistory.clear();
+  _cpuPos = 0;
+  _cpuEntries = 0;
+  _breachTicks = 0;
+  _level = Action::None;
+  _breach.clear();
+}
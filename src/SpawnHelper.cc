@@ -0,0 +1,543 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * SpawnHelper.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "SpawnHelper.h"
+
+#include "ProcessHandler.h"
+
+#include <sys/prctl.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace spawn {
+
+  namespace {
+    /**
+     * Message types used between the watchdog and the helper.
+     */
+    enum MessageType : uint32_t { SPAWN = 1, SPAWNED = 2, EXITED = 3 };
+
+    /** Maximum size of a single message. */
+    constexpr size_t maxMessageSize = 65536;
+
+    void appendInt(std::vector<char>& buffer, int32_t value) {
+      buffer.insert(buffer.end(), (const char*)&value, (const char*)&value + sizeof(value));
+    }
+
+    void appendString(std::vector<char>& buffer, const std::string& value) {
+      appendInt(buffer, (int32_t)value.size());
+      buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+    bool readInt(const char*& pos, const char* end, int32_t& value) {
+      if(end - pos < (ssize_t)sizeof(value)) return false;
+      std::memcpy(&value, pos, sizeof(value));
+      pos += sizeof(value);
+      return true;
+    }
+
+    bool readString(const char*& pos, const char* end, std::string& value) {
+      int32_t size;
+      if(!readInt(pos, end, size) || size < 0 || end - pos < size) return false;
+      value.assign(pos, size);
+      pos += size;
+      return true;
+    }
+
+    void appendStrings(std::vector<char>& buffer, const std::vector<std::string>& values) {
+      appendInt(buffer, (int32_t)values.size());
+      for(auto& value : values) appendString(buffer, value);
+    }
+
+    bool readStrings(const char*& pos, const char* end, std::vector<std::string>& values) {
+      int32_t size;
+      if(!readInt(pos, end, size) || size < 0) return false;
+      values.resize(size);
+      for(auto& value : values) {
+        if(!readString(pos, end, value)) return false;
+      }
+      return true;
+    }
+
+    std::vector<char> serialize(const Request& request, int32_t requestID) {
+      std::vector<char> buffer;
+      appendInt(buffer, SPAWN);
+      appendInt(buffer, requestID);
+      appendInt(buffer, (int32_t)request.logLevel);
+      appendInt(buffer, request.captureOutput);
+      appendString(buffer, request.exec->getPath());
+      appendStrings(buffer, request.exec->getArgs());
+      appendStrings(buffer, request.exec->getEnv());
+      appendString(buffer, request.logfile);
+      appendString(buffer, request.pidFile);
+      appendString(buffer, request.name);
+      return buffer;
+    }
+
+    /**
+     * \param requestID Set to the ID of the request even if the rest of the request can not be interpreted, 0 if it
+     * is not found.
+     */
+    bool deserialize(const char* pos, const char* end, Request& request, int32_t& requestID) {
+      int32_t type, logLevel, captureOutput;
+      requestID = 0;
+      if(!readInt(pos, end, type) || type != SPAWN || !readInt(pos, end, requestID)) return false;
+      if(!readInt(pos, end, logLevel) || !readInt(pos, end, captureOutput)) return false;
+      request.logLevel = (logging::LogLevel)logLevel;
+      request.captureOutput = captureOutput;
+      std::string path;
+      std::vector<std::string> args, env;
+      if(!readString(pos, end, path) || !readStrings(pos, end, args) || !readStrings(pos, end, env) || args.empty()) {
+        return false;
+      }
+      request.exec = std::make_shared<const ExecSpec>(path, std::move(args), std::move(env));
+      return readString(pos, end, request.logfile) && readString(pos, end, request.pidFile) &&
+          readString(pos, end, request.name);
+    }
+
+    /**
+     * Send a message to the watchdog. If \c fd is not -1 it is passed to the watchdog (SCM_RIGHTS).
+     * \param requestID ID of the spawn request answered by the message, 0 for EXITED.
+     */
+    void sendReply(int sock, MessageType type, int32_t requestID, pid_t pid, int32_t status,
+        const std::string& error = "", int fd = -1) {
+      std::vector<char> buffer;
+      appendInt(buffer, type);
+      appendInt(buffer, requestID);
+      appendInt(buffer, pid);
+      appendInt(buffer, status);
+      appendString(buffer, error);
+      struct iovec iov = {buffer.data(), buffer.size()};
+      struct msghdr msg {};
+      msg.msg_iov = &iov;
+      msg.msg_iovlen = 1;
+      alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+      if(fd >= 0) {
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+      }
+      sendmsg(sock, &msg, MSG_NOSIGNAL);
+    }
+
+    /**
+     * Fork a child for the request and wait until execve succeeded or the child reported an error.
+     */
+    void handleRequest(int sock, int sigFD, const sigset_t& originalMask, Request& request, int32_t requestID) {
+      int errorPipe[2];
+      if(pipe2(errorPipe, O_CLOEXEC) != 0) {
+        sendReply(sock, SPAWNED, requestID, -1, errno, std::string("Failed to create pipe: ") + strerror(errno));
+        return;
+      }
+      int outputPipe[2] = {-1, -1};
+      if(request.captureOutput && pipe2(outputPipe, O_CLOEXEC) != 0) {
+        close(errorPipe[0]);
+        close(errorPipe[1]);
+        sendReply(sock, SPAWNED, requestID, -1, errno, std::string("Failed to create output pipe: ") + strerror(errno));
+        return;
+      }
+      request.outputFD = outputPipe[1];
+      pid_t pid = fork();
+      if(pid == 0) {
+        close(errorPipe[0]);
+        if(outputPipe[0] >= 0) close(outputPipe[0]);
+        close(sock);
+        close(sigFD);
+        sigprocmask(SIG_SETMASK, &originalMask, nullptr);
+        execChild(request, errorPipe[1]);
+      }
+      close(errorPipe[1]);
+      if(outputPipe[1] >= 0) close(outputPipe[1]);
+      if(pid < 0) {
+        close(errorPipe[0]);
+        if(outputPipe[0] >= 0) close(outputPipe[0]);
+        sendReply(sock, SPAWNED, requestID, -1, errno, std::string("Failed to fork: ") + strerror(errno));
+        return;
+      }
+      // The pipe is closed by execve. Any data means the child failed before calling execve.
+      std::string error;
+      char buffer[256];
+      ssize_t n;
+      while((n = read(errorPipe[0], buffer, sizeof(buffer))) != 0) {
+        if(n < 0) {
+          if(errno == EINTR) continue;
+          break;
+        }
+        error.append(buffer, n);
+      }
+      close(errorPipe[0]);
+      sendReply(sock, SPAWNED, requestID, error.empty() ? pid : -1, 0, error, error.empty() ? outputPipe[0] : -1);
+      if(outputPipe[0] >= 0) close(outputPipe[0]);
+    }
+
+    void reapChildren(int sock) {
+      int status;
+      pid_t pid;
+      while((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+        sendReply(sock, EXITED, 0, pid, status);
+      }
+    }
+
+    /**
+     * Main loop of the helper process. It never returns.
+     * \param watchdogPID PID of the watchdog, saved before the helper was forked.
+     */
+    [[noreturn]] void helperMain(int sock, pid_t watchdogPID) {
+      // The helper is not needed without the watchdog. If the watchdog died before the death signal was set up the
+      // helper was already reparented and no signal will be sent.
+      prctl(PR_SET_PDEATHSIG, SIGKILL);
+      if(getppid() != watchdogPID) _exit(0);
+      signal(SIGCHLD, SIG_DFL);
+      signal(SIGPIPE, SIG_IGN);
+      sigset_t mask, originalMask;
+      sigemptyset(&mask);
+      sigaddset(&mask, SIGCHLD);
+      sigprocmask(SIG_BLOCK, &mask, &originalMask);
+      int sigFD = signalfd(-1, &mask, SFD_CLOEXEC);
+      if(sigFD < 0) _exit(1);
+
+      std::vector<char> buffer(maxMessageSize);
+      struct pollfd fds[2] = {{sock, POLLIN, 0}, {sigFD, POLLIN, 0}};
+      while(true) {
+        if(poll(fds, 2, -1) < 0) {
+          if(errno == EINTR) continue;
+          _exit(1);
+        }
+        if(fds[1].revents & POLLIN) {
+          struct signalfd_siginfo info;
+          while(read(sigFD, &info, sizeof(info)) < 0 && errno == EINTR) {
+          }
+          reapChildren(sock);
+        }
+        if(fds[0].revents & POLLIN) {
+          ssize_t n = recv(sock, buffer.data(), buffer.size(), 0);
+          if(n <= 0) _exit(0);
+          Request request;
+          int32_t requestID;
+          if(deserialize(buffer.data(), buffer.data() + n, request, requestID)) {
+            handleRequest(sock, sigFD, originalMask, request, requestID);
+          }
+          else {
+            sendReply(sock, SPAWNED, requestID, -1, EINVAL, "Failed to interpret spawn request.");
+          }
+        }
+        else if(fds[0].revents & (POLLHUP | POLLERR)) {
+          // watchdog closed the connection
+          _exit(0);
+        }
+      }
+    }
+
+    /**
+     * Report that the child could not be started and terminate it.
+     */
+    [[noreturn]] void failChild(const Request& request, int errorFD, const std::string& msg) {
+      if(request.logLevel <= logging::LogLevel::ERROR) {
+        std::cerr << logging::LogLevel::ERROR << request.name << logging::getTime() << msg << std::endl;
+      }
+      if(errorFD >= 0) {
+        if(write(errorFD, msg.c_str(), msg.size()) < 0) {
+          // nothing left to be done
+        }
+      }
+      _exit(0);
+    }
+  } // namespace
+
+  void execChild(const Request& request, int errorFD) {
+    const std::string& name = request.name;
+    const logging::LogLevel& log = request.logLevel;
+
+    if(request.outputFD >= 0) {
+      // output is captured by the watchdog
+      dup2(request.outputFD, 1);
+      dup2(request.outputFD, 2);
+      close(request.outputFD);
+    }
+    else if(request.logfile.empty()) {
+      if(log <= logging::LogLevel::WARNING)
+        std::cout << logging::LogLevel::WARNING << name << logging::getTime()
+                  << "No log file name is set. Process output is dumped to stout/stderr." << std::endl;
+    }
+    else {
+      // open the logfile
+      int fd = open(request.logfile.c_str(), O_RDWR | O_CREAT | O_APPEND,
+          S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+      if(fd == -1) {
+        if(log <= logging::LogLevel::ERROR) {
+          std::cerr << logging::LogLevel::ERROR << name << logging::getTime()
+                    << "Failed to open log file. No logfile will be written." << std::endl;
+        }
+      }
+      else {
+        dup2(fd, 1); // make stdout go to file
+        dup2(fd, 2); // make stderr go to file
+        close(fd);
+      }
+    }
+    std::cout << logging::LogLevel::INFO << name << logging::getTime() << "Going to start a new process." << std::endl;
+    // Don't throw in the child since the parent will not catch it
+    pid_t child = (int)getpid();
+    if(setpgid(0, child) && log <= logging::LogLevel::ERROR) {
+      std::cerr << logging::LogLevel::ERROR << name << logging::getTime() << "Failed to reset GPID." << std::endl;
+    }
+    if(log == logging::LogLevel::DEBUG) {
+      std::cout << logging::LogLevel::DEBUG << name << logging::getTime() << "Child running and its PID is: " << child
+                << std::endl;
+    }
+    std::ofstream file;
+    file.open(request.pidFile);
+    if(!file.is_open()) {
+      file.close();
+      failChild(request, errorFD, "Failed to create PID file: " + request.pidFile);
+    }
+    else {
+      file << child;
+      file.close();
+    }
+    const ExecSpec& exec = *request.exec;
+    if(chdir(exec.getPath().c_str())) {
+      failChild(request, errorFD, "Failed to change to directory: " + exec.getPath());
+    }
+
+    if(log == logging::LogLevel::DEBUG) {
+      std::cout << logging::LogLevel::DEBUG << name << logging::getTime()
+                << "Going to call: execve with command:" << exec.getFile() << std::endl;
+      std::cout << logging::LogLevel::DEBUG << name << logging::getTime() << "Adding arguments: ";
+      for(auto& arg : exec.getArgs()) std::cout << arg << ", ";
+      std::cout << "NULL" << std::endl;
+      std::cout << logging::LogLevel::DEBUG << name << logging::getTime() << "Using " << exec.getEnv().size()
+                << " environment variables." << std::endl;
+    }
+
+    // close file handles when calling execv -> release the OPC UA port
+    ProcessHandler::setAllFHCloseOnExec();
+    execve(exec.getFile().c_str(), exec.getArgv(), exec.getEnvp());
+    failChild(request, errorFD, "Failed to call execve for " + exec.getFile() + ": " + strerror(errno));
+  }
+
+  std::string describeExitStatus(int status) {
+    if(WIFEXITED(status)) return "exit code " + std::to_string(WEXITSTATUS(status));
+    if(WIFSIGNALED(status)) return "signal " + std::to_string(WTERMSIG(status));
+    return "status " + std::to_string(status);
+  }
+
+  SpawnHelper& SpawnHelper::instance() {
+    static SpawnHelper helper;
+    return helper;
+  }
+
+  bool SpawnHelper::start() {
+    auto& helper = instance();
+    std::lock_guard<std::mutex> lock(helper._mutex);
+    if(helper._socket >= 0) return true;
+    int sockets[2];
+    if(socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) != 0) {
+      std::cerr << "Failed to create socket for the spawn helper: " << strerror(errno) << std::endl;
+      return false;
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    pid_t watchdogPID = getpid();
+    pid_t pid = fork();
+    if(pid == 0) {
+      close(sockets[0]);
+      helperMain(sockets[1], watchdogPID);
+    }
+    close(sockets[1]);
+    if(pid < 0) {
+      std::cerr << "Failed to fork the spawn helper: " << strerror(errno) << std::endl;
+      close(sockets[0]);
+      return false;
+    }
+    helper._socket = sockets[0];
+    helper._started = true;
+    return true;
+  }
+
+  bool SpawnHelper::isRunning() {
+    auto& helper = instance();
+    std::lock_guard<std::mutex> lock(helper._mutex);
+    return helper._socket >= 0;
+  }
+
+  bool SpawnHelper::wasStarted() {
+    auto& helper = instance();
+    std::lock_guard<std::mutex> lock(helper._mutex);
+    return helper._started;
+  }
+
+  pid_t SpawnHelper::spawn(const Request& request, std::string& error, int* outputFD, uint64_t* spawnID) {
+    auto& helper = instance();
+    std::unique_lock<std::mutex> lock(helper._mutex);
+    if(helper._socket < 0) {
+      error = "Spawn helper is not running.";
+      return -1;
+    }
+    auto requestID = (int32_t)++helper._nRequests;
+    auto buffer = serialize(request, requestID);
+    if(buffer.size() > maxMessageSize) {
+      error = "Spawn request is too long.";
+      return -1;
+    }
+    if(send(helper._socket, buffer.data(), buffer.size(), MSG_NOSIGNAL) < 0) {
+      error = std::string("Failed to send spawn request: ") + strerror(errno);
+      helper.disconnect();
+      return -1;
+    }
+    // Replies are matched by the request ID, so other threads can spawn and receive while this one waits. Only one
+    // thread receives at a time, the others wait until it stored their reply.
+    while(true) {
+      auto it = helper._replies.find(requestID);
+      if(it != helper._replies.end()) {
+        Reply reply = std::move(it->second);
+        helper._replies.erase(it);
+        error = reply.error;
+        if(outputFD != nullptr) {
+          *outputFD = reply.outputFD;
+        }
+        else if(reply.outputFD >= 0) {
+          close(reply.outputFD);
+        }
+        if(spawnID != nullptr && reply.pid > 0) *spawnID = reply.spawnID;
+        return reply.pid;
+      }
+      if(helper._socket < 0) break;
+      if(helper._receiving) {
+        helper._received.wait(lock);
+      }
+      else {
+        helper.receive(lock, true);
+      }
+    }
+    if(error.empty()) error = "Spawn helper terminated.";
+    return -1;
+  }
+
+  bool SpawnHelper::getExitStatus(uint64_t spawnID, int& status) {
+    auto& helper = instance();
+    std::unique_lock<std::mutex> lock(helper._mutex);
+    // if another thread is receiving, it stores the exit status for us
+    while(helper._socket >= 0 && !helper._receiving && !helper._exitStatus.count(spawnID)) {
+      if(!helper.receive(lock, false)) break;
+    }
+    auto it = helper._exitStatus.find(spawnID);
+    if(it == helper._exitStatus.end()) return false;
+    status = it->second;
+    helper._exitStatus.erase(it);
+    return true;
+  }
+
+  void SpawnHelper::forget(uint64_t spawnID) {
+    auto& helper = instance();
+    std::lock_guard<std::mutex> lock(helper._mutex);
+    helper._exitStatus.erase(spawnID);
+    for(auto it = helper._children.begin(); it != helper._children.end(); ++it) {
+      if(it->second == spawnID) {
+        helper._children.erase(it);
+        break;
+      }
+    }
+  }
+
+  bool SpawnHelper::receive(std::unique_lock<std::mutex>& lock, bool blocking) {
+    char buffer[maxMessageSize];
+    struct iovec iov = {buffer, sizeof(buffer)};
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    struct msghdr msg {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ssize_t n;
+    // _receiving keeps other threads from receiving and from closing the socket
+    _receiving = true;
+    int sock = _socket;
+    lock.unlock();
+    do {
+      n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC | (blocking ? 0 : MSG_DONTWAIT));
+    } while(n < 0 && errno == EINTR);
+    int receiveErrno = errno;
+    lock.lock();
+    _receiving = false;
+    _received.notify_all();
+    int fd = -1;
+    if(n > 0) {
+      for(struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if(cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+          std::memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+        }
+      }
+    }
+    if(n == 0 || (n < 0 && receiveErrno != EAGAIN)) {
+      if(fd >= 0) close(fd);
+      disconnect();
+      return false;
+    }
+    if(n < 0) return false;
+    const char* pos = buffer;
+    const char* end = buffer + n;
+    int32_t type, requestID, pid, status;
+    std::string message;
+    if(!readInt(pos, end, type) || !readInt(pos, end, requestID) || !readInt(pos, end, pid) ||
+        !readInt(pos, end, status) || !readString(pos, end, message)) {
+      if(fd >= 0) close(fd);
+      return true;
+    }
+    if(type == EXITED) {
+      // children that failed to start or were forgotten are not stored
+      auto it = _children.find(pid);
+      if(it != _children.end()) {
+        _exitStatus[it->second] = status;
+        _children.erase(it);
+      }
+      return true;
+    }
+    // The child is registered right away, since the exit of the child is always reported after this reply. Thus the
+    // PID can not be reused before.
+    Reply& reply = _replies[requestID];
+    reply.pid = pid;
+    reply.error = message;
+    reply.outputFD = fd;
+    if(pid > 0) {
+      reply.spawnID = ++_nSpawns;
+      _children[pid] = reply.spawnID;
+    }
+    return true;
+  }
+
+  void SpawnHelper::disconnect() {
+    if(_socket < 0) return;
+    if(_receiving) {
+      // the receiving thread is woken up and closes the socket
+      shutdown(_socket, SHUT_RDWR);
+      return;
+    }
+    close(_socket);
+    _socket = -1;
+    _received.notify_all();
+  }
+
+} // namespace spawn
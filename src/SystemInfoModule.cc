@@ -10,20 +10,22 @@
 
 #include "SystemInfoModule.h"
 
+#include "Logging.h"
 #include "sys_stat.h"
-#ifdef WITH_PROCPS
-#  include <proc/readproc.h>
-#  include <proc/sysinfo.h>
-#else
-#  include "libproc2/meminfo.h"
+#ifndef WITH_PROCPS
 #  include "libproc2/misc.h"
-#  include "libproc2/stat.h"
 #endif
 #include <sys/vfs.h>
+#include <unistd.h>
 
+#include <boost/thread.hpp>
+
+#include <algorithm>
+#include <bitset>
 #include <cerrno>
 #include <chrono>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 #include <string>
 #include <thread>
@@ -33,6 +35,50 @@
 #undef likely
 #include "boost/date_time/posix_time/posix_time.hpp"
 
+namespace {
+  /** \return Rate of a counter, 0 if the counter decreased. */
+  double rate(uint64_t current, uint64_t last, double dt) {
+    return current > last && dt > 0 ? (current - last) / dt : 0.;
+  }
+
+  /** Results published by the DiskStatsModule */
+  const struct {
+    std::unique_ptr<ctk::ArrayOutput<double>> DiskStatsModule::Status::*output;
+    double DiskStats::Rates::*rate;
+    double scale;
+    const char* name;
+    const char* unit;
+    const char* description;
+  } diskOutputs[] = {{&DiskStatsModule::Status::readIOPS, &DiskStats::Rates::readIOPS, 1., "readIOPS", "1/s",
+                         "Reads per second"},
+      {&DiskStatsModule::Status::writeIOPS, &DiskStats::Rates::writeIOPS, 1., "writeIOPS", "1/s", "Writes per second"},
+      {&DiskStatsModule::Status::readThroughput, &DiskStats::Rates::readBytes, 1. / 1024 / 1024, "readThroughput",
+          "MiB/s", "Data rate read"},
+      {&DiskStatsModule::Status::writeThroughput, &DiskStats::Rates::writeBytes, 1. / 1024 / 1024, "writeThroughput",
+          "MiB/s", "Data rate written"},
+      {&DiskStatsModule::Status::readLatency, &DiskStats::Rates::readLatency, 1., "readLatency", "ms",
+          "Average time per read"},
+      {&DiskStatsModule::Status::writeLatency, &DiskStats::Rates::writeLatency, 1., "writeLatency", "ms",
+          "Average time per write"},
+      {&DiskStatsModule::Status::queueDepth, &DiskStats::Rates::queueDepth, 1., "queueDepth", "",
+          "Average number of requests in flight"},
+      {&DiskStatsModule::Status::inFlight, &DiskStats::Rates::inFlight, 1., "inFlight", "",
+          "Number of requests in flight"},
+      {&DiskStatsModule::Status::utilisation, &DiskStats::Rates::utilisation, 1., "utilisation", "%",
+          "Share of time the device was busy"}};
+
+  /** Counters published by the NetworkModule, in the order of NetworkModule::Status::data */
+  const struct {
+    uint64_t NetStats::Counters::*counter;
+    double scale;
+  } networkCounters[] = {{&NetStats::Counters::rxPackets, 1.}, {&NetStats::Counters::txPackets, 1.},
+      {&NetStats::Counters::rxBytes, 1. / 1024 / 1024}, {&NetStats::Counters::txBytes, 1. / 1024 / 1024},
+      {&NetStats::Counters::rxDropped, 1.}, {&NetStats::Counters::txDropped, 1.},
+      {&NetStats::Counters::collisions, 1.}, {&NetStats::Counters::rxErrors, 1.}, {&NetStats::Counters::txErrors, 1.},
+      {&NetStats::Counters::rxFifo, 1.}, {&NetStats::Counters::txFifo, 1.}, {&NetStats::Counters::rxOver, 1.},
+      {&NetStats::Counters::rxMissed, 1.}, {&NetStats::Counters::multicast, 1.}};
+} // namespace
+
 SystemInfoModule::SystemInfoModule(ctk::ModuleGroup* owner, const std::string& name, const std::string& description,
     const std::unordered_set<std::string>& tags, const std::string& pathToTrigger)
 : ctk::ApplicationModule(owner, name, description, tags), trigger(this, pathToTrigger, "", "Trigger input") {
@@ -42,239 +88,223 @@ SystemInfoModule::SystemInfoModule(ctk::ModuleGroup* owner, const std::string& n
   }
   status.cpu_use = std::make_unique<ctk::ArrayOutput<double>>(&status, "cpuUsage", "%", sysInfo.getNCpu(),
       "CPU usage for each processor", std::unordered_set<std::string>{"history"});
-#ifdef WITH_PROCPS
-  //  // add 1 since cpuTotal should be added too
-  lastInfo = std::vector<cpu>(sysInfo.getNCpu() + 1);
-#else
-  procps_stat_new(&infoptr);
-  enum stat_item items[] = {STAT_TIC_SUM_DELTA_BUSY, STAT_TIC_SUM_DELTA_TOTAL};
-  // read once to get delta later on
-  procps_stat_reap(infoptr, STAT_REAP_CPUS_ONLY, items, 2);
-#endif
+  _cpuLoad = CpuLoad(sysInfo.getNCpu());
+  struct {
+    std::unique_ptr<ctk::ArrayOutput<double>>& output;
+    const char* name;
+    const char* description;
+  } states[] = {{status.cpuIowait, "cpuIowait", "Time idle while waiting for I/O for each processor"},
+      {status.cpuIrq, "cpuIrq", "Time servicing interrupts for each processor"},
+      {status.cpuSoftirq, "cpuSoftirq", "Time servicing soft interrupts for each processor"},
+      {status.cpuSteal, "cpuSteal", "Time stolen by the hypervisor for each processor"},
+      {status.cpuGuest, "cpuGuest", "Time running virtual CPUs of guests for each processor"}};
+  for(auto& state : states) {
+    state.output = std::make_unique<ctk::ArrayOutput<double>>(&status, state.name, "%", sysInfo.getNCpu(),
+        state.description, std::unordered_set<std::string>{"history"});
+  }
+
+  _topology = CpuTopology(sysInfo.getNCpu());
+  struct {
+    CpuTopology::Level level;
+    std::unique_ptr<ctk::ArrayOutput<std::string>>& names;
+    std::unique_ptr<ctk::ArrayOutput<double>>& usage;
+    const char* name;
+    const char* description;
+  } levels[] = {{CpuTopology::SOCKET, info.cpuSockets, status.cpuSocket, "Socket", "socket"},
+      {CpuTopology::NODE, info.cpuNodes, status.cpuNode, "Node", "NUMA node"},
+      {CpuTopology::CORE_TYPE, info.cpuCoreTypes, status.cpuCoreType, "CoreType", "core type"}};
+  for(auto& level : levels) {
+    size_t nGroups = _topology.getGroups(level.level).size();
+    level.names = std::make_unique<ctk::ArrayOutput<std::string>>(&info, std::string("cpu") + level.name + "s", "",
+        nGroups, std::string("Name of each ") + level.description);
+    level.usage = std::make_unique<ctk::ArrayOutput<double>>(&status, std::string("cpu") + level.name, "%", nGroups,
+        std::string("CPU usage for each ") + level.description, std::unordered_set<std::string>{"DAQ", "history"});
+    _groupUsage[level.level].assign(nGroups, 0);
+  }
+
+  size_t nNodes = _numa.getNodeIds().size();
+  if(nNodes) {
+    info.numaNodes = std::make_unique<ctk::ArrayOutput<std::string>>(
+        &info, "numaNodes", "", nNodes, "IDs of the NUMA nodes used in numa");
+    struct {
+      std::unique_ptr<ctk::ArrayOutput<uint64_t>>& output;
+      std::vector<uint64_t>& buffer;
+      const char* name;
+      const char* description;
+    } memory[] = {{numa.memTotal, _nodeTotal, "memTotal", "Memory of each node"},
+        {numa.memFree, _nodeFree, "memFree", "Free memory of each node"},
+        {numa.memUsed, _nodeUsed, "memUsed", "Used memory of each node"}};
+    for(auto& m : memory) {
+      m.output = std::make_unique<ctk::ArrayOutput<uint64_t>>(
+          &numa, m.name, "kB", nNodes, m.description, std::unordered_set<std::string>{"DAQ", "history"});
+      m.buffer.assign(nNodes, 0);
+    }
+    struct {
+      std::unique_ptr<ctk::ArrayOutput<double>>& output;
+      std::vector<double>& buffer;
+      const char* name;
+      const char* unit;
+      const char* description;
+    } rates[] = {
+        {numa.numaMiss, _nodeMiss, "numaMiss", "1/s", "Pages allocated on each node although another was intended"},
+        {numa.numaForeign, _nodeForeign, "numaForeign", "1/s",
+            "Pages intended for each node but allocated on another node"},
+        {numa.otherNode, _nodeOther, "otherNode", "1/s",
+            "Pages allocated on each node by processes running on another node"},
+        {numa.remoteShare, _nodeRemote, "remoteShare", "%",
+            "Share of the pages allocated on each node by processes running on another node"}};
+    for(auto& r : rates) {
+      r.output = std::make_unique<ctk::ArrayOutput<double>>(
+          &numa, r.name, r.unit, nNodes, r.description, std::unordered_set<std::string>{"DAQ", "history"});
+      r.buffer.assign(nNodes, 0);
+    }
+  }
 }
 
 void SystemInfoModule::mainLoop() {
   // Set variables that are read by other modules here
-  double uptime_secs{0.};
-  double idle_secs{0.};
-  // read the system start time (uncertainty in the order of seconds...)
-#ifdef WITH_PROCPS
-  uptime(&uptime_secs, &idle_secs);
-#else
-  procps_uptime(&uptime_secs, &idle_secs);
-#endif
-  auto now = boost::posix_time::second_clock::local_time();
-  status.startTime = boost::posix_time::to_time_t(now) - std::stoi(std::to_string(uptime_secs));
+  if(!_snapshot.update()) {
+    logger->sendMessage(
+        std::string("Failed to read system information: ") + _snapshot.getError(), logging::LogLevel::ERROR);
+  }
+  status.startTime = _snapshot.getBootTime();
   status.startTimeStr = boost::posix_time::to_simple_string(boost::posix_time::from_time_t(status.startTime));
   status.startTime.write();
   status.startTimeStr.write();
-  status.uptime_secTotal = std::stoi(std::to_string(uptime_secs));
+  status.uptime_secTotal = _snapshot.getUptime();
   status.uptime_secTotal.write();
+  status.maxMem = _snapshot.getMemory().total;
+  status.maxMem.write();
 #ifdef WITH_PROCPS
-  meminfo();
-  try {
-    status.maxMem = std::stoi(std::to_string(kb_main_total));
-    status.maxMem.write();
-  }
-  catch(std::exception& e) {
-    logger->sendMessage(std::string("meminfo conversion failed: ") + e.what(), logging::LogLevel::ERROR);
-  }
   info.ticksPerSecond = sysconf(_SC_CLK_TCK);
 #else
-  struct meminfo_info* meminfoptr = nullptr;
-  struct meminfo_stack* stack;
-
-  enum meminfo_item items[] = {MEMINFO_MEM_FREE, MEMINFO_MEM_SHARED, MEMINFO_MEM_TOTAL, MEMINFO_MEM_USED,
-      MEMINFO_SWAP_FREE, MEMINFO_SWAP_TOTAL, MEMINFO_SWAP_USED};
-  procps_meminfo_new(&meminfoptr);
-  stack = procps_meminfo_select(meminfoptr, items, 7);
-  status.maxMem = MEMINFO_VAL(2, ul_int, stack, info);
-  status.maxMem.write();
   info.ticksPerSecond = procps_hertz_get();
 #endif
   for(auto it = sysInfo.ibegin(); it != sysInfo.iend(); it++) {
     info.strInfos.at(it->first) = it->second;
   }
   info.nCPU = sysInfo.getNCpu();
+  *info.cpuSockets = _topology.getGroups(CpuTopology::SOCKET);
+  *info.cpuNodes = _topology.getGroups(CpuTopology::NODE);
+  *info.cpuCoreTypes = _topology.getGroups(CpuTopology::CORE_TYPE);
+  if(info.numaNodes) *info.numaNodes = _numa.getNodeIds();
   info.writeAll();
 
-#ifdef WITH_PROCPS
-  if(lastInfo.size() != (unsigned)(info.nCPU + 1)) {
-    logger->sendMessage(std::string("Failed to open system file /proc/stat") + std::to_string(lastInfo.size()) +
-            "\t nCPU" + std::to_string(info.nCPU),
-        logging::LogLevel::ERROR);
-    throw std::runtime_error("Vector size mismatch in SystemInfoModule::mainLoop.");
-  }
-#endif
-  std::ifstream file("/proc/stat");
-  if(!file.is_open()) {
-    logger->sendMessage("Failed to open system file /proc/stat", logging::LogLevel::ERROR);
-    file.close();
-    return;
+  // start with the ticks since boot, so the first usage is calculated from the first trigger
+  _cpuLoad.update(_snapshot.getTotal(), _snapshot.getCpus());
+  _lastVmstat = _snapshot.getVmstat();
+  _lastVmstatUpdate = std::chrono::steady_clock::now();
+  if(!_numa.update()) {
+    logger->sendMessage(
+        std::string("Failed to read NUMA node information: ") + _numa.getError(), logging::LogLevel::ERROR);
   }
-#ifdef WITH_PROCPS
-  readCPUInfo(lastInfo);
-#endif
+  _lastNodes = _numa.getNodes();
+  _lastNumaUpdate = std::chrono::steady_clock::now();
   while(true) {
-#ifdef WITH_PROCPS
-    meminfo();
-    try {
-      status.maxMem = std::stoi(std::to_string(kb_main_total));
-      status.freeMem = std::stoi(std::to_string(kb_main_free));
-      status.cachedMem = std::stoi(std::to_string(kb_main_cached));
-      status.usedMem = std::stoi(std::to_string(status.maxMem - status.freeMem - status.cachedMem));
-      status.maxSwap = std::stoi(std::to_string(kb_swap_total));
-      status.freeSwap = std::stoi(std::to_string(kb_swap_free));
-      status.usedSwap = std::stoi(std::to_string(status.maxSwap - status.freeSwap));
-    }
-    catch(std::exception& e) {
-      logger->sendMessage(std::string("meminfo conversion failed: ") + e.what(), logging::LogLevel::ERROR);
+    // all files are read using five system calls, values of files that could not be read are kept
+    if(!_snapshot.update()) {
+      logger->sendMessage(
+          std::string("Failed to read system information: ") + _snapshot.getError(), logging::LogLevel::ERROR);
     }
-#else
-    stack = procps_meminfo_select(meminfoptr, items, 7);
-    status.freeMem = MEMINFO_VAL(0, ul_int, stack, info);
-    status.cachedMem = MEMINFO_VAL(1, ul_int, stack, info);
-    status.maxMem = MEMINFO_VAL(2, ul_int, stack, info);
-    status.usedMem = MEMINFO_VAL(3, ul_int, stack, info);
-    status.freeSwap = MEMINFO_VAL(4, ul_int, stack, info);
-    status.maxSwap = MEMINFO_VAL(5, ul_int, stack, info);
-    status.usedSwap = MEMINFO_VAL(6, ul_int, stack, info);
-#endif
+    auto& memory = _snapshot.getMemory();
+    status.maxMem = memory.total;
+    status.freeMem = memory.free;
+    status.cachedMem = memory.cached + memory.sReclaimable;
+    status.usedMem = memory.total - std::min(memory.available, memory.total);
+    status.maxSwap = memory.swapTotal;
+    status.freeSwap = memory.swapFree;
+    status.usedSwap = memory.swapTotal - std::min(memory.swapFree, memory.swapTotal);
     status.memoryUsage = 1. * status.usedMem / status.maxMem * 100.;
     status.swapUsage = 1. * status.usedSwap / status.maxSwap * 100.;
+    status.availableMem = memory.available;
+    status.dirtyMem = memory.dirty;
+    status.writebackMem = memory.writeback;
+    status.slabMem = memory.slab;
+    status.hugePagesTotal = memory.hugePagesTotal;
+    status.hugePagesFree = memory.hugePagesFree;
+    status.hugePageSize = memory.hugePageSize;
 
-    // get system uptime
-    try {
-#ifdef WITH_PROCPS
-      uptime(&uptime_secs, &idle_secs);
-#else
-      procps_uptime(&uptime_secs, &idle_secs);
-#endif
-      status.uptime_secTotal = std::stoul(std::to_string(uptime_secs));
-      status.uptime_day = std::stoul(std::to_string(status.uptime_secTotal / 86400));
-      status.uptime_hour = std::stoul(std::to_string((status.uptime_secTotal - (status.uptime_day * 86400)) / 3600));
-      status.uptime_min = std::stoul(
-          std::to_string((status.uptime_secTotal - (status.uptime_day * 86400) - (status.uptime_hour * 3600)) / 60));
-      status.uptime_sec = std::stoul(std::to_string(status.uptime_secTotal - (status.uptime_day * 86400) -
-          (status.uptime_hour * 3600) - (status.uptime_min * 60)));
-    }
-    catch(std::exception& e) {
-      logger->sendMessage(std::string("uptime conversion failed: ") + e.what(), logging::LogLevel::ERROR);
-    }
+    auto now = std::chrono::steady_clock::now();
+    double dt = std::chrono::duration<double>(now - _lastVmstatUpdate).count();
+    auto& vmstat = _snapshot.getVmstat();
+    status.majorFaults = rate(vmstat.majorFaults, _lastVmstat.majorFaults, dt);
+    status.swapIn = rate(vmstat.swapIn, _lastVmstat.swapIn, dt);
+    status.swapOut = rate(vmstat.swapOut, _lastVmstat.swapOut, dt);
+    status.allocStalls = rate(vmstat.allocStalls, _lastVmstat.allocStalls, dt);
+    status.compactStalls = rate(vmstat.compactStalls, _lastVmstat.compactStalls, dt);
+    _lastVmstat = vmstat;
+    _lastVmstatUpdate = now;
 
-    std::vector<double> v_tmp(3);
-#ifdef WITH_PROCPS
-    loadavg(&v_tmp[0], &v_tmp[1], &v_tmp[2]);
-#else
-    procps_loadavg(&v_tmp[0], &v_tmp[1], &v_tmp[2]);
-#endif
+    // get system uptime
+    uint64_t uptime = _snapshot.getUptime();
+    status.uptime_secTotal = uptime;
+    status.uptime_day = uptime / 86400;
+    status.uptime_hour = uptime % 86400 / 3600;
+    status.uptime_min = uptime % 3600 / 60;
+    status.uptime_sec = uptime % 60;
 
-    status.loadAvg = v_tmp;
+    std::copy(_snapshot.getLoadAvg().begin(), _snapshot.getLoadAvg().end(), _loadAvg.begin());
+    status.loadAvg = _loadAvg;
 
     calculatePCPU();
 
     status.writeAll();
-    logger->sendMessage("System data updated", logging::LogLevel::DEBUG);
+    updateNuma();
+    logging::send(logger, logging::LogLevel::DEBUG, [] { return std::string("System data updated"); });
 
     trigger.read();
   }
-#ifndef WITH_PROCPS
-  procps_meminfo_unref(&meminfoptr);
-  procps_stat_unref(&infoptr);
-#endif
 }
 
-#ifdef WITH_PROCPS
 void SystemInfoModule::calculatePCPU() {
-  unsigned long long total;
-  double tmp;
-  std::vector<double> usage_tmp(info.nCPU + 1);
-  std::vector<cpu> vcpu(info.nCPU + 1);
-  readCPUInfo(vcpu);
-  auto lastcpu = lastInfo.begin();
-  auto newcpu = vcpu.begin();
-  for(size_t iCPU = 0; iCPU < (info.nCPU + 1); iCPU++) {
-    if(newcpu->totalUser < lastcpu->totalUser || newcpu->totalUserLow < lastcpu->totalUserLow ||
-        newcpu->totalSys < lastcpu->totalSys || newcpu->totalIdle < lastcpu->totalIdle) {
-      // Overflow detection. Just skip this value.
-      usage_tmp.at(iCPU) = (-1.0);
-    }
-    else {
-      total = (newcpu->totalUser - lastcpu->totalUser) + (newcpu->totalUserLow - lastcpu->totalUserLow) +
-          (newcpu->totalSys - lastcpu->totalSys);
-      tmp = total;
-      total += (newcpu->totalIdle - lastcpu->totalIdle);
-      tmp /= total;
-      tmp *= 100.;
-      usage_tmp.at(iCPU) = tmp;
-    }
-    *lastcpu = *newcpu;
-    lastcpu++;
-    newcpu++;
+  _cpuLoad.update(_snapshot.getTotal(), _snapshot.getCpus());
+  std::pair<ctk::ArrayOutput<double>*, ctk::ScalarOutput<double>*> outputs[] = {
+      {status.cpu_use.get(), &status.cpu_useTotal}, {status.cpuIowait.get(), &status.cpuIowaitTotal},
+      {status.cpuIrq.get(), &status.cpuIrqTotal}, {status.cpuSoftirq.get(), &status.cpuSoftirqTotal},
+      {status.cpuSteal.get(), &status.cpuStealTotal}, {status.cpuGuest.get(), &status.cpuGuestTotal}};
+  for(size_t state = 0; state < CpuLoad::N_STATES; state++) {
+    outputs[state].first->operator=(_cpuLoad.get(CpuLoad::State(state)));
+    *outputs[state].second = _cpuLoad.getTotal(CpuLoad::State(state));
   }
-  status.cpu_useTotal = usage_tmp.back();
-  usage_tmp.pop_back();
-  status.cpu_use->operator=(usage_tmp);
-}
-
-void SystemInfoModule::readCPUInfo(std::vector<cpu>& vcpu) {
-  std::ifstream file("/proc/stat");
-  if(!file.is_open()) {
-    logger->sendMessage("Failed to open system file /proc/stat", logging::LogLevel::ERROR);
-    file.close();
-    return;
-  }
-  std::string::size_type sz = 0;
-  std::string line;
-  for(auto it = vcpu.begin(); it != vcpu.end(); it++) {
-    if(!std::getline(file, line)) {
-      logger->sendMessage("Could not find enough lines in /proc/stat", logging::LogLevel::ERROR);
-      file.close();
-      return;
-    }
-    auto strs = split_arguments(line);
-    if(strs.size() < 5) {
-      logger->sendMessage(
-          std::string("Line seems to contain not enough data. Line: ") + line, logging::LogLevel::ERROR);
-    }
-
-    try {
-      it->totalUser = std::stoull(strs.at(1), &sz, 0);
-      it->totalUserLow = std::stoull(strs.at(2), &sz, 0);
-      it->totalSys = std::stoull(strs.at(3), &sz, 0);
-      it->totalIdle = std::stoull(strs.at(4), &sz, 0);
-    }
-    catch(std::exception& e) {
-      std::stringstream ss;
-      ss << "Caught an exception: " << e.what() << "\n";
-
-      for(auto s : strs) {
-        ss << "String token: " << s << "\n";
-      }
-      logger->sendMessage(ss.str(), logging::LogLevel::ERROR);
-    }
+  ctk::ArrayOutput<double>* groups[] = {status.cpuSocket.get(), status.cpuNode.get(), status.cpuCoreType.get()};
+  for(size_t level = 0; level < CpuTopology::N_LEVELS; level++) {
+    _cpuLoad.aggregate(CpuLoad::USAGE, _topology.getMapping(CpuTopology::Level(level)), _groupUsage[level]);
+    *groups[level] = _groupUsage[level];
   }
 }
-#else
-void SystemInfoModule::calculatePCPU() {
-  std::vector<double> usage_tmp(info.nCPU);
-  std::vector<cpu> vcpu(info.nCPU + 1);
-  enum stat_item items[] = {STAT_TIC_SUM_DELTA_BUSY, STAT_TIC_SUM_DELTA_TOTAL};
-  struct stat_stack* stack;
-  struct stat_reaped* reaped = procps_stat_reap(infoptr, STAT_REAP_CPUS_ONLY, items, 2);
-  if(vcpu.size() != (size_t)(reaped->cpus->total + 1)) {
-    ctk::logic_error("Number of CPUs is wrong in SystemInfoModule::readCPUInfo");
-  }
-  stack = reaped->summary;
-  status.cpu_useTotal = 100. * STAT_VAL(0, ull_int, stack, info) / STAT_VAL(1, ull_int, stack, info);
 
-  for(size_t i = 0; i < info.nCPU; i++) {
-    stack = reaped->cpus->stacks[i];
-    usage_tmp.at(i) = 100. * STAT_VAL(0, ull_int, stack, info) / STAT_VAL(1, ull_int, stack, info);
+void SystemInfoModule::updateNuma() {
+  if(!info.numaNodes) return;
+  if(!_numa.update()) {
+    logger->sendMessage(
+        std::string("Failed to read NUMA node information: ") + _numa.getError(), logging::LogLevel::ERROR);
   }
-  status.cpu_use->operator=(usage_tmp);
+  auto now = std::chrono::steady_clock::now();
+  double dt = std::chrono::duration<double>(now - _lastNumaUpdate).count();
+  _lastNumaUpdate = now;
+  auto& nodes = _numa.getNodes();
+  for(size_t i = 0; i < nodes.size(); i++) {
+    auto& node = nodes[i];
+    auto& last = _lastNodes[i];
+    _nodeTotal[i] = node.total;
+    _nodeFree[i] = node.free;
+    _nodeUsed[i] = node.used;
+    _nodeMiss[i] = rate(node.numaMiss, last.numaMiss, dt);
+    _nodeForeign[i] = rate(node.numaForeign, last.numaForeign, dt);
+    _nodeOther[i] = rate(node.otherNode, last.otherNode, dt);
+    double local = rate(node.localNode, last.localNode, dt);
+    _nodeRemote[i] = local + _nodeOther[i] > 0 ? _nodeOther[i] / (local + _nodeOther[i]) * 100. : 0.;
+  }
+  _lastNodes = nodes;
+  *numa.memTotal = _nodeTotal;
+  *numa.memFree = _nodeFree;
+  *numa.memUsed = _nodeUsed;
+  *numa.numaMiss = _nodeMiss;
+  *numa.numaForeign = _nodeForeign;
+  *numa.otherNode = _nodeOther;
+  *numa.remoteShare = _nodeRemote;
+  numa.writeAll();
 }
-#endif
 
 std::string getTime(ctk::ApplicationModule* mod) {
   std::string str{"WATCHDOG_SERVER: "};
@@ -339,7 +369,8 @@ void FileSystemModule::mainLoop() {
       }
       else {
         status.disk_status = 0;
-        logger->sendMessage(std::string("Disc usage: ") + std::to_string(status.disk_usage), logging::LogLevel::DEBUG);
+        logging::send(logger, logging::LogLevel::DEBUG,
+            [&] { return std::string("Disc usage: ") + std::to_string(status.disk_usage); });
       }
       status.writeAll();
     }
@@ -347,10 +378,11 @@ void FileSystemModule::mainLoop() {
   }
 }
 
-NetworkModule::NetworkModule(const std::string& device, ctk::ModuleGroup* owner, const std::string& name,
-    const std::string& description, const std::unordered_set<std::string>& tags, const std::string& pathToTrigger)
-: ctk::ApplicationModule(owner, name, description, tags), trigger(this, pathToTrigger, "", "Trigger input") {
-  networkDeviceName = device;
+NetworkModule::NetworkModule(size_t slot, std::shared_ptr<NetStats> stats, ctk::ModuleGroup* owner,
+    const std::string& name, const std::string& description, const std::unordered_set<std::string>& tags,
+    const std::string& pathToTrigger)
+: ctk::ApplicationModule(owner, name, description, tags), trigger(this, pathToTrigger, "", "Trigger input"),
+  _slot(slot), _stats(std::move(stats)) {
   status.data.emplace_back(ctk::ScalarOutput<double>{&status, "rx_packates", "1/s", "Received packates.", {"DAQ"}});
   status.data.emplace_back(ctk::ScalarOutput<double>{&status, "tx_packates", "1/s", "Transmitted packates.", {"DAQ"}});
   status.data.emplace_back(ctk::ScalarOutput<double>{&status, "rx", "MiB/s", "Data rate receive.", {"DAQ", "history"}});
@@ -361,27 +393,50 @@ NetworkModule::NetworkModule(const std::string& device, ctk::ModuleGroup* owner,
   status.data.emplace_back(
       ctk::ScalarOutput<double>{&status, "tx_dropped", "1/s", "Dropped transmitted packates.", {"DAQ", "history"}});
   status.data.emplace_back(ctk::ScalarOutput<double>{&status, "collisions", "1/s", "Number of collisions.", {"DAQ"}});
+  status.data.emplace_back(
+      ctk::ScalarOutput<double>{&status, "rx_errors", "1/s", "Receive errors.", {"DAQ", "history"}});
+  status.data.emplace_back(
+      ctk::ScalarOutput<double>{&status, "tx_errors", "1/s", "Transmit errors.", {"DAQ", "history"}});
+  status.data.emplace_back(ctk::ScalarOutput<double>{&status, "rx_fifo", "1/s", "Receive fifo errors.", {"DAQ"}});
+  status.data.emplace_back(ctk::ScalarOutput<double>{&status, "tx_fifo", "1/s", "Transmit fifo errors.", {"DAQ"}});
+  status.data.emplace_back(
+      ctk::ScalarOutput<double>{&status, "rx_overruns", "1/s", "Receiver ring buffer overruns.", {"DAQ"}});
+  status.data.emplace_back(ctk::ScalarOutput<double>{
+      &status, "rx_missed", "1/s", "Packates missed by the receiver.", {"DAQ", "history"}});
+  status.data.emplace_back(
+      ctk::ScalarOutput<double>{&status, "multicast", "1/s", "Received multicast packates.", {"DAQ"}});
 }
 
 void NetworkModule::read() {
-  raw tmp((std::string)deviceName);
-  for(size_t i = 0; i < tmp.files.size(); i++) {
-    std::ifstream in(tmp.files.at(i));
-    if(!in.is_open()) {
-      logger->sendMessage(std::string("Failed to open: ") + tmp.files.at(i), logging::LogLevel::ERROR);
-      return;
-    }
-    tmp.time.at(i) = boost::posix_time::microsec_clock::local_time();
-    in >> tmp.data.at(i);
-    // check if this is the first reading and no data is stored yet in previousData
-    if(previousData.files.size() != 0) {
-      boost::posix_time::time_duration diff = tmp.time.at(i) - previousData.time.at(i);
-      status.data.at(i) =
-          1. * (tmp.data.at(i) - previousData.data.at(i)) / 1024 / 1024 / (diff.total_nanoseconds() / 1e9);
+  NetStats::Sample sample;
+  if(!_stats->get(trigger, _slot, sample)) {
+    logger->sendMessage(std::string("Failed to read network statistics: ") + _stats->getError(),
+        logging::LogLevel::ERROR);
+    _hasLast = false;
+    return;
+  }
+  // the device was plugged in, removed or renamed
+  if(sample.interface != networkDeviceName) {
+    logger->sendMessage(sample.interface.empty() ? "Network device " + networkDeviceName + " was removed." :
+                                                   "Monitoring network device " + sample.interface + ".",
+        logging::LogLevel::INFO);
+    networkDeviceName = sample.interface;
+    deviceName = networkDeviceName;
+    deviceName.write();
+  }
+  // check if this is the first reading of the device and no data is stored yet in _last
+  if(_hasLast && sample.generation == _last.generation) {
+    double dt = std::chrono::duration<double>(sample.time - _last.time).count();
+    for(size_t i = 0; i < status.data.size(); i++) {
+      auto counter = networkCounters[i].counter;
+      status.data.at(i) = rate(sample.counters.*counter, _last.counters.*counter, dt) * networkCounters[i].scale;
     }
-    in.close();
   }
-  previousData = raw(tmp);
+  else {
+    for(auto& data : status.data) data = 0;
+  }
+  _last = sample;
+  _hasLast = true;
   status.writeAll();
 }
 
@@ -394,3 +449,181 @@ void NetworkModule::mainLoop() {
     trigger.read();
   }
 }
+
+DiskStatsModule::DiskStatsModule(ctk::ModuleGroup* owner, const std::string& name, const std::string& description,
+    size_t nSpareSlots, const std::unordered_set<std::string>& tags, const std::string& pathToTrigger)
+: ctk::ApplicationModule(owner, name, description, tags), trigger(this, pathToTrigger, "", "Trigger input"),
+  _stats(DiskStats::findDevices().size() + nSpareSlots) {
+  size_t nSlots = _stats.getNames().size();
+  status.devices = std::make_unique<ctk::ArrayOutput<std::string>>(
+      &status, "devices", "", nSlots, "Device names, empty for unused elements");
+  for(auto& output : diskOutputs) {
+    status.*output.output = std::make_unique<ctk::ArrayOutput<double>>(&status, output.name, output.unit, nSlots,
+        output.description, std::unordered_set<std::string>{"DAQ", "history"});
+  }
+  _devices.resize(nSlots);
+  _values.assign(std::size(diskOutputs), std::vector<double>(nSlots));
+}
+
+void DiskStatsModule::updateDevices() {
+  auto& names = _stats.getNames();
+  for(size_t i = 0; i < names.size(); i++) {
+    if(names[i] == _devices[i]) continue;
+    if(!_devices[i].empty()) {
+      logger->sendMessage(std::string("Block device removed: ") + _devices[i], logging::LogLevel::INFO);
+    }
+    if(!names[i].empty()) {
+      logger->sendMessage(std::string("Block device added: ") + names[i], logging::LogLevel::INFO);
+    }
+  }
+  _devices = names;
+  *status.devices = _devices;
+  status.nDevices = std::count_if(_devices.begin(), _devices.end(), [](auto& device) { return !device.empty(); });
+}
+
+void DiskStatsModule::mainLoop() {
+  // start with the counters since boot, so the first rates are calculated from the first trigger
+  _stats.update();
+  updateDevices();
+  while(true) {
+    trigger.read();
+    if(!_stats.update()) {
+      logger->sendMessage(
+          std::string("Failed to read block device statistics: ") + _stats.getError(), logging::LogLevel::ERROR);
+    }
+    if(_stats.namesChanged()) updateDevices();
+    if(_stats.getNDropped() > status.nDropped) {
+      logger->sendMessage(std::to_string(_stats.getNDropped()) + " block devices are not published, increase the "
+              "number of spare slots.", logging::LogLevel::WARNING);
+    }
+    status.nDropped = _stats.getNDropped();
+    auto& rates = _stats.getRates();
+    for(size_t i = 0; i < std::size(diskOutputs); i++) {
+      auto& output = diskOutputs[i];
+      for(size_t slot = 0; slot < rates.size(); slot++) _values[i][slot] = rates[slot].*output.rate * output.scale;
+      *(status.*output.output) = _values[i];
+    }
+    status.writeAll();
+  }
+}
+
+PressureModule::PressureModule(ctk::ModuleGroup* owner, const std::string& name, const std::string& description,
+    const std::string& pathToEvents, const std::unordered_set<std::string>& tags, const std::string& pathToTrigger)
+: ctk::ApplicationModule(owner, name, description, tags), trigger(this, pathToTrigger, "", "Trigger input"),
+  psiEvents(this, pathToEvents, "", "PSI events"), _cgroupPath(Pressure::findCgroup()),
+  _cgroup(_cgroupPath, ".pressure") {}
+
+void PressureModule::publish(
+    Pressure& pressure, SourceGroup& group, std::array<Pressure::Values, Pressure::N_RESOURCES>& last) {
+  if(!pressure.update()) {
+    logging::send(logger, logging::LogLevel::DEBUG,
+        [&] { return std::string("Failed to read pressure information: ") + pressure.getError(); });
+  }
+  ResourceGroup* resources[] = {&group.cpu, &group.memory, &group.io};
+  for(size_t i = 0; i < Pressure::N_RESOURCES; i++) {
+    auto& values = pressure.get(Pressure::Resource(i));
+    struct {
+      StallGroup& output;
+      const Pressure::Stall& current;
+      uint64_t& lastTotal;
+    } stalls[] = {{resources[i]->some, values.some, last[i].some.total},
+        {resources[i]->full, values.full, last[i].full.total}};
+    for(auto& stall : stalls) {
+      stall.output.avg10 = stall.current.avg10;
+      stall.output.avg60 = stall.current.avg60;
+      stall.output.totalDelta = stall.current.total >= stall.lastTotal ? stall.current.total - stall.lastTotal : 0;
+      stall.lastTotal = stall.current.total;
+    }
+  }
+}
+
+void PressureModule::logStalls(unsigned int fired) {
+  auto now = std::chrono::steady_clock::now();
+  // the kernel reports a continuous stall at most once per window, so wait two windows before calling it ended
+  auto timeout = std::chrono::microseconds(2 * PressureTriggerModule::triggerWindow);
+  std::string started, ended;
+  for(size_t i = 0; i < Pressure::N_RESOURCES; i++) {
+    unsigned int bit = 1U << i;
+    if(fired & bit) {
+      _lastEvent[i] = now;
+      if(!(_stalled & bit)) started += std::string(started.empty() ? "" : ", ") + Pressure::names[i];
+      _stalled |= bit;
+    }
+    else if((_stalled & bit) && now - _lastEvent[i] > timeout) {
+      ended += std::string(ended.empty() ? "" : ", ") + Pressure::names[i];
+      _stalled &= ~bit;
+    }
+  }
+  if(!started.empty()) logger->sendMessage("Pressure stall detected: " + started, logging::LogLevel::INFO);
+  if(!ended.empty()) logger->sendMessage("Pressure stall ended: " + ended, logging::LogLevel::INFO);
+}
+
+void PressureModule::mainLoop() {
+  status.cgroupPath = _cgroupPath;
+  status.triggerEvents = 0;
+  // start with the stall time since boot, so the first delta is calculated from the first trigger
+  _system.update();
+  _cgroup.update();
+  for(size_t i = 0; i < Pressure::N_RESOURCES; i++) {
+    _lastSystem[i] = _system.get(Pressure::Resource(i));
+    _lastCgroup[i] = _cgroup.get(Pressure::Resource(i));
+  }
+
+  auto group = readAnyGroup();
+  while(true) {
+    publish(_system, system, _lastSystem);
+    if(!_cgroupPath.empty()) publish(_cgroup, cgroup, _lastCgroup);
+    writeAll();
+
+    // the trigger is used to notice the end of stalls, since no PSI events are reported then
+    auto id = group.readAny();
+    unsigned int fired = id == psiEvents.getId() ? (uint)psiEvents : 0;
+    logStalls(fired);
+    status.triggerEvents += std::bitset<Pressure::N_RESOURCES>(fired).count();
+  }
+}
+
+PressureTriggerModule::PressureTriggerModule(ctk::ModuleGroup* owner, const std::string& name,
+    const std::string& description, bool enableTriggers, const std::unordered_set<std::string>& tags)
+: ctk::ApplicationModule(owner, name, description, tags), _enableTriggers(enableTriggers) {}
+
+void PressureTriggerModule::mainLoop() {
+  if(_enableTriggers) {
+    for(size_t i = 0; i < Pressure::N_RESOURCES; i++) {
+      auto resource = Pressure::Resource(i);
+      if(_triggers.isAvailable(resource) && !_triggers.addTrigger(resource, false, triggerThreshold, triggerWindow)) {
+        logger->sendMessage(
+            std::string("PSI trigger not registered: ") + _triggers.getError(), logging::LogLevel::INFO);
+      }
+    }
+  }
+  events = 0;
+  nTriggers = _triggers.getNTriggers();
+  writeAll();
+
+  // Without triggers wait() only returns once the module is terminated.
+  while(true) {
+    auto fired = _triggers.wait(-1);
+    boost::this_thread::interruption_point();
+    if(_triggers.getNTriggers() != nTriggers) {
+      logger->sendMessage(std::string("PSI triggers removed: ") + _triggers.getError(), logging::LogLevel::WARNING);
+      nTriggers = _triggers.getNTriggers();
+      nTriggers.write();
+    }
+    if(fired) {
+      events = fired;
+      events.write();
+    }
+  }
+}
+
+void PressureTriggerModule::terminate() {
+  _triggers.interrupt();
+  ctk::ApplicationModule::terminate();
+}
+
+PressureGroup::PressureGroup(ctk::ModuleGroup* owner, const std::string& name, const std::string& description,
+    bool enableTriggers, const std::unordered_set<std::string>& tags, const std::string& pathToTrigger)
+: ctk::ModuleGroup(owner, name, description, tags),
+  triggers(this, "triggers", "Module waiting for the PSI triggers", enableTriggers),
+  pressure(this, ".", "Module reading the pressure stall information", "triggers/events", {}, pathToTrigger) {}
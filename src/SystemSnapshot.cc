@@ -0,0 +1,218 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * SystemSnapshot.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "SystemSnapshot.h"
+
+#include "ProcFile.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+namespace {
+  constexpr const char* fileNames[] = {"stat", "meminfo", "vmstat", "loadavg", "uptime"};
+
+  /** Fields of a cpu line in /proc/stat in the order they appear */
+  constexpr size_t nCpuFields = 10;
+  constexpr uint64_t SystemSnapshot::Cpu::*cpuFields[nCpuFields] = {&SystemSnapshot::Cpu::user,
+      &SystemSnapshot::Cpu::nice, &SystemSnapshot::Cpu::system, &SystemSnapshot::Cpu::idle,
+      &SystemSnapshot::Cpu::iowait, &SystemSnapshot::Cpu::irq, &SystemSnapshot::Cpu::softirq,
+      &SystemSnapshot::Cpu::steal, &SystemSnapshot::Cpu::guest, &SystemSnapshot::Cpu::guestNice};
+  constexpr std::vector<uint64_t> SystemSnapshot::CpuArray::*cpuArrayFields[nCpuFields] = {
+      &SystemSnapshot::CpuArray::user, &SystemSnapshot::CpuArray::nice, &SystemSnapshot::CpuArray::system,
+      &SystemSnapshot::CpuArray::idle, &SystemSnapshot::CpuArray::iowait, &SystemSnapshot::CpuArray::irq,
+      &SystemSnapshot::CpuArray::softirq, &SystemSnapshot::CpuArray::steal, &SystemSnapshot::CpuArray::guest,
+      &SystemSnapshot::CpuArray::guestNice};
+
+  /** Fields of /proc/meminfo that are used */
+  const std::pair<std::string_view, uint64_t SystemSnapshot::Memory::*> memoryFields[] = {
+      {"MemTotal", &SystemSnapshot::Memory::total}, {"MemFree", &SystemSnapshot::Memory::free},
+      {"MemAvailable", &SystemSnapshot::Memory::available}, {"Buffers", &SystemSnapshot::Memory::buffers},
+      {"Cached", &SystemSnapshot::Memory::cached}, {"SReclaimable", &SystemSnapshot::Memory::sReclaimable},
+      {"Shmem", &SystemSnapshot::Memory::shmem}, {"SwapTotal", &SystemSnapshot::Memory::swapTotal},
+      {"SwapFree", &SystemSnapshot::Memory::swapFree}, {"Dirty", &SystemSnapshot::Memory::dirty},
+      {"Writeback", &SystemSnapshot::Memory::writeback}, {"Slab", &SystemSnapshot::Memory::slab},
+      {"HugePages_Total", &SystemSnapshot::Memory::hugePagesTotal},
+      {"HugePages_Free", &SystemSnapshot::Memory::hugePagesFree},
+      {"Hugepagesize", &SystemSnapshot::Memory::hugePageSize}};
+
+  /** Fields of /proc/vmstat that are used, allocstall is handled separately */
+  const std::pair<std::string_view, uint64_t SystemSnapshot::Vmstat::*> vmstatFields[] = {
+      {"pgmajfault", &SystemSnapshot::Vmstat::majorFaults}, {"pswpin", &SystemSnapshot::Vmstat::swapIn},
+      {"pswpout", &SystemSnapshot::Vmstat::swapOut}, {"compact_stall", &SystemSnapshot::Vmstat::compactStalls}};
+} // namespace
+
+void SystemSnapshot::CpuArray::resize(size_t n) {
+  for(auto field : cpuArrayFields) (this->*field).resize(n, 0);
+}
+
+void SystemSnapshot::CpuArray::clear() {
+  for(auto field : cpuArrayFields) std::fill((this->*field).begin(), (this->*field).end(), 0);
+}
+
+SystemSnapshot::Cpu SystemSnapshot::CpuArray::get(size_t index) const {
+  Cpu cpu;
+  for(size_t i = 0; i < nCpuFields; ++i) cpu.*cpuFields[i] = (this->*cpuArrayFields[i])[index];
+  return cpu;
+}
+
+SystemSnapshot::SystemSnapshot(const std::string& procPath) : _procPath(procPath), _buffer(64 * 1024, '\0') {
+  for(size_t i = 0; i < N_FILES; ++i) {
+    _fds[i] = ::open((_procPath + "/" + fileNames[i]).c_str(), O_RDONLY | O_CLOEXEC);
+  }
+  _loadAvg.fill(0);
+}
+
+SystemSnapshot::~SystemSnapshot() {
+  close();
+}
+
+SystemSnapshot::SystemSnapshot(SystemSnapshot&& other) noexcept {
+  _fds.fill(-1);
+  *this = std::move(other);
+}
+
+SystemSnapshot& SystemSnapshot::operator=(SystemSnapshot&& other) noexcept {
+  if(this == &other) return *this;
+  close();
+  _procPath = std::move(other._procPath);
+  _fds = other._fds;
+  _buffer = std::move(other._buffer);
+  _total = other._total;
+  _cpus = std::move(other._cpus);
+  _memory = other._memory;
+  _vmstat = other._vmstat;
+  _loadAvg = other._loadAvg;
+  _uptime = other._uptime;
+  _bootTime = other._bootTime;
+  _error = std::move(other._error);
+  other._fds.fill(-1);
+  return *this;
+}
+
+void SystemSnapshot::close() {
+  for(auto& fd : _fds) {
+    if(fd >= 0) ::close(fd);
+    fd = -1;
+  }
+}
+
+bool SystemSnapshot::update() {
+  // parse all files even if one fails
+  bool ok = parseStat(read(STAT));
+  ok &= parseMeminfo(read(MEMINFO));
+  ok &= parseVmstat(read(VMSTAT));
+  ok &= parseLoadavg(read(LOADAVG));
+  ok &= parseUptime(read(UPTIME));
+  return ok;
+}
+
+std::string_view SystemSnapshot::read(File file) {
+  return procfs::readFile(_fds[file], _buffer);
+}
+
+bool SystemSnapshot::fail(File file, const char* reason) {
+  _error = _procPath + "/" + fileNames[file] + ": " + reason;
+  return false;
+}
+
+bool SystemSnapshot::parseStat(std::string_view data) {
+  if(data.empty()) return fail(STAT, "can not be read");
+  bool found = false;
+  _total = Cpu{};
+  _cpus.clear();
+  while(!data.empty()) {
+    auto line = procfs::nextLine(data);
+    if(line.substr(0, 3) == "cpu") {
+      line.remove_prefix(3);
+      // cpu is the summary, cpuN are the individual CPUs. Offline CPUs are not listed.
+      bool isTotal = !line.empty() && line.front() == ' ';
+      uint64_t index = 0;
+      if(!isTotal && !procfs::parseNumber(line, index)) return fail(STAT, "invalid cpu line");
+      // older kernels provide less fields, they are kept 0
+      uint64_t values[nCpuFields] = {};
+      for(auto& value : values) {
+        if(!procfs::parseNumber(line, value)) break;
+      }
+      if(isTotal) {
+        for(size_t i = 0; i < nCpuFields; ++i) _total.*cpuFields[i] = values[i];
+        found = true;
+      }
+      else {
+        if(index >= _cpus.size()) _cpus.resize(index + 1);
+        for(size_t i = 0; i < nCpuFields; ++i) (_cpus.*cpuArrayFields[i])[index] = values[i];
+      }
+    }
+    else if(line.substr(0, 6) == "btime ") {
+      line.remove_prefix(6);
+      procfs::parseNumber(line, _bootTime);
+    }
+  }
+  if(!found) return fail(STAT, "no cpu line found");
+  return true;
+}
+
+bool SystemSnapshot::parseMeminfo(std::string_view data) {
+  if(data.empty()) return fail(MEMINFO, "can not be read");
+  size_t found = 0;
+  while(!data.empty()) {
+    auto line = procfs::nextLine(data);
+    auto colon = line.find(':');
+    if(colon == std::string_view::npos) continue;
+    auto key = line.substr(0, colon);
+    for(auto& field : memoryFields) {
+      if(field.first != key) continue;
+      line.remove_prefix(colon + 1);
+      if(procfs::parseNumber(line, _memory.*field.second)) found++;
+      break;
+    }
+  }
+  // MemAvailable is missing in kernels older than 3.14, the other additional fields depend on the configuration
+  if(found < 8) return fail(MEMINFO, "missing fields");
+  return true;
+}
+
+bool SystemSnapshot::parseVmstat(std::string_view data) {
+  if(data.empty()) return fail(VMSTAT, "can not be read");
+  // kernels since 4.8 split allocstall by zone
+  _vmstat.allocStalls = 0;
+  while(!data.empty()) {
+    auto line = procfs::nextLine(data);
+    auto space = line.find(' ');
+    if(space == std::string_view::npos) continue;
+    auto key = line.substr(0, space);
+    line.remove_prefix(space);
+    if(key.substr(0, 10) == "allocstall") {
+      uint64_t value;
+      if(procfs::parseNumber(line, value)) _vmstat.allocStalls += value;
+      continue;
+    }
+    for(auto& field : vmstatFields) {
+      if(field.first != key) continue;
+      procfs::parseNumber(line, _vmstat.*field.second);
+      break;
+    }
+  }
+  return true;
+}
+
+bool SystemSnapshot::parseLoadavg(std::string_view data) {
+  if(data.empty()) return fail(LOADAVG, "can not be read");
+  for(auto& value : _loadAvg) {
+    if(!procfs::parseDecimal(data, value)) return fail(LOADAVG, "invalid format");
+  }
+  return true;
+}
+
+bool SystemSnapshot::parseUptime(std::string_view data) {
+  if(data.empty()) return fail(UPTIME, "can not be read");
+  if(!procfs::parseDecimal(data, _uptime)) return fail(UPTIME, "invalid format");
+  return true;
+}
@@ -10,6 +10,8 @@
 
 #include "WatchdogServer.h"
 
+#include "Logging.h"
+#include "SpawnHelper.h"
 #include "boost/filesystem.hpp"
 #include "version.h"
 
@@ -62,6 +64,22 @@ std::set<std::string> findNetworkDevices() {
 }
 
 WatchdogServer::WatchdogServer() : Application("WatchdogServer") {
+  // Fork the spawn helper before any module thread is running
+  if(config.get<uint>("Configuration/enableSpawnHelper", (uint)1) != 0) {
+    if(spawn::SpawnHelper::start()) {
+      std::cout << "Spawn helper started. Processes are started by the spawn helper." << std::endl;
+    }
+    else {
+      std::cerr << "Failed to start the spawn helper. Processes are started by forking the watchdog." << std::endl;
+    }
+  }
+  // Messages below this level are not even formatted (0: DEBUG, 1: INFO, 2: WARNING, 3: ERROR)
+  auto logLevel = config.get<uint>("Configuration/logLevel", (uint)0);
+  if(logLevel > (uint)logging::LogLevel::ERROR) {
+    std::cerr << "Invalid logLevel " << logLevel << " in the configuration, using 3 (ERROR)." << std::endl;
+    logLevel = (uint)logging::LogLevel::ERROR;
+  }
+  logging::setMessageThreshold(static_cast<logging::LogLevel>(logLevel));
   try {
     auto nProcesses = config.get<uint>("Configuration/numberOfProcesses");
     std::cout << "Adding " << nProcesses << " processes." << std::endl;
@@ -73,8 +91,6 @@ WatchdogServer::WatchdogServer() : Application("WatchdogServer") {
       else {
         processGroup.processes.emplace_back(&processGroup, processName, "process");
       }
-      processGroup.processesLogExternal.emplace_back(&processGroup, processName, "process external log",
-          "/Trigger/tick", "/processes/" + processName + "/config/logfileExternal");
     }
   }
   catch(std::out_of_range& e) {
@@ -86,8 +102,6 @@ WatchdogServer::WatchdogServer() : Application("WatchdogServer") {
     else {
       processGroup.processes.emplace_back(&processGroup, "0", "Test process");
     }
-    processGroup.processesLogExternal.emplace_back(
-        &processGroup, "0", "Process external log", "/Trigger/tick", "/processes/0/config/logfileExternal");
   }
 
   ProcessHandler::setupHandler();
@@ -101,13 +115,22 @@ WatchdogServer::WatchdogServer() : Application("WatchdogServer") {
         mountPoint.first, mountPoint.second, &filesystemGroup, name, "Filesystem monitor");
     i++;
   }
-  i = 0;
   auto net = findNetworkDevices();
-  for(auto& dev : net) {
-    std::string name = std::to_string(i);
-    std::cout << "Adding network monitor for device: " << dev << " -->" << name << std::endl;
-    networkGroup.networkMonitors.emplace_back(dev, &networkGroup, name, "Network monitor");
-    i++;
+  std::vector<std::string> devices(net.begin(), net.end());
+  networkGroup.stats->setSlots(devices, devices.size() + networkGroup.nSpareMonitors);
+  if(!networkGroup.stats->useNetlink()) {
+    std::cerr << "Network statistics are read from /proc/net/dev: " << networkGroup.stats->getError() << std::endl;
+  }
+  if(!networkGroup.stats->watchLinks()) {
+    std::cerr << "Network devices plugged in later are not monitored: " << networkGroup.stats->getError()
+              << std::endl;
+  }
+  for(size_t slot = 0; slot < devices.size() + networkGroup.nSpareMonitors; slot++) {
+    std::string name = std::to_string(slot);
+    if(slot < devices.size()) {
+      std::cout << "Adding network monitor for device: " << devices[slot] << " -->" << name << std::endl;
+    }
+    networkGroup.networkMonitors.emplace_back(slot, networkGroup.stats, &networkGroup, name, "Network monitor");
   }
 
   logging = logging::LoggingModule{this, "logging", "LoggingModule logging watchdog internal messages"};
@@ -17,6 +17,7 @@
 #endif
 #include <boost/algorithm/string.hpp>
 
+#include <dirent.h>
 #include <signal.h>
 #include <stdlib.h>
 
@@ -102,6 +103,19 @@ namespace proc_util {
     return nChild;
   }
 #endif
+
+  size_t getNFDs(const size_t& PID) {
+    std::string dirName = "/proc/" + std::to_string(PID) + "/fd";
+    DIR* dir = opendir(dirName.c_str());
+    if(dir == nullptr) return 0;
+    size_t nFDs = 0;
+    struct dirent* entry;
+    while((entry = readdir(dir)) != nullptr) {
+      if(entry->d_name[0] != '.') nFDs++;
+    }
+    closedir(dir);
+    return nFDs;
+  }
 } // namespace proc_util
 
 std::string space2underscore(std::string text) {
@@ -0,0 +1,170 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * benchmark_cpuLoad.cc
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Compare the time and the allocations per trigger needed to read /proc/stat and calculate the CPU usage, once like
+ *  before (ifstream, boost::split, std::stoull, array of structs) and once using SystemSnapshot and CpuLoad. The
+ *  /proc/stat files for 8, 64 and 512 cores are generated from the cpu lines of a recorded /proc/stat.
+ *  The files meminfo, vmstat, loadavg and uptime are read from the directory of the recorded /proc/stat.
+ *  Usage: benchmark_cpuLoad [recorded stat file, default: proc/stat]
+ */
+
+#include "CpuLoad.h"
+#include "SystemSnapshot.h"
+
+#include <boost/algorithm/string.hpp>
+
+#include <sys/stat.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+static size_t nAllocations = 0;
+
+void* operator new(size_t size) {
+  ++nAllocations;
+  if(void* p = std::malloc(size)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+/**
+ * Implementation used before SystemSnapshot and CpuLoad.
+ */
+struct Legacy {
+  struct cpu {
+    unsigned long long totalUser{0};
+    unsigned long long totalUserLow{0};
+    unsigned long long totalSys{0};
+    unsigned long long totalIdle{0};
+  };
+  std::string file;
+  size_t nCPU;
+  std::vector<cpu> lastInfo;
+  std::vector<double> usage;
+  double usageTotal{0};
+
+  Legacy(const std::string& fileName, size_t n) : file(fileName), nCPU(n), lastInfo(n + 1) {}
+
+  void readCPUInfo(std::vector<cpu>& vcpu) {
+    std::ifstream in(file);
+    std::string::size_type sz = 0;
+    std::string line;
+    for(auto it = vcpu.begin(); it != vcpu.end(); it++) {
+      if(!std::getline(in, line)) return;
+      std::vector<std::string> strs;
+      boost::split(strs, line, boost::is_any_of("\t "), boost::token_compress_on);
+      it->totalUser = std::stoull(strs.at(1), &sz, 0);
+      it->totalUserLow = std::stoull(strs.at(2), &sz, 0);
+      it->totalSys = std::stoull(strs.at(3), &sz, 0);
+      it->totalIdle = std::stoull(strs.at(4), &sz, 0);
+    }
+  }
+
+  void calculatePCPU() {
+    std::vector<double> usage_tmp(nCPU + 1);
+    std::vector<cpu> vcpu(nCPU + 1);
+    readCPUInfo(vcpu);
+    for(size_t iCPU = 0; iCPU < nCPU + 1; iCPU++) {
+      auto& now = vcpu.at(iCPU);
+      auto& last = lastInfo.at(iCPU);
+      unsigned long long total =
+          (now.totalUser - last.totalUser) + (now.totalUserLow - last.totalUserLow) + (now.totalSys - last.totalSys);
+      double tmp = total;
+      total += now.totalIdle - last.totalIdle;
+      usage_tmp.at(iCPU) = tmp / total * 100.;
+      last = now;
+    }
+    usageTotal = usage_tmp.front();
+    usage_tmp.erase(usage_tmp.begin());
+    usage = usage_tmp;
+  }
+};
+
+/**
+ * Create a directory with a stat file for nCpus cores using the cpu lines of the recorded file.
+ */
+std::string createProc(const std::string& recorded, size_t nCpus) {
+  std::ifstream in(recorded);
+  std::vector<std::string> cpuLines;
+  std::string line, total, rest;
+  while(std::getline(in, line)) {
+    if(line.rfind("cpu ", 0) == 0) total = line;
+    else if(line.rfind("cpu", 0) == 0) cpuLines.push_back(line.substr(line.find(' ')));
+    else rest += line + "\n";
+  }
+  if(cpuLines.empty()) throw std::runtime_error("No cpu lines found in " + recorded);
+  std::string dir = "benchmark_cpuLoad_" + std::to_string(nCpus);
+  mkdir(dir.c_str(), 0755);
+  std::ofstream out(dir + "/stat");
+  out << total << "\n";
+  for(size_t i = 0; i < nCpus; i++) out << "cpu" << i << cpuLines[i % cpuLines.size()] << "\n";
+  out << rest;
+  // the remaining files are taken from the directory of the recorded file
+  auto recordedDir = recorded.substr(0, recorded.find_last_of('/') + 1);
+  for(auto name : {"meminfo", "vmstat", "loadavg", "uptime"}) {
+    std::ifstream file(recordedDir + name);
+    std::ofstream copy(dir + "/" + name);
+    copy << file.rdbuf();
+  }
+  return dir;
+}
+
+template<class Function>
+void measure(const std::string& name, Function f, size_t nTicks) {
+  f();
+  size_t allocations = nAllocations;
+  auto start = std::chrono::steady_clock::now();
+  for(size_t i = 0; i < nTicks; i++) f();
+  std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start;
+  std::cout << std::setw(25) << name << std::setw(20) << (double)(nAllocations - allocations) / nTicks
+            << std::setw(15) << duration.count() / nTicks << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  std::string recorded = argc > 1 ? argv[1] : "proc/stat";
+  const size_t nTicks = 2000;
+  double sum = 0;
+  for(size_t nCpus : {8, 64, 512}) {
+    auto dir = createProc(recorded, nCpus);
+    std::cout << nCpus << " cores" << std::endl;
+    std::cout << std::setw(25) << "" << std::setw(20) << "allocations/tick" << std::setw(15) << "time/us" << std::endl;
+
+    Legacy legacy(dir + "/stat", nCpus);
+    measure("legacy read + calculate", [&]() { legacy.calculatePCPU(); }, nTicks);
+    sum += legacy.usageTotal;
+
+    SystemSnapshot snapshot(dir);
+    CpuLoad load(nCpus);
+    measure(
+        "snapshot + CpuLoad",
+        [&]() {
+          snapshot.update();
+          load.update(snapshot.getTotal(), snapshot.getCpus());
+        },
+        nTicks);
+    measure("CpuLoad only", [&]() { load.update(snapshot.getTotal(), snapshot.getCpus()); }, nTicks * 10);
+    sum += load.getTotal(CpuLoad::USAGE);
+
+    for(auto name : {"stat", "meminfo", "vmstat", "loadavg", "uptime"}) remove((dir + "/" + name).c_str());
+    rmdir(dir.c_str());
+  }
+  return sum == 12345.;
+}
@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * benchmark_logLevel.cc
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Count the allocations per trigger caused by the DEBUG messages send by the modules each trigger, once formatted
+ *  eagerly like before and once using logging::send. The messages are send to a logger that drops all messages, like
+ *  a LoggingModule with a log level above DEBUG.
+ *  Usage: benchmark_logLevel [number of processes]
+ */
+
+#include "Logging.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+
+static size_t nAllocations = 0;
+
+void* operator new(size_t size) {
+  ++nAllocations;
+  if(void* p = std::malloc(size)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+/**
+ * Logger dropping all messages.
+ */
+struct NullLogger {
+  size_t nMessages{0};
+  void sendMessage(const std::string&, const logging::LogLevel&) { ++nMessages; }
+};
+
+/**
+ * Values used in the messages of one trigger.
+ */
+struct TickData {
+  int pid{12345};
+  uint isRunning{1};
+  uint nFailed{0};
+  uint maxFails{5};
+  uint nRestarts{2};
+  uint maxRestarts{10};
+  double diskUsage{42.5};
+};
+
+/**
+ * DEBUG messages of one trigger of a running process, the system info module and a file system module.
+ */
+void eagerTick(NullLogger* logger, const TickData& d, size_t nProcesses) {
+  for(size_t i = 0; i < nProcesses; i++) {
+    logger->sendMessage(
+        std::string("Checking process status for process: ") + std::to_string(d.pid), logging::LogLevel::DEBUG);
+    logger->sendMessage(std::string("Process is running...") + std::to_string(d.isRunning) +
+            " PID: " + std::to_string(d.pid),
+        logging::LogLevel::DEBUG);
+    logger->sendMessage(
+        std::string("Process is running (PID: ") + std::to_string(d.pid) + ")", logging::LogLevel::DEBUG);
+  }
+  logger->sendMessage("System data updated", logging::LogLevel::DEBUG);
+  logger->sendMessage(std::string("Disc usage: ") + std::to_string(d.diskUsage), logging::LogLevel::DEBUG);
+}
+
+void lazyTick(NullLogger* logger, const TickData& d, size_t nProcesses) {
+  for(size_t i = 0; i < nProcesses; i++) {
+    logging::send(logger, logging::LogLevel::DEBUG,
+        [&] { return std::string("Checking process status for process: ") + std::to_string(d.pid); });
+    logging::send(logger, logging::LogLevel::DEBUG, [&] {
+      return std::string("Process is running...") + std::to_string(d.isRunning) + " PID: " + std::to_string(d.pid);
+    });
+    logging::send(logger, logging::LogLevel::DEBUG,
+        [&] { return std::string("Process is running (PID: ") + std::to_string(d.pid) + ")"; });
+  }
+  logging::send(logger, logging::LogLevel::DEBUG, [] { return std::string("System data updated"); });
+  logging::send(
+      logger, logging::LogLevel::DEBUG, [&] { return std::string("Disc usage: ") + std::to_string(d.diskUsage); });
+}
+
+template<class Function>
+void measure(const std::string& name, Function f, size_t nTicks) {
+  size_t allocations = nAllocations;
+  auto start = std::chrono::steady_clock::now();
+  for(size_t i = 0; i < nTicks; i++) f();
+  std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start;
+  std::cout << std::setw(25) << name << std::setw(20) << (double)(nAllocations - allocations) / nTicks
+            << std::setw(15) << duration.count() / nTicks << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  size_t nProcesses = argc > 1 ? std::stoul(argv[1]) : 8;
+  const size_t nTicks = 10000;
+  auto logger = std::make_unique<NullLogger>();
+  TickData data;
+
+  std::cout << nProcesses << " processes" << std::endl;
+  std::cout << std::setw(25) << "" << std::setw(20) << "allocations/tick" << std::setw(15) << "time/us" << std::endl;
+  logging::setMessageThreshold(logging::LogLevel::DEBUG);
+  measure("eager", [&]() { eagerTick(logger.get(), data, nProcesses); }, nTicks);
+  measure("lazy (threshold DEBUG)", [&]() { lazyTick(logger.get(), data, nProcesses); }, nTicks);
+  logging::setMessageThreshold(logging::LogLevel::INFO);
+  measure("lazy (threshold INFO)", [&]() { lazyTick(logger.get(), data, nProcesses); }, nTicks);
+  return logger->nMessages == 0;
+}
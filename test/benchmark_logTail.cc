@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * benchmark_logTail.cc
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Compare logging::formatLogTail and logging::readLogTail for different file sizes and tail lengths.
+ *  Usage: benchmark_logTail [file size in MB ...]
+ */
+
+#include "Logging.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+const std::string fileName = "/tmp/benchmark_logTail.log";
+
+void createFile(size_t sizeMB) {
+  std::ofstream file(fileName, std::ios::trunc);
+  std::string line = "INFO::/benchmark: 2026-10-19 12:00:00 Message with some text to get a realistic length ";
+  size_t written = 0;
+  for(size_t i = 0; written < sizeMB * 1024 * 1024; i++) {
+    file << line << i << "\n";
+    written += line.size() + 8;
+  }
+}
+
+template<class Function>
+double measure(Function f, size_t nRepetitions) {
+  auto start = std::chrono::steady_clock::now();
+  for(size_t i = 0; i < nRepetitions; i++) f();
+  std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+  return duration.count() / nRepetitions;
+}
+
+int main(int argc, char* argv[]) {
+  std::vector<size_t> sizes = {1, 16, 256};
+  if(argc > 1) {
+    sizes.clear();
+    for(int i = 1; i < argc; i++) sizes.push_back(std::stoul(argv[i]));
+  }
+  std::vector<size_t> tailLengths = {10, 100, 1000};
+  const size_t nRepetitions = 20;
+
+  std::cout << std::setw(10) << "size/MB" << std::setw(10) << "lines" << std::setw(20) << "formatLogTail/ms"
+            << std::setw(20) << "readLogTail/ms" << std::endl;
+  for(auto size : sizes) {
+    createFile(size);
+    for(auto tailLength : tailLengths) {
+      std::string reference, result;
+      double tStream = measure(
+          [&]() {
+            std::ifstream file(fileName);
+            std::stringstream out;
+            logging::formatLogTail(file, out, tailLength);
+            reference = out.str();
+          },
+          nRepetitions);
+      double tBlock = measure(
+          [&]() {
+            std::stringstream out;
+            logging::readLogTail(fileName, out, tailLength);
+            result = out.str();
+          },
+          nRepetitions);
+      std::cout << std::setw(10) << size << std::setw(10) << tailLength << std::setw(20) << tStream << std::setw(20)
+                << tBlock << (reference == result ? "" : "  (results differ!)") << std::endl;
+    }
+  }
+  remove(fileName.c_str());
+  return 0;
+}
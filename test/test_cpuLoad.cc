@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_cpuLoad.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE CpuLoadTest
+
+#include "CpuLoad.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test_framework;
+
+BOOST_AUTO_TEST_CASE(testShares) {
+  SystemSnapshot::Cpu total;
+  SystemSnapshot::CpuArray cpus;
+  cpus.resize(2);
+  CpuLoad load(3);
+  load.update(total, cpus);
+
+  // cpu0: 100 ticks, 40 busy (10 of them irq) and 20 iowait, 5 of the user ticks are guest time
+  cpus.user[0] = 25;
+  cpus.guest[0] = 5;
+  cpus.system[0] = 5;
+  cpus.irq[0] = 10;
+  cpus.iowait[0] = 20;
+  cpus.idle[0] = 40;
+  // cpu1: 50 ticks, 25 stolen
+  cpus.steal[1] = 25;
+  cpus.idle[1] = 25;
+  total = cpus.get(0);
+  total.steal = 25;
+  total.idle += 25;
+  load.update(total, cpus);
+
+  BOOST_CHECK_CLOSE(load.get(CpuLoad::USAGE)[0], 40., 1e-9);
+  BOOST_CHECK_CLOSE(load.get(CpuLoad::IOWAIT)[0], 20., 1e-9);
+  BOOST_CHECK_CLOSE(load.get(CpuLoad::IRQ)[0], 10., 1e-9);
+  BOOST_CHECK_CLOSE(load.get(CpuLoad::GUEST)[0], 5., 1e-9);
+  BOOST_CHECK_EQUAL(load.get(CpuLoad::SOFTIRQ)[0], 0.);
+  BOOST_CHECK_CLOSE(load.get(CpuLoad::USAGE)[1], 50., 1e-9);
+  BOOST_CHECK_CLOSE(load.get(CpuLoad::STEAL)[1], 50., 1e-9);
+  // cpu2 is not found -> no ticks passed
+  BOOST_CHECK_EQUAL(load.get(CpuLoad::USAGE)[2], 0.);
+  BOOST_CHECK_CLOSE(load.getTotal(CpuLoad::USAGE), 65. / 150 * 100, 1e-9);
+  BOOST_CHECK_CLOSE(load.getTotal(CpuLoad::STEAL), 25. / 150 * 100, 1e-9);
+
+  // no ticks passed
+  load.update(total, cpus);
+  BOOST_CHECK_EQUAL(load.get(CpuLoad::USAGE)[0], 0.);
+  BOOST_CHECK_EQUAL(load.getTotal(CpuLoad::USAGE), 0.);
+
+  // ticks decreased, e.g. cpu1 went offline
+  cpus.user[0] += 10;
+  cpus.resize(1);
+  load.update(total, cpus);
+  BOOST_CHECK_CLOSE(load.get(CpuLoad::USAGE)[0], 100., 1e-9);
+  BOOST_CHECK_EQUAL(load.get(CpuLoad::USAGE)[1], -1.);
+  BOOST_CHECK_EQUAL(load.get(CpuLoad::STEAL)[1], -1.);
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_cpuTopology.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE CpuTopologyTest
+
+#include "CpuLoad.h"
+#include "CpuTopology.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test_framework;
+
+BOOST_AUTO_TEST_CASE(testParseList) {
+  BOOST_CHECK(CpuTopology::parseList("0-3,8,10-11") == std::vector<size_t>({0, 1, 2, 3, 8, 10, 11}));
+  BOOST_CHECK(CpuTopology::parseList("").empty());
+  BOOST_CHECK(CpuTopology::parseList("x,2") == std::vector<size_t>({2}));
+}
+
+BOOST_AUTO_TEST_CASE(testRecorded) {
+  // 2 sockets, 2 NUMA nodes, cpu0 and cpu2 are performance cores
+  CpuTopology topology(5, "sys");
+  BOOST_CHECK(topology.getGroups(CpuTopology::SOCKET) == std::vector<std::string>({"0", "1"}));
+  BOOST_CHECK(topology.getGroups(CpuTopology::NODE) == std::vector<std::string>({"0", "1"}));
+  // cpu4 is not found in sys
+  BOOST_CHECK(topology.getGroups(CpuTopology::CORE_TYPE) == std::vector<std::string>({"core", "atom", "default"}));
+  BOOST_CHECK(topology.getMapping(CpuTopology::SOCKET) == std::vector<size_t>({0, 0, 1, 1, 0}));
+  BOOST_CHECK(topology.getMapping(CpuTopology::NODE) == std::vector<size_t>({0, 0, 1, 1, 0}));
+  BOOST_CHECK(topology.getMapping(CpuTopology::CORE_TYPE) == std::vector<size_t>({0, 1, 0, 1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(testMissing) {
+  CpuTopology topology(2, "missing");
+  for(auto level : {CpuTopology::SOCKET, CpuTopology::NODE, CpuTopology::CORE_TYPE}) {
+    BOOST_CHECK_EQUAL(topology.getGroups(level).size(), 1);
+    BOOST_CHECK(topology.getMapping(level) == std::vector<size_t>({0, 0}));
+  }
+  BOOST_CHECK_EQUAL(topology.getGroups(CpuTopology::CORE_TYPE).front(), "default");
+}
+
+BOOST_AUTO_TEST_CASE(testAggregate) {
+  CpuTopology topology(4, "sys");
+  SystemSnapshot::Cpu total;
+  SystemSnapshot::CpuArray cpus;
+  cpus.resize(4);
+  CpuLoad load(4);
+  load.update(total, cpus);
+
+  // node 1 is fully loaded, node 0 is idle
+  cpus.idle[0] = cpus.idle[1] = 100;
+  cpus.user[2] = cpus.user[3] = 100;
+  total.idle = total.user = 200;
+  load.update(total, cpus);
+  BOOST_CHECK_CLOSE(load.getTotal(CpuLoad::USAGE), 50., 1e-9);
+
+  std::vector<double> nodes(2);
+  load.aggregate(CpuLoad::USAGE, topology.getMapping(CpuTopology::NODE), nodes);
+  BOOST_CHECK_EQUAL(nodes[0], 0.);
+  BOOST_CHECK_CLOSE(nodes[1], 100., 1e-9);
+  std::vector<double> types(2);
+  load.aggregate(CpuLoad::USAGE, topology.getMapping(CpuTopology::CORE_TYPE), types);
+  BOOST_CHECK_CLOSE(types[0], 50., 1e-9);
+  BOOST_CHECK_CLOSE(types[1], 50., 1e-9);
+
+  // ticks of node 1 decreased
+  cpus.user[2] = cpus.user[3] = 0;
+  cpus.idle[0] = cpus.idle[1] = 150;
+  load.update(total, cpus);
+  load.aggregate(CpuLoad::USAGE, topology.getMapping(CpuTopology::NODE), nodes);
+  BOOST_CHECK_EQUAL(nodes[0], 0.);
+  BOOST_CHECK_EQUAL(nodes[1], -1.);
+}
@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_diskStats.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE DiskStatsTest
+
+#include "DiskStats.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+
+using namespace boost::unit_test_framework;
+namespace bfs = boost::filesystem;
+
+BOOST_AUTO_TEST_CASE(testRecorded) {
+  // partitions and loop devices are skipped
+  BOOST_CHECK(DiskStats::findDevices("disks", "disks") == std::vector<std::string>({"nvme0n1", "sda"}));
+  DiskStats stats(3, "disks", "disks");
+  BOOST_REQUIRE_MESSAGE(stats.update(), stats.getError());
+  BOOST_CHECK(stats.getNames() == std::vector<std::string>({"nvme0n1", "sda", ""}));
+  BOOST_CHECK(stats.namesChanged());
+  BOOST_CHECK_EQUAL(stats.getRates()[0].readIOPS, 0.);
+  BOOST_CHECK_EQUAL(stats.getRates()[0].inFlight, 0.);
+
+  DiskStats moved(std::move(stats));
+  BOOST_CHECK_EQUAL(moved.getNames()[1], "sda");
+}
+
+BOOST_AUTO_TEST_CASE(testRates) {
+  // the file is kept open, so rewriting it in place changes the next update
+  bfs::path dir("test_diskStats.d");
+  bfs::remove_all(dir);
+  for(auto device : {"sda", "sdb", "nvme0n1"}) bfs::create_directories(dir / "block" / device);
+  auto write = [&](const std::string& content) {
+    std::ofstream out((dir / "diskstats").string());
+    out << content;
+  };
+  write("8 0 sda 100 0 1000 50 10 0 2048 40 0 500 900\n"
+        "259 0 nvme0n1 0 0 0 0 0 0 0 0 0 0 0\n");
+  DiskStats stats(2, dir.string(), dir.string());
+  auto start = std::chrono::steady_clock::now();
+  BOOST_REQUIRE(stats.update(start));
+
+  // 2 s later: 200 reads with 4096 sectors in 100 ms, 20 writes in 60 ms, busy for 1 s, weighted 3 s
+  write("8 0 sda 300 0 5096 150 30 0 4096 100 3 1500 3900\n"
+        "259 0 nvme0n1 0 0 0 0 0 0 0 0 0 0 0\n");
+  BOOST_REQUIRE(stats.update(start + std::chrono::seconds(2)));
+  BOOST_CHECK(!stats.namesChanged());
+  auto& sda = stats.getRates()[0];
+  BOOST_CHECK_CLOSE(sda.readIOPS, 100., 1e-9);
+  BOOST_CHECK_CLOSE(sda.writeIOPS, 10., 1e-9);
+  BOOST_CHECK_CLOSE(sda.readBytes, 4096. * 512 / 2, 1e-9);
+  BOOST_CHECK_CLOSE(sda.writeBytes, 2048. * 512 / 2, 1e-9);
+  BOOST_CHECK_CLOSE(sda.readLatency, 0.5, 1e-9);
+  BOOST_CHECK_CLOSE(sda.writeLatency, 3., 1e-9);
+  BOOST_CHECK_CLOSE(sda.queueDepth, 1.5, 1e-9);
+  BOOST_CHECK_EQUAL(sda.inFlight, 3.);
+  BOOST_CHECK_CLOSE(sda.utilisation, 50., 1e-9);
+
+  // sda is removed and sdb is plugged in, it uses the free slot
+  write("259 0 nvme0n1 0 0 0 0 0 0 0 0 0 0 0\n"
+        "8 16 sdb 10 0 80 5 0 0 0 0 0 5 5\n");
+  BOOST_REQUIRE(stats.update(start + std::chrono::seconds(3)));
+  BOOST_CHECK(stats.namesChanged());
+  BOOST_CHECK(stats.getNames() == std::vector<std::string>({"sdb", "nvme0n1"}));
+  BOOST_CHECK_EQUAL(stats.getRates()[0].readIOPS, 0.);
+  BOOST_CHECK_EQUAL(stats.getRates()[0].inFlight, 0.);
+  BOOST_CHECK_EQUAL(stats.getNDropped(), 0);
+
+  // no free slot left for sda
+  write("8 0 sda 1 0 0 0 0 0 0 0 0 0 0\n"
+        "259 0 nvme0n1 0 0 0 0 0 0 0 0 0 0 0\n"
+        "8 16 sdb 20 0 80 5 0 0 0 0 0 5 5\n");
+  BOOST_REQUIRE(stats.update(start + std::chrono::seconds(4)));
+  BOOST_CHECK(!stats.namesChanged());
+  BOOST_CHECK_EQUAL(stats.getNDropped(), 1);
+  BOOST_CHECK_CLOSE(stats.getRates()[0].readIOPS, 10., 1e-9);
+
+  write("259 0 nvme0n1 0 0 0 x\n");
+  BOOST_CHECK(!stats.update(start + std::chrono::seconds(5)));
+  BOOST_CHECK_EQUAL(stats.getError(), (dir / "diskstats").string() + ": invalid line for nvme0n1");
+  BOOST_CHECK_EQUAL(stats.getNames()[1], "nvme0n1");
+  bfs::remove_all(dir);
+
+  DiskStats missing(1, dir.string(), dir.string());
+  BOOST_CHECK(!missing.update());
+}
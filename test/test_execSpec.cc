@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_execSpec.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ExecSpecTest
+
+#include "ExecSpec.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+using namespace boost::unit_test_framework;
+
+BOOST_AUTO_TEST_CASE(testParseArguments) {
+  auto args = ExecSpec::parseArguments("  myServer --name \"my server\" --opt 'a b' c\\ d \"\" ");
+  std::vector<std::string> expected = {"myServer", "--name", "my server", "--opt", "a b", "c d", ""};
+  BOOST_CHECK_EQUAL_COLLECTIONS(args.begin(), args.end(), expected.begin(), expected.end());
+
+  args = ExecSpec::parseArguments("\"a \\\"quoted\\\" \\n\" 'no \\escape'");
+  expected = {"a \"quoted\" \\n", "no \\escape"};
+  BOOST_CHECK_EQUAL_COLLECTIONS(args.begin(), args.end(), expected.begin(), expected.end());
+
+  args = ExecSpec::parseArguments("A=1,B=\"x,y\",,C=3", ",");
+  expected = {"A=1", "B=x,y", "C=3"};
+  BOOST_CHECK_EQUAL_COLLECTIONS(args.begin(), args.end(), expected.begin(), expected.end());
+
+  BOOST_CHECK_THROW(ExecSpec::parseArguments("a \"b"), std::runtime_error);
+  BOOST_CHECK_THROW(ExecSpec::parseArguments("a b\\"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testArrays) {
+  ExecSpec spec("/bin", "sleep 'a b'");
+  BOOST_CHECK_EQUAL(spec.getFile(), "/bin/sleep");
+  BOOST_CHECK_EQUAL(std::string(spec.getArgv()[0]), "sleep");
+  BOOST_CHECK_EQUAL(std::string(spec.getArgv()[1]), "a b");
+  BOOST_CHECK(spec.getArgv()[2] == nullptr);
+  BOOST_CHECK(spec.getEnvp()[spec.getEnv().size()] == nullptr);
+  BOOST_CHECK(spec.matches("/bin", "sleep 'a b'", "", false));
+  BOOST_CHECK(!spec.matches("/bin", "sleep 'a b'", "", true));
+  BOOST_CHECK_THROW(ExecSpec("/bin", " "), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testEnvironment) {
+  setenv("EXECSPEC_TEST", "old", 1);
+  auto hasEntry = [](const ExecSpec& spec, const std::string& entry) {
+    auto& env = spec.getEnv();
+    return std::find(env.begin(), env.end(), entry) != env.end();
+  };
+  ExecSpec extend("/bin", "true", "EXECSPEC_TEST=new,EXECSPEC_NEW=\"a,b\",invalid", false);
+  BOOST_CHECK(hasEntry(extend, "EXECSPEC_TEST=old"));
+  BOOST_CHECK(!hasEntry(extend, "EXECSPEC_TEST=new"));
+  BOOST_CHECK(hasEntry(extend, "EXECSPEC_NEW=a,b"));
+  BOOST_CHECK_EQUAL(extend.getIgnoredEnv().size(), 1);
+  BOOST_CHECK_EQUAL(extend.getIgnoredEnv().front(), "invalid");
+
+  ExecSpec overwrite("/bin", "true", "EXECSPEC_TEST=new", true);
+  BOOST_CHECK(!hasEntry(overwrite, "EXECSPEC_TEST=old"));
+  BOOST_CHECK(hasEntry(overwrite, "EXECSPEC_TEST=new"));
+  // the environment of the calling process is not changed
+  BOOST_CHECK_EQUAL(std::string(getenv("EXECSPEC_TEST")), "old");
+}
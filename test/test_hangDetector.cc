@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_hangDetector.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE HangDetectorTest
+
+#include "HangDetector.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+using namespace boost::unit_test_framework;
+
+BOOST_AUTO_TEST_CASE(testTimeout) {
+  HangDetector detector;
+  auto t0 = std::chrono::steady_clock::now();
+  BOOST_CHECK_EQUAL(detector.update(10, 5, t0), false);
+  BOOST_CHECK_EQUAL(detector.update(10, 5, t0 + std::chrono::seconds(5)), false);
+  BOOST_CHECK_EQUAL(detector.update(10, 5, t0 + std::chrono::seconds(6)), true);
+  // progress resets the timeout
+  BOOST_CHECK_EQUAL(detector.update(11, 5, t0 + std::chrono::seconds(7)), false);
+  BOOST_CHECK_EQUAL(detector.update(11, 5, t0 + std::chrono::seconds(12)), false);
+  BOOST_CHECK_EQUAL(detector.update(11, 5, t0 + std::chrono::seconds(13)), true);
+  // timeout 0 disables the detection
+  BOOST_CHECK_EQUAL(detector.update(11, 0, t0 + std::chrono::seconds(100)), false);
+}
+
+BOOST_AUTO_TEST_CASE(testReset) {
+  HangDetector detector;
+  auto t0 = std::chrono::steady_clock::now();
+  BOOST_CHECK_EQUAL(detector.hasHeartbeat(), false);
+  detector.update(10, 5, t0);
+  BOOST_CHECK_EQUAL(detector.hasHeartbeat(), true);
+  BOOST_CHECK_EQUAL(detector.update(10, 5, t0 + std::chrono::seconds(10)), true);
+  detector.reset();
+  BOOST_CHECK_EQUAL(detector.hasHeartbeat(), false);
+  BOOST_CHECK_EQUAL(detector.getStallTime(t0 + std::chrono::seconds(10)), 0.);
+  // after a reset the timeout is counted from the first heartbeat
+  BOOST_CHECK_EQUAL(detector.update(10, 5, t0 + std::chrono::seconds(10)), false);
+  BOOST_CHECK_EQUAL(detector.update(10, 5, t0 + std::chrono::seconds(14)), false);
+  BOOST_CHECK_EQUAL(detector.getStallTime(t0 + std::chrono::seconds(14)), 4.);
+  // passing the last heartbeat again is no progress
+  BOOST_CHECK_EQUAL(detector.getLastHeartbeat(), 10);
+  BOOST_CHECK_EQUAL(detector.update(detector.getLastHeartbeat(), 5, t0 + std::chrono::seconds(16)), true);
+}
+
+BOOST_AUTO_TEST_CASE(testHeartbeatFile) {
+  std::string fileName("test_heartbeat.dat");
+  uint64_t heartbeat{0};
+  std::remove(fileName.c_str());
+  BOOST_CHECK_EQUAL(HangDetector::readHeartbeat(HangDetector::Source::FileMTime, fileName, heartbeat), false);
+  BOOST_CHECK_EQUAL(HangDetector::readHeartbeat(HangDetector::Source::Counter, fileName, heartbeat), false);
+
+  uint64_t counter = 42;
+  {
+    std::ofstream out(fileName, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&counter), sizeof(counter));
+  }
+  BOOST_CHECK_EQUAL(HangDetector::readHeartbeat(HangDetector::Source::Counter, fileName, heartbeat), true);
+  BOOST_CHECK_EQUAL(heartbeat, 42);
+
+  uint64_t mtime{0};
+  BOOST_CHECK_EQUAL(HangDetector::readHeartbeat(HangDetector::Source::FileMTime, fileName, mtime), true);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  {
+    std::ofstream out(fileName, std::ios::binary | std::ios::app);
+    out << "x";
+  }
+  BOOST_CHECK_EQUAL(HangDetector::readHeartbeat(HangDetector::Source::FileMTime, fileName, heartbeat), true);
+  BOOST_CHECK(heartbeat > mtime);
+  BOOST_CHECK_EQUAL(HangDetector::readHeartbeat(HangDetector::Source::CPUTime, fileName, heartbeat), false);
+  std::remove(fileName.c_str());
+}
@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_logIndex.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE LogIndexTest
+
+#include "LogIndex.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace boost::unit_test_framework;
+
+const std::string fileName = "test_logIndex.log";
+
+std::string line(size_t i) {
+  return "line " + std::to_string(i) + "\n";
+}
+
+void write(size_t first, size_t n, std::ios::openmode mode = std::ios::app) {
+  std::ofstream out(fileName, mode);
+  for(size_t i = first; i < first + n; i++) out << line(i);
+}
+
+/**
+ * Changes are reported asynchronously by the LogWatchReactor, so retry for a while.
+ */
+bool waitForUpdate(LogIndex& index) {
+  for(size_t i = 0; i < 200; i++) {
+    if(index.update(fileName)) return true;
+    usleep(10000);
+  }
+  return false;
+}
+
+std::string lines(size_t first, size_t n) {
+  std::string result;
+  for(size_t i = first; i < first + n; i++) result += line(i);
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(testParseTimestamp) {
+  int64_t time = 0;
+  BOOST_CHECK(LogIndex::parseTimestamp("1970-01-01 00:00:00 start", time));
+  BOOST_CHECK_EQUAL(time, 0);
+  BOOST_CHECK(LogIndex::parseTimestamp("2026-10-19 12:34:56 INFO", time));
+  BOOST_CHECK_EQUAL(time, 1792413296);
+  BOOST_CHECK(LogIndex::parseTimestamp("2026-10-19T12:34:56.123Z", time));
+  BOOST_CHECK_EQUAL(time, 1792413296);
+  BOOST_CHECK(LogIndex::parseTimestamp("[2026-Oct-19 12:34:56.000123] WARNING", time));
+  BOOST_CHECK_EQUAL(time, 1792413296);
+  BOOST_CHECK(LogIndex::parseTimestamp("2024-02-29 00:00:00", time));
+  BOOST_CHECK_EQUAL(time, 1709164800);
+  BOOST_CHECK(!LogIndex::parseTimestamp("INFO 2026-10-19 12:34:56", time));
+  BOOST_CHECK(!LogIndex::parseTimestamp("2026-10-19", time));
+  BOOST_CHECK(!LogIndex::parseTimestamp("2026-13-19 12:34:56", time));
+  BOOST_CHECK(!LogIndex::parseTimestamp("2026-Foo-19 12:34:56", time));
+  BOOST_CHECK(!LogIndex::parseTimestamp("", time));
+}
+
+BOOST_AUTO_TEST_CASE(testReadLines) {
+  write(0, 1000, std::ios::trunc);
+  LogIndex index(16);
+  BOOST_CHECK(index.update(fileName));
+  BOOST_CHECK_EQUAL(index.getNLines(), 1000);
+  BOOST_CHECK(!index.update(fileName));
+  BOOST_CHECK_EQUAL(index.readLines(0, 3), lines(0, 3));
+  // lines before and after an index entry
+  BOOST_CHECK_EQUAL(index.readLines(15, 2), lines(15, 2));
+  BOOST_CHECK_EQUAL(index.readLines(517, 100), lines(517, 100));
+  BOOST_CHECK_EQUAL(index.readLines(990, 100), lines(990, 10));
+  BOOST_CHECK_EQUAL(index.readLines(1000, 1), "");
+  // only complete lines fit
+  BOOST_CHECK_EQUAL(index.readLines(100, 10, line(100).size() * 3 + 1), lines(100, 3));
+  // the first line is cut
+  BOOST_CHECK_EQUAL(index.readLines(100, 10, 3), "lin");
+
+  // an incomplete line is not indexed
+  {
+    std::ofstream out(fileName, std::ios::app);
+    out << "line 1000";
+  }
+  BOOST_CHECK(!index.update(fileName));
+  {
+    std::ofstream out(fileName, std::ios::app);
+    out << "\n";
+  }
+  BOOST_CHECK(waitForUpdate(index));
+  BOOST_CHECK_EQUAL(index.getNLines(), 1001);
+  BOOST_CHECK_EQUAL(index.readLines(999, 5), lines(999, 2));
+  remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(testLongLines) {
+  // lines are split between the chunks read from the file
+  std::string longLine(100000, 'x');
+  {
+    std::ofstream out(fileName, std::ios::trunc);
+    out << longLine << "\n";
+    for(size_t i = 0; i < 20000; i++) out << line(i);
+  }
+  LogIndex index(16);
+  index.update(fileName);
+  BOOST_CHECK_EQUAL(index.getNLines(), 20001);
+  BOOST_CHECK_EQUAL(index.readLines(0, 1, 200000), longLine + "\n");
+  BOOST_CHECK_EQUAL(index.readLines(0, 2).size(), 64 * 1024);
+  BOOST_CHECK_EQUAL(index.readLines(15001, 3), lines(15000, 3));
+  remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(testIncremental) {
+  write(0, 1000, std::ios::trunc);
+  // small updates, so several calls are needed
+  LogIndex index(8, 1000);
+  BOOST_CHECK(index.update(fileName));
+  BOOST_CHECK(index.getNLines() < 1000);
+  for(size_t i = 0; i < 100 && index.update(fileName); i++) {
+  }
+  BOOST_CHECK_EQUAL(index.getNLines(), 1000);
+  BOOST_CHECK_EQUAL(index.readLines(995, 2), lines(995, 2));
+
+  // truncation resets the index
+  write(0, 10, std::ios::trunc);
+  BOOST_CHECK(waitForUpdate(index));
+  BOOST_CHECK_EQUAL(index.getNLines(), 10);
+  BOOST_CHECK_EQUAL(index.readLines(0, 20), lines(0, 10));
+
+  // a replaced file is indexed from the beginning
+  std::string rotated = fileName + ".1";
+  rename(fileName.c_str(), rotated.c_str());
+  write(50, 5, std::ios::trunc);
+  BOOST_CHECK(waitForUpdate(index));
+  BOOST_CHECK_EQUAL(index.getNLines(), 5);
+  BOOST_CHECK_EQUAL(index.readLines(0, 20), lines(50, 5));
+
+  // moving keeps the index
+  LogIndex moved(std::move(index));
+  BOOST_CHECK_EQUAL(moved.getNLines(), 5);
+  BOOST_CHECK_EQUAL(moved.readLines(4, 1), line(54));
+
+  remove(rotated.c_str());
+  BOOST_CHECK(moved.update(fileName + ".missing"));
+  BOOST_CHECK_EQUAL(moved.getNLines(), 0);
+  remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(testFindTime) {
+  {
+    std::ofstream out(fileName, std::ios::trunc);
+    out << "no time stamp\n";
+    for(size_t i = 0; i < 50; i++) {
+      // one message per minute, each followed by a continuation line
+      out << "2026-10-19 12:" << (i / 10) << (i % 10) << ":00 INFO message " << i << "\n";
+      out << "  details " << i << "\n";
+    }
+    // the clock jumped back
+    out << "2026-10-19 12:10:00 INFO clock adjusted\n";
+    out << "2026-10-19 14:00:00 INFO last\n";
+  }
+  LogIndex index(4);
+  index.update(fileName);
+  BOOST_CHECK_EQUAL(index.getNLines(), 103);
+  int64_t time;
+  BOOST_REQUIRE(LogIndex::parseTimestamp("2026-10-19 12:00:00", time));
+  BOOST_CHECK_EQUAL(index.findTime(time), 1);
+  BOOST_CHECK_EQUAL(index.findTime(time - 1), 1);
+  BOOST_CHECK_EQUAL(index.findTime(time + 1), 3);
+  BOOST_CHECK_EQUAL(index.findTime(time + 37 * 60), 75);
+  BOOST_CHECK_EQUAL(index.findTime(time + 37 * 60 - 30), 75);
+  BOOST_CHECK_EQUAL(index.findTime(time + 49 * 60), 99);
+  // lines written after the clock was adjusted back belong to the latest time
+  BOOST_CHECK_EQUAL(index.findTime(time + 50 * 60), 102);
+  BOOST_CHECK_EQUAL(index.findTime(time + 3 * 3600), 103);
+  BOOST_CHECK_EQUAL(index.readLines(index.findTime(time + 37 * 60), 2),
+      "2026-10-19 12:37:00 INFO message 37\n  details 37\n");
+  remove(fileName.c_str());
+}
@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_logRotator.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE LogRotatorTest
+
+#include "LogRotator.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace boost::unit_test_framework;
+
+/**
+ * Creates an empty directory for the log files and removes it at the end of the test.
+ */
+struct TestDir {
+  std::string path{"test_logRotator.d"};
+  TestDir() {
+    clean();
+    mkdir(path.c_str(), 0755);
+  }
+  ~TestDir() { clean(); }
+  void clean() {
+    std::string dir = path;
+    for(auto& file : LogRotator::findRotatedFiles(dir + "/test.log")) remove(file.c_str());
+    remove((dir + "/test.log").c_str());
+    remove((dir + "/other.log").c_str());
+    rmdir(dir.c_str());
+  }
+  std::string file() { return path + "/test.log"; }
+};
+
+std::string readFile(const std::string& fileName) {
+  std::ifstream in(fileName);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+size_t fileSize(const std::string& fileName) {
+  struct stat st;
+  return stat(fileName.c_str(), &st) == 0 ? st.st_size : 0;
+}
+
+void appendFile(const std::string& fileName, const std::string& data) {
+  std::ofstream out(fileName, std::ios::app);
+  out << data;
+}
+
+BOOST_AUTO_TEST_CASE(testSize) {
+  TestDir dir;
+  LogRotator rotator;
+  LogRotator::Settings settings;
+  settings.maxSize = 1;
+  appendFile(dir.file(), std::string(1000, 'a'));
+  BOOST_CHECK_EQUAL(rotator.check(dir.file(), settings, LogRotator::Method::CopyTruncate), "");
+  appendFile(dir.file(), std::string(100, 'b'));
+  auto rotated = rotator.check(dir.file(), settings, LogRotator::Method::CopyTruncate);
+  BOOST_REQUIRE(!rotated.empty());
+  // the file is copied in the background
+  LogRotator::waitForBackgroundJobs();
+  BOOST_CHECK_EQUAL(fileSize(dir.file()), 0);
+  BOOST_CHECK_EQUAL(readFile(rotated), std::string(1000, 'a') + std::string(100, 'b'));
+  // a second rotation within the same second must not overwrite the first one
+  appendFile(dir.file(), std::string(1100, 'c'));
+  auto rotated2 = rotator.check(dir.file(), settings, LogRotator::Method::CopyTruncate);
+  BOOST_REQUIRE(!rotated2.empty());
+  LogRotator::waitForBackgroundJobs();
+  BOOST_CHECK_NE(rotated, rotated2);
+  BOOST_CHECK_EQUAL(LogRotator::findRotatedFiles(dir.file()).size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(testCopyTruncateKeepsWriter) {
+  TestDir dir;
+  LogRotator rotator;
+  LogRotator::Settings settings;
+  settings.maxSize = 1;
+  // simulate the process writing the log file
+  int fd = open(dir.file().c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  BOOST_REQUIRE(fd >= 0);
+  std::string data(2000, 'a');
+  BOOST_REQUIRE_EQUAL(write(fd, data.data(), data.size()), data.size());
+  BOOST_REQUIRE(!rotator.check(dir.file(), settings, LogRotator::Method::CopyTruncate).empty());
+  LogRotator::waitForBackgroundJobs();
+  BOOST_REQUIRE_EQUAL(write(fd, "new\n", 4), 4);
+  close(fd);
+  BOOST_CHECK_EQUAL(readFile(dir.file()), "new\n");
+}
+
+BOOST_AUTO_TEST_CASE(testRename) {
+  TestDir dir;
+  LogRotator rotator;
+  LogRotator::Settings settings;
+  settings.maxSize = 1;
+  appendFile(dir.file(), std::string(2000, 'a'));
+  auto rotated = rotator.check(dir.file(), settings, LogRotator::Method::Rename);
+  BOOST_REQUIRE(!rotated.empty());
+  BOOST_CHECK_EQUAL(access(dir.file().c_str(), F_OK), -1);
+  BOOST_CHECK_EQUAL(fileSize(rotated), 2000);
+}
+
+BOOST_AUTO_TEST_CASE(testAge) {
+  TestDir dir;
+  LogRotator rotator;
+  LogRotator::Settings settings;
+  settings.maxAge = 60;
+  auto start = std::chrono::steady_clock::now();
+  appendFile(dir.file(), "line\n");
+  BOOST_CHECK_EQUAL(rotator.check(dir.file(), settings, LogRotator::Method::CopyTruncate, start), "");
+  BOOST_CHECK_EQUAL(
+      rotator.check(dir.file(), settings, LogRotator::Method::CopyTruncate, start + std::chrono::seconds(59)), "");
+  BOOST_CHECK(
+      !rotator.check(dir.file(), settings, LogRotator::Method::CopyTruncate, start + std::chrono::seconds(60)).empty());
+  LogRotator::waitForBackgroundJobs();
+  // empty files are not rotated
+  BOOST_CHECK_EQUAL(
+      rotator.check(dir.file(), settings, LogRotator::Method::CopyTruncate, start + std::chrono::seconds(200)), "");
+}
+
+BOOST_AUTO_TEST_CASE(testCompress) {
+  TestDir dir;
+  LogRotator rotator;
+  LogRotator::Settings settings;
+  settings.maxSize = 1;
+  settings.compress = true;
+  std::string data;
+  for(size_t i = 0; i < 200; i++) data += "Line " + std::to_string(i) + "\n";
+  appendFile(dir.file(), data);
+  auto rotated = rotator.check(dir.file(), settings, LogRotator::Method::CopyTruncate);
+  BOOST_REQUIRE(!rotated.empty());
+  LogRotator::waitForBackgroundJobs();
+  BOOST_CHECK_EQUAL(access(rotated.c_str(), F_OK), -1);
+  gzFile in = gzopen((rotated + ".gz").c_str(), "rb");
+  BOOST_REQUIRE(in != nullptr);
+  std::string result(data.size() + 10, '\0');
+  int n = gzread(in, &result[0], result.size());
+  gzclose(in);
+  BOOST_CHECK_EQUAL(result.substr(0, n), data);
+}
+
+BOOST_AUTO_TEST_CASE(testRetention) {
+  TestDir dir;
+  LogRotator rotator;
+  LogRotator::Settings settings;
+  settings.maxSize = 1;
+  settings.retention = 5;
+  std::vector<std::string> rotated;
+  for(size_t i = 0; i < 4; i++) {
+    appendFile(dir.file(), std::string(2000, 'a' + i));
+    rotated.push_back(rotator.check(dir.file(), settings, LogRotator::Method::Rename));
+    BOOST_REQUIRE(!rotated.back().empty());
+    LogRotator::waitForBackgroundJobs();
+    // make sure the modification times differ
+    usleep(10000);
+  }
+  // only 2 files of 2000 bytes fit into 5 kB, so the oldest ones are removed
+  auto files = LogRotator::findRotatedFiles(dir.file());
+  BOOST_REQUIRE_EQUAL(files.size(), 2);
+  BOOST_CHECK_EQUAL(files[0], rotated[2]);
+  BOOST_CHECK_EQUAL(files[1], rotated[3]);
+  // other files in the directory are not touched
+  appendFile(dir.path + "/other.log", "other");
+  LogRotator::enforceRetention(dir.file(), 0);
+  BOOST_CHECK(LogRotator::findRotatedFiles(dir.file()).empty());
+  BOOST_CHECK_EQUAL(fileSize(dir.path + "/other.log"), 5);
+}
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_logScanner.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE LogScannerTest
+
+#include "LogScanner.h"
+#include "LogTail.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace boost::unit_test_framework;
+
+void add(LogScanner& scanner, const std::string& data) {
+  scanner.add(data.data(), data.size());
+}
+
+BOOST_AUTO_TEST_CASE(testLiteral) {
+  LogScanner scanner;
+  scanner.setPatterns({"ERROR", "timeout", "out"});
+  add(scanner, "INFO start\nERROR: timeout\nERROR ERROR\nno match\n");
+  std::vector<uint64_t> expected{2, 1, 1};
+  auto counts = scanner.getCounts();
+  BOOST_CHECK_EQUAL_COLLECTIONS(counts.begin(), counts.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(testOverlapping) {
+  LogScanner scanner;
+  // patterns that are suffixes of each other need the failure links
+  scanner.setPatterns({"abcd", "bc", "cde", "e"});
+  add(scanner, "xabcdex\nabce\nbcd\n");
+  std::vector<uint64_t> expected{1, 3, 1, 2};
+  auto counts = scanner.getCounts();
+  BOOST_CHECK_EQUAL_COLLECTIONS(counts.begin(), counts.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(testChunks) {
+  LogScanner scanner;
+  scanner.setPatterns({"segfault", "/code [0-9]+$/"});
+  std::string data = "process segfault\nexit code 11\nsegfault with code 139\nseg\nfault\n";
+  // feed the data byte by byte, so patterns and lines are split between chunks
+  for(char c : data) scanner.add(&c, 1);
+  std::vector<uint64_t> expected{2, 2};
+  auto counts = scanner.getCounts();
+  BOOST_CHECK_EQUAL_COLLECTIONS(counts.begin(), counts.end(), expected.begin(), expected.end());
+  // a line is only counted when it is complete
+  add(scanner, "segfault");
+  BOOST_CHECK_EQUAL(scanner.getCounts()[0], 2);
+  add(scanner, "\n");
+  BOOST_CHECK_EQUAL(scanner.getCounts()[0], 3);
+}
+
+BOOST_AUTO_TEST_CASE(testSetPatterns) {
+  LogScanner scanner;
+  add(scanner, "ERROR\n");
+  BOOST_CHECK(scanner.getCounts().empty());
+  scanner.setPatterns({"ERROR"});
+  add(scanner, "ERROR\n");
+  // same patterns -> counts are kept
+  scanner.setPatterns({"ERROR"});
+  add(scanner, "ERROR\n");
+  BOOST_CHECK_EQUAL(scanner.getCounts()[0], 2);
+  // new patterns -> counts are reset
+  scanner.setPatterns({"ERROR", "WARNING"});
+  BOOST_CHECK_EQUAL(scanner.getCounts()[0], 0);
+  BOOST_CHECK_THROW(scanner.setPatterns({"/[/"}), std::runtime_error);
+  BOOST_CHECK_THROW(scanner.setPatterns({""}), std::runtime_error);
+  BOOST_CHECK_THROW(
+      scanner.setPatterns(std::vector<std::string>(LogScanner::maxPatterns + 1, "a")), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testLogTail) {
+  std::string fileName = "test_logScanner.log";
+  {
+    std::ofstream out(fileName);
+    out << "ERROR old\n";
+  }
+  auto scanner = std::make_shared<LogScanner>();
+  scanner->setPatterns({"ERROR"});
+  LogTail tail;
+  tail.setScanner(scanner);
+  tail.update(fileName, 10);
+  // existing lines are not counted
+  BOOST_CHECK_EQUAL(scanner->getCounts()[0], 0);
+  {
+    std::ofstream out(fileName, std::ios::app);
+    out << "ERROR new\nINFO\n";
+  }
+  for(size_t i = 0; i < 200 && scanner->getCounts()[0] == 0; i++) {
+    usleep(10000);
+    tail.update(fileName, 10);
+  }
+  BOOST_CHECK_EQUAL(scanner->getCounts()[0], 1);
+  remove(fileName.c_str());
+}
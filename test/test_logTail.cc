@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_logTail.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE LogTailTest
+
+#include "LogTail.h"
+#include "Logging.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace boost::unit_test_framework;
+
+const std::string fileName = "/tmp/test_logTail.log";
+
+void append(const std::string& data, const std::string& name = fileName) {
+  std::ofstream file(name, std::ios::app);
+  file << data;
+}
+
+/**
+ * Tail as produced by logging::formatLogTail.
+ */
+std::string referenceTail(size_t tailLength) {
+  std::ifstream file(fileName);
+  std::stringstream out;
+  logging::formatLogTail(file, out, tailLength);
+  return out.str();
+}
+
+/**
+ * Changes are reported asynchronously by the LogWatchReactor, so retry for a while.
+ */
+bool waitForUpdate(LogTail& tail, const std::string& name, size_t tailLength) {
+  for(size_t i = 0; i < 200; i++) {
+    if(tail.update(name, tailLength)) return true;
+    usleep(10000);
+  }
+  return false;
+}
+
+BOOST_AUTO_TEST_CASE(testMessages) {
+  LogTail tail;
+  BOOST_CHECK(tail.update("", 10));
+  BOOST_CHECK_EQUAL(tail.getTail(), "No log file is set. Try starting the process and setting a LogFile.\n");
+  BOOST_CHECK(!tail.update("", 10));
+  BOOST_CHECK(tail.update(fileName, 0));
+  BOOST_CHECK_EQUAL(tail.getTail(), "Tail length is <1. No messages from the log file read.\n");
+  remove(fileName.c_str());
+  BOOST_CHECK(tail.update(fileName, 10));
+  BOOST_CHECK_EQUAL(tail.getTail(), "Can not open file: " + fileName + "\n");
+}
+
+BOOST_AUTO_TEST_CASE(testAppend) {
+  remove(fileName.c_str());
+  append("line1\nline2\nline3\n");
+  LogTail tail;
+  BOOST_CHECK(tail.update(fileName, 2));
+  BOOST_CHECK_EQUAL(tail.getTail(), "line2\nline3\n");
+  BOOST_CHECK_EQUAL(tail.getTail(), referenceTail(2));
+  BOOST_CHECK(!tail.update(fileName, 2));
+  append("line4\nincomplete");
+  BOOST_CHECK(waitForUpdate(tail, fileName, 2));
+  BOOST_CHECK_EQUAL(tail.getTail(), "line4\nincomplete\n");
+  BOOST_CHECK_EQUAL(tail.getTail(), referenceTail(2));
+  append(" line5\n");
+  BOOST_CHECK(tail.update(fileName, 3));
+  BOOST_CHECK_EQUAL(tail.getTail(), "line3\nline4\nincomplete line5\n");
+  BOOST_CHECK_EQUAL(tail.getTail(), referenceTail(3));
+}
+
+BOOST_AUTO_TEST_CASE(testTruncateAndRecreate) {
+  remove(fileName.c_str());
+  append("line1\nline2\n");
+  LogTail tail;
+  BOOST_CHECK(tail.update(fileName, 5));
+  BOOST_CHECK_EQUAL(tail.getTail(), "line1\nline2\n");
+  // copy truncate
+  { std::ofstream file(fileName, std::ios::trunc); }
+  append("new1\n");
+  BOOST_CHECK(waitForUpdate(tail, fileName, 5));
+  BOOST_CHECK_EQUAL(tail.getTail(), "new1\n");
+  // delete and recreate, e.g. by restarting the process
+  remove(fileName.c_str());
+  append("recreated\n");
+  BOOST_CHECK(waitForUpdate(tail, fileName, 5));
+  BOOST_CHECK_EQUAL(tail.getTail(), "recreated\n");
+  // move and recreate, e.g. by log rotation
+  rename(fileName.c_str(), (fileName + ".1").c_str());
+  append("old\n", fileName + ".1");
+  append("rotated\n");
+  BOOST_CHECK(waitForUpdate(tail, fileName, 5));
+  BOOST_CHECK_EQUAL(tail.getTail(), "rotated\n");
+  remove((fileName + ".1").c_str());
+  remove(fileName.c_str());
+  BOOST_CHECK(waitForUpdate(tail, fileName, 5));
+  BOOST_CHECK_EQUAL(tail.getTail(), "Can not open file: " + fileName + "\n");
+}
+
+BOOST_AUTO_TEST_CASE(testBackwardScanner) {
+  remove(fileName.c_str());
+  std::stringstream content;
+  for(size_t i = 0; i < 200; i++) {
+    content << "line " << i << std::string(i % 17, 'x') << "\n";
+  }
+  append(content.str());
+  for(size_t nLines : {1, 2, 10, 199, 200, 500}) {
+    std::stringstream out;
+    BOOST_CHECK(logging::readLogTail(fileName, out, nLines));
+    BOOST_CHECK_EQUAL(out.str(), referenceTail(nLines));
+  }
+  // block boundaries
+  int fd = open(fileName.c_str(), O_RDONLY);
+  off_t size = content.str().size();
+  off_t expected = logging::findTailOffset(fd, size, 50);
+  for(size_t blockSize : {1, 2, 3, 7, 64, 1000}) {
+    BOOST_CHECK_EQUAL(logging::findTailOffset(fd, size, 50, blockSize), expected);
+  }
+  close(fd);
+  // incomplete last line
+  append("incomplete");
+  std::stringstream out;
+  BOOST_CHECK(logging::readLogTail(fileName, out, 3));
+  BOOST_CHECK_EQUAL(out.str(), referenceTail(3));
+  BOOST_CHECK(!logging::readLogTail("/tmp/notExistingFile.log", out, 3));
+  remove(fileName.c_str());
+}
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_messageQueue.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE MessageQueueTest
+
+#include "MessageQueue.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+
+using namespace boost::unit_test_framework;
+
+BOOST_AUTO_TEST_CASE(testOrder) {
+  logging::MessageQueue queue(3);
+  logging::Record record;
+  BOOST_CHECK(!queue.pop(record));
+  BOOST_CHECK(queue.push(logging::LogLevel::ERROR, "first"));
+  BOOST_CHECK(queue.push(logging::LogLevel::DEBUG, "second"));
+  BOOST_REQUIRE(queue.pop(record));
+  BOOST_CHECK(record.level == logging::LogLevel::ERROR);
+  BOOST_CHECK_EQUAL(record.text, "first");
+  BOOST_REQUIRE(queue.pop(record));
+  BOOST_CHECK(record.level == logging::LogLevel::DEBUG);
+  BOOST_CHECK_EQUAL(record.text, "second");
+  BOOST_CHECK(!queue.pop(record));
+}
+
+BOOST_AUTO_TEST_CASE(testFull) {
+  // capacity is rounded up to 4
+  logging::MessageQueue queue(3);
+  for(size_t i = 0; i < 4; i++) BOOST_CHECK(queue.push(logging::LogLevel::INFO, std::to_string(i)));
+  BOOST_CHECK(!queue.push(logging::LogLevel::INFO, "dropped"));
+  BOOST_CHECK(!queue.push(logging::LogLevel::INFO, "dropped"));
+  BOOST_CHECK_EQUAL(queue.takeDropped(), 2);
+  BOOST_CHECK_EQUAL(queue.takeDropped(), 0);
+  logging::Record record;
+  BOOST_REQUIRE(queue.pop(record));
+  BOOST_CHECK_EQUAL(record.text, "0");
+  BOOST_CHECK(queue.push(logging::LogLevel::INFO, "4"));
+  for(size_t i = 1; i < 5; i++) {
+    BOOST_REQUIRE(queue.pop(record));
+    BOOST_CHECK_EQUAL(record.text, std::to_string(i));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testThreads) {
+  logging::MessageQueue queue(16);
+  const size_t nMessages = 100000;
+  std::thread producer([&queue]() {
+    for(size_t i = 0; i < nMessages; i++) {
+      while(!queue.push(logging::LogLevel::INFO, std::to_string(i))) std::this_thread::yield();
+    }
+  });
+  logging::Record record;
+  size_t received = 0;
+  bool inOrder = true;
+  while(received < nMessages) {
+    if(!queue.pop(record)) {
+      std::this_thread::yield();
+      continue;
+    }
+    inOrder &= record.text == std::to_string(received);
+    received++;
+  }
+  producer.join();
+  BOOST_CHECK(inOrder);
+  BOOST_CHECK(!queue.pop(record));
+}
@@ -0,0 +1,192 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_netStats.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE NetStatsTest
+
+#include "NetStats.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <linux/rtnetlink.h>
+
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+using namespace boost::unit_test_framework;
+namespace bfs = boost::filesystem;
+
+/**
+ * \return Link notification like sent by the kernel, without statistics.
+ */
+std::string linkMessage(uint16_t type, int index, const std::string& name) {
+  std::string message(NLMSG_SPACE(sizeof(ifinfomsg)) + RTA_SPACE(name.size() + 1), '\0');
+  auto header = reinterpret_cast<nlmsghdr*>(message.data());
+  header->nlmsg_len = message.size();
+  header->nlmsg_type = type;
+  auto info = static_cast<ifinfomsg*>(NLMSG_DATA(header));
+  info->ifi_index = index;
+  auto attribute = IFLA_RTA(info);
+  attribute->rta_type = IFLA_IFNAME;
+  attribute->rta_len = RTA_LENGTH(name.size() + 1);
+  std::memcpy(RTA_DATA(attribute), name.c_str(), name.size() + 1);
+  return message;
+}
+
+BOOST_AUTO_TEST_CASE(testRecorded) {
+  NetStats stats("proc");
+  NetStats::Sample sample;
+  BOOST_REQUIRE_MESSAGE(stats.get(0, "enp3s0", sample), stats.getError());
+  BOOST_CHECK_EQUAL(sample.counters.rxBytes, 6144522913);
+  BOOST_CHECK_EQUAL(sample.counters.rxPackets, 5270156);
+  BOOST_CHECK_EQUAL(sample.counters.rxErrors, 12);
+  BOOST_CHECK_EQUAL(sample.counters.rxDropped, 371);
+  BOOST_CHECK_EQUAL(sample.counters.rxFifo, 3);
+  BOOST_CHECK_EQUAL(sample.counters.rxFrame, 1);
+  BOOST_CHECK_EQUAL(sample.counters.multicast, 20114);
+  BOOST_CHECK_EQUAL(sample.counters.txBytes, 871337252);
+  BOOST_CHECK_EQUAL(sample.counters.txPackets, 2417893);
+  BOOST_CHECK_EQUAL(sample.counters.txErrors, 2);
+  BOOST_CHECK_EQUAL(sample.counters.collisions, 0);
+  BOOST_CHECK(stats.getInterfaces() == std::vector<std::string>({"lo", "enp3s0", "wlp2s0"}));
+
+  // all interfaces of a tick share the snapshot and its time stamp
+  NetStats::Sample other;
+  BOOST_REQUIRE(stats.get(0, "lo", other));
+  BOOST_CHECK_EQUAL(other.counters.rxBytes, 48713218);
+  BOOST_CHECK(other.time == sample.time);
+  BOOST_CHECK_EQUAL(stats.getNReads(), 1);
+
+  BOOST_CHECK(!stats.get(0, "eth7", other));
+  BOOST_CHECK_EQUAL(stats.getError(), "interface eth7 not found");
+}
+
+BOOST_AUTO_TEST_CASE(testTicks) {
+  // the file is kept open, so rewriting it in place changes the next snapshot
+  bfs::path dir("test_netStats.d");
+  bfs::remove_all(dir);
+  bfs::create_directories(dir / "net");
+  auto write = [&](const std::string& content) {
+    std::ofstream out((dir / "net" / "dev").string());
+    out << "Inter-|   Receive\n face |bytes\n" << content;
+  };
+  write("  eth0: 100 1 0 0 0 0 0 0 200 2 0 0 0 0 0 0\n");
+  NetStats stats(dir.string());
+
+  // several threads requesting the same tick read the file once
+  std::vector<std::thread> threads;
+  std::vector<uint64_t> rxBytes(8);
+  for(size_t i = 0; i < rxBytes.size(); ++i) {
+    threads.emplace_back([&, i] {
+      NetStats::Sample sample;
+      if(stats.get(1, "eth0", sample)) rxBytes[i] = sample.counters.rxBytes;
+    });
+  }
+  for(auto& thread : threads) thread.join();
+  BOOST_CHECK_EQUAL(stats.getNReads(), 1);
+  BOOST_CHECK(rxBytes == std::vector<uint64_t>(8, 100));
+
+  // a new tick reads the file again, an older tick uses the newer snapshot
+  write("  eth0: 300 3 0 0 0 0 0 0 400 4 0 0 0 0 0 0\n  eth1:5 1 0 0 0 0 0 0 6 1 0 0 0 0 0 0\n");
+  NetStats::Sample sample;
+  BOOST_REQUIRE(stats.get(2, "eth0", sample));
+  BOOST_CHECK_EQUAL(sample.counters.txBytes, 400);
+  BOOST_REQUIRE(stats.get(1, "eth1", sample));
+  BOOST_CHECK_EQUAL(sample.counters.rxBytes, 5);
+  BOOST_CHECK_EQUAL(stats.getNReads(), 2);
+
+  write("  eth0: 300 x\n");
+  BOOST_CHECK(!stats.get(3, "eth0", sample));
+  BOOST_CHECK_EQUAL(stats.getError(), (dir / "net" / "dev").string() + ": invalid line for eth0");
+  bfs::remove_all(dir);
+
+  NetStats missing(dir.string());
+  BOOST_CHECK(!missing.get(0, "eth0", sample));
+  BOOST_CHECK_EQUAL(missing.getError(), (dir / "net" / "dev").string() + ": can not be opened");
+}
+
+BOOST_AUTO_TEST_CASE(testSlots) {
+  NetStats stats("proc", "sys");
+  stats.setSlots({"enp3s0"}, 2);
+  auto notify = [&](const std::string& messages) {
+    return stats.handleNotifications(messages.data(), messages.size());
+  };
+  NetStats::Sample sample;
+  BOOST_REQUIRE_MESSAGE(stats.get(0, size_t(0), sample), stats.getError());
+  BOOST_CHECK_EQUAL(sample.interface, "enp3s0");
+  BOOST_CHECK_EQUAL(sample.counters.rxBytes, 6144522913);
+  BOOST_REQUIRE(stats.get(0, size_t(1), sample));
+  BOOST_CHECK_EQUAL(sample.interface, "");
+  BOOST_CHECK_EQUAL(sample.counters.rxBytes, 0);
+  BOOST_CHECK(!stats.get(0, size_t(2), sample));
+
+  // virtual interfaces are not monitored
+  BOOST_CHECK(notify(linkMessage(RTM_NEWLINK, 1, "lo")));
+  BOOST_REQUIRE(stats.get(1, size_t(1), sample));
+  BOOST_CHECK_EQUAL(sample.interface, "");
+
+  // a new interface uses the free slot, a known interface keeps its slot
+  BOOST_CHECK(notify(linkMessage(RTM_NEWLINK, 3, "wlp2s0") + linkMessage(RTM_NEWLINK, 2, "enp3s0")));
+  BOOST_REQUIRE(stats.get(1, size_t(1), sample));
+  BOOST_CHECK_EQUAL(sample.interface, "wlp2s0");
+  BOOST_CHECK_EQUAL(sample.generation, 1);
+  BOOST_REQUIRE(stats.get(1, size_t(0), sample));
+  BOOST_CHECK_EQUAL(sample.interface, "enp3s0");
+  BOOST_CHECK_EQUAL(sample.generation, 0);
+
+  // renamed interfaces keep their slot
+  BOOST_CHECK(notify(linkMessage(RTM_NEWLINK, 2, "eth0")));
+  BOOST_CHECK(!stats.get(1, size_t(0), sample));
+  BOOST_CHECK_EQUAL(stats.getError(), "interface eth0 not found");
+  BOOST_CHECK(notify(linkMessage(RTM_NEWLINK, 2, "enp3s0")));
+  BOOST_REQUIRE(stats.get(1, size_t(0), sample));
+  BOOST_CHECK_EQUAL(sample.generation, 0);
+
+  // without a free slot the interface waits until a slot is freed
+  BOOST_CHECK(notify(linkMessage(RTM_NEWLINK, 4, "enp4s0")));
+  BOOST_CHECK_EQUAL(stats.getNWaiting(), 1);
+  BOOST_CHECK(notify(linkMessage(RTM_DELLINK, 3, "wlp2s0") + linkMessage(RTM_DELLINK, 7, "unknown")));
+  BOOST_CHECK_EQUAL(stats.getNWaiting(), 0);
+  BOOST_CHECK(!stats.get(1, size_t(1), sample));
+  BOOST_CHECK_EQUAL(sample.interface, "enp4s0");
+  BOOST_CHECK_EQUAL(sample.generation, 2);
+  BOOST_CHECK(notify(linkMessage(RTM_DELLINK, 4, "enp4s0")));
+  BOOST_REQUIRE(stats.get(1, size_t(1), sample));
+  BOOST_CHECK_EQUAL(sample.interface, "");
+  BOOST_CHECK_EQUAL(sample.generation, 3);
+
+  std::string error(NLMSG_SPACE(sizeof(nlmsgerr)), '\0');
+  reinterpret_cast<nlmsghdr*>(error.data())->nlmsg_len = error.size();
+  reinterpret_cast<nlmsghdr*>(error.data())->nlmsg_type = NLMSG_ERROR;
+  BOOST_CHECK(!notify(error));
+}
+
+BOOST_AUTO_TEST_CASE(testNetlink) {
+  NetStats stats;
+  BOOST_REQUIRE_MESSAGE(stats.useNetlink(), stats.getError());
+  stats.setSlots({"lo"}, 2);
+  BOOST_REQUIRE_MESSAGE(stats.watchLinks(), stats.getError());
+  NetStats::Sample sample;
+  BOOST_REQUIRE_MESSAGE(stats.get(0, size_t(0), sample), stats.getError());
+  BOOST_CHECK_EQUAL(sample.interface, "lo");
+  BOOST_REQUIRE_MESSAGE(stats.get(0, "lo", sample), stats.getError());
+  BOOST_CHECK_EQUAL(stats.getNReads(), 1);
+  auto rxPackets = sample.counters.rxPackets;
+  BOOST_REQUIRE(stats.get(1, "lo", sample));
+  BOOST_CHECK(sample.counters.rxPackets >= rxPackets);
+  BOOST_CHECK_EQUAL(stats.getNReads(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(testProc) {
+  NetStats stats;
+  NetStats::Sample sample;
+  BOOST_REQUIRE_MESSAGE(stats.get(0, "lo", sample), stats.getError());
+  BOOST_CHECK(!stats.getInterfaces().empty());
+}
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_numaMemory.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE NumaMemoryTest
+
+#include "NumaMemory.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+
+using namespace boost::unit_test_framework;
+namespace bfs = boost::filesystem;
+
+BOOST_AUTO_TEST_CASE(testRecorded) {
+  NumaMemory numa("sys");
+  BOOST_REQUIRE_MESSAGE(numa.update(), numa.getError());
+  BOOST_CHECK(numa.getNodeIds() == std::vector<std::string>({"0", "1"}));
+  BOOST_REQUIRE_EQUAL(numa.getNodes().size(), 2);
+  auto& node = numa.getNodes()[1];
+  BOOST_CHECK_EQUAL(node.total, 4816632);
+  BOOST_CHECK_EQUAL(node.free, 3399884);
+  BOOST_CHECK_EQUAL(node.used, 1416748);
+  BOOST_CHECK_EQUAL(node.numaHit, 5230011);
+  BOOST_CHECK_EQUAL(node.numaMiss, 1200);
+  BOOST_CHECK_EQUAL(node.interleaveHit, 1024);
+  BOOST_CHECK_EQUAL(node.localNode, 5229661);
+  BOOST_CHECK_EQUAL(node.otherNode, 350);
+  BOOST_CHECK_EQUAL(numa.getNodes()[0].numaForeign, 1200);
+}
+
+BOOST_AUTO_TEST_CASE(testUpdate) {
+  // the files are kept open, so rewriting them in place changes the next update
+  bfs::path dir("test_numaMemory.d");
+  bfs::remove_all(dir);
+  for(auto node : {"node0", "node1"}) {
+    bfs::create_directories(dir / "devices/system/node" / node);
+    for(auto file : {"meminfo", "numastat"}) {
+      bfs::copy_file(bfs::path("sys/devices/system/node") / node / file, dir / "devices/system/node" / node / file);
+    }
+  }
+  NumaMemory numa(dir.string());
+  BOOST_REQUIRE(numa.update());
+  {
+    std::ofstream out((dir / "devices/system/node/node0/numastat").string());
+    out << "numa_hit 1\nnuma_miss 2\nnuma_foreign 3\ninterleave_hit 4\nlocal_node 5\nother_node 6\n";
+  }
+  BOOST_REQUIRE(numa.update());
+  BOOST_CHECK_EQUAL(numa.getNodes()[0].otherNode, 6);
+  BOOST_CHECK_EQUAL(numa.getNodes()[0].total, 4816632);
+
+  {
+    std::ofstream out((dir / "devices/system/node/node1/meminfo").string());
+    out << "Node 1 MemTotal: 100 kB\n";
+  }
+  BOOST_CHECK(!numa.update());
+  BOOST_CHECK_EQUAL(numa.getError(), (dir / "devices/system/node/node1/meminfo").string() + ": missing fields");
+
+  NumaMemory moved(std::move(numa));
+  BOOST_CHECK_EQUAL(moved.getNodes()[1].total, 100);
+  bfs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(testMissing) {
+  NumaMemory numa("missing");
+  BOOST_CHECK(numa.update());
+  BOOST_CHECK(numa.getNodes().empty());
+}
@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_outputCapture.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OutputCaptureTest
+
+#include "LineRing.h"
+#include "OutputCapture.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace boost::unit_test_framework;
+
+/**
+ * The pipe is drained asynchronously by the LogWatchReactor, so retry for a while.
+ */
+std::string waitForTail(OutputCapture& capture, const std::string& expected) {
+  std::string tail;
+  for(size_t i = 0; i < 200; i++) {
+    capture.update(tail);
+    if(tail == expected) break;
+    usleep(10000);
+  }
+  return tail;
+}
+
+void writeAll(int fd, const std::string& data) {
+  BOOST_REQUIRE_EQUAL(write(fd, data.data(), data.size()), (ssize_t)data.size());
+}
+
+BOOST_AUTO_TEST_CASE(testLineRing) {
+  LineRing ring;
+  ring.setCapacity(2);
+  ring.add("a\nb", 3);
+  BOOST_CHECK_EQUAL(ring.format(), "a\nb\n");
+  ring.add("c\nd\n", 4);
+  BOOST_CHECK_EQUAL(ring.format(), "bc\nd\n");
+  ring.setCapacity(1);
+  BOOST_CHECK_EQUAL(ring.format(), "d\n");
+  ring.clear();
+  BOOST_CHECK_EQUAL(ring.format(), "");
+}
+
+BOOST_AUTO_TEST_CASE(testCapture) {
+  auto capture = std::make_shared<OutputCapture>();
+  capture->setTailLength(2);
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(pipe(fds), 0);
+  capture->attach(fds[0]);
+  writeAll(fds[1], "line1\nline2\nline3\n");
+  BOOST_CHECK_EQUAL(waitForTail(*capture, "line2\nline3\n"), "line2\nline3\n");
+  std::string tail;
+  BOOST_CHECK(!capture->update(tail));
+  close(fds[1]);
+
+  // the tail is kept after attaching a new pipe, e.g. after a restart
+  BOOST_REQUIRE_EQUAL(pipe(fds), 0);
+  capture->attach(fds[0]);
+  writeAll(fds[1], "restarted\n");
+  BOOST_CHECK_EQUAL(waitForTail(*capture, "line3\nrestarted\n"), "line3\nrestarted\n");
+  close(fds[1]);
+  capture->detach();
+}
+
+BOOST_AUTO_TEST_CASE(testLogFile) {
+  const std::string fileName = "/tmp/test_outputCapture.log";
+  remove(fileName.c_str());
+  auto capture = std::make_shared<OutputCapture>(10);
+  capture->setTailLength(5);
+  capture->setLogFile(fileName);
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(pipe(fds), 0);
+  capture->attach(fds[0]);
+  writeAll(fds[1], "12345\n");
+  BOOST_CHECK_EQUAL(waitForTail(*capture, "12345\n"), "12345\n");
+  capture->flush();
+  // only 10 bytes are buffered for the log file, the tail is complete nevertheless
+  writeAll(fds[1], "abcdefghijkl\n");
+  BOOST_CHECK_EQUAL(waitForTail(*capture, "12345\nabcdefghijkl\n"), "12345\nabcdefghijkl\n");
+  capture->flush();
+  std::ifstream file(fileName);
+  std::stringstream content;
+  content << file.rdbuf();
+  BOOST_CHECK_EQUAL(content.str(), "12345\nabcdefghij");
+  BOOST_CHECK_EQUAL(capture->getDroppedBytes(), 3);
+  close(fds[1]);
+  remove(fileName.c_str());
+}
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_pressure.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE PressureTest
+
+#include "Pressure.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <unistd.h>
+
+using namespace boost::unit_test_framework;
+
+BOOST_AUTO_TEST_CASE(testRecorded) {
+  Pressure pressure("pressure");
+  BOOST_REQUIRE_MESSAGE(pressure.update(), pressure.getError());
+  auto& memory = pressure.get(Pressure::MEMORY);
+  BOOST_CHECK_CLOSE(memory.some.avg10, 12.5, 1e-9);
+  BOOST_CHECK_CLOSE(memory.some.avg60, 3.08, 1e-9);
+  BOOST_CHECK_CLOSE(memory.some.avg300, 0.94, 1e-9);
+  BOOST_CHECK_EQUAL(memory.some.total, 1664606);
+  BOOST_CHECK_CLOSE(memory.full.avg10, 10.04, 1e-9);
+  BOOST_CHECK_EQUAL(memory.full.total, 1513653);
+  BOOST_CHECK_CLOSE(pressure.get(Pressure::CPU).some.avg10, 1.25, 1e-9);
+  // kernels older than 5.13 do not report full for cpu and io
+  BOOST_CHECK_EQUAL(pressure.get(Pressure::IO).some.total, 20345);
+  BOOST_CHECK_EQUAL(pressure.get(Pressure::IO).full.total, 0);
+  BOOST_CHECK_EQUAL(pressure.getNTriggers(), 0);
+  BOOST_CHECK_EQUAL(pressure.wait(0), 0);
+
+  Pressure moved(std::move(pressure));
+  BOOST_CHECK_EQUAL(moved.get(Pressure::MEMORY).some.total, 1664606);
+  // without triggers wait() only returns once interrupted
+  moved.interrupt();
+  BOOST_CHECK_EQUAL(moved.wait(-1), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testCgroup) {
+  auto path = Pressure::findCgroup("pressure/self_cgroup", {"missing", "pressure/cgroup"});
+  BOOST_CHECK_EQUAL(path, "pressure/cgroup/watchdog.service");
+  BOOST_CHECK_EQUAL(Pressure::findCgroup("pressure/self_root", {"missing", "pressure/cgroup"}), "");
+  BOOST_CHECK_EQUAL(Pressure::findCgroup("missing", {"missing", "pressure/cgroup"}), "");
+
+  // only the cpu pressure is recorded
+  Pressure cgroup(path, ".pressure");
+  BOOST_CHECK(cgroup.isAvailable(Pressure::CPU));
+  BOOST_CHECK(!cgroup.isAvailable(Pressure::MEMORY));
+  BOOST_CHECK(!cgroup.update());
+  BOOST_CHECK_EQUAL(cgroup.getError(), path + "/io.pressure: can not be opened");
+  BOOST_CHECK_EQUAL(cgroup.get(Pressure::CPU).full.total, 1800);
+
+  Pressure none("", ".pressure");
+  BOOST_CHECK(!none.isAvailable(Pressure::CPU));
+}
+
+BOOST_AUTO_TEST_CASE(testProc) {
+  Pressure pressure;
+  if(!pressure.isAvailable(Pressure::CPU)) {
+    BOOST_TEST_MESSAGE("PSI is not supported by the kernel.");
+    return;
+  }
+  BOOST_CHECK_MESSAGE(pressure.update(), pressure.getError());
+  if(!pressure.addTrigger(Pressure::CPU, false, 200000, 2000000)) {
+    BOOST_TEST_MESSAGE("PSI triggers not permitted: " + pressure.getError());
+    return;
+  }
+  BOOST_CHECK_EQUAL(pressure.getNTriggers(), 1);
+  // the trigger fires only if tasks stall, so just check waiting returns
+  BOOST_CHECK(pressure.wait(10) <= 1U << Pressure::CPU);
+  BOOST_CHECK(!pressure.addTrigger(Pressure::IO, false, 100000, 1));
+  BOOST_CHECK_EQUAL(pressure.getNTriggers(), 1);
+}
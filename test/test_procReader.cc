@@ -11,10 +11,13 @@
 #define BOOST_TEST_MODULE sysTest
 
 #include "ProcessHandler.h"
+#include "SpawnHelper.h"
 #include "sys_stat.h"
 
 #include <boost/test/unit_test.hpp>
 
+#include <sys/wait.h>
+
 #include <iostream>
 
 using namespace boost::unit_test_framework;
@@ -76,3 +79,62 @@ BOOST_AUTO_TEST_CASE(testPIDTest) {
   BOOST_CHECK_EQUAL(proc_util::isProcessRunning(pid, infoptrPID), false);
 #endif
 }
+
+BOOST_AUTO_TEST_CASE(testSpawnHelper) {
+  BOOST_CHECK_EQUAL(spawn::SpawnHelper::start(), true);
+  BOOST_CHECK_EQUAL(spawn::SpawnHelper::isRunning(), true);
+  spawn::Request request;
+  request.exec = std::make_shared<const ExecSpec>("/bin", "sleep 1");
+  request.pidFile = "/tmp/testSpawnHelper.PID";
+  request.name = "test";
+  request.logLevel = logging::LogLevel::ERROR;
+  std::string error;
+  uint64_t spawnID{0};
+  pid_t pid = spawn::SpawnHelper::spawn(request, error, nullptr, &spawnID);
+  BOOST_CHECK(pid > 0);
+  BOOST_CHECK(spawnID > 0);
+  BOOST_CHECK_EQUAL(error, "");
+  int status{-1};
+  bool exited = false;
+  for(size_t i = 0; i < 30 && !exited; i++) {
+    usleep(100000);
+    exited = spawn::SpawnHelper::getExitStatus(spawnID, status);
+  }
+  BOOST_CHECK_EQUAL(exited, true);
+  BOOST_CHECK(WIFEXITED(status));
+  BOOST_CHECK_EQUAL(WEXITSTATUS(status), 0);
+  BOOST_CHECK_EQUAL(spawn::describeExitStatus(status), "exit code 0");
+  // the status is only returned once
+  BOOST_CHECK_EQUAL(spawn::SpawnHelper::getExitStatus(spawnID, status), false);
+
+  // a forgotten process does not leave its exit status behind
+  request.exec = std::make_shared<const ExecSpec>("/bin", "true");
+  uint64_t forgottenID{0};
+  BOOST_CHECK(spawn::SpawnHelper::spawn(request, error, nullptr, &forgottenID) > 0);
+  BOOST_CHECK(forgottenID > spawnID);
+  spawn::SpawnHelper::forget(forgottenID);
+  usleep(200000);
+  BOOST_CHECK_EQUAL(spawn::SpawnHelper::getExitStatus(forgottenID, status), false);
+
+  // exec failures are reported to the caller
+  request.exec = std::make_shared<const ExecSpec>("/bin", "notExistingCommand");
+  pid = spawn::SpawnHelper::spawn(request, error);
+  BOOST_CHECK_EQUAL(pid, -1);
+  BOOST_CHECK(error.find("execve") != std::string::npos);
+  BOOST_CHECK_EQUAL(spawn::SpawnHelper::isRunning(), true);
+
+  // output capture
+  request.exec = std::make_shared<const ExecSpec>("/bin", "echo captured");
+  request.captureOutput = true;
+  int outputFD{-1};
+  pid = spawn::SpawnHelper::spawn(request, error, &outputFD);
+  BOOST_CHECK(pid > 0);
+  BOOST_REQUIRE(outputFD >= 0);
+  std::string output;
+  char buffer[256];
+  ssize_t n;
+  while((n = read(outputFD, buffer, sizeof(buffer))) > 0) output.append(buffer, n);
+  close(outputFD);
+  BOOST_CHECK(output.find("captured\n") != std::string::npos);
+  remove(request.pidFile.c_str());
+}
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_resourceLimiter.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ResourceLimiterTest
+
+#include "ResourceLimiter.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test_framework;
+
+BOOST_AUTO_TEST_CASE(testEscalation) {
+  ResourceLimiter limiter;
+  ResourceLimiter::Limits limits;
+  limits.maxMem = 1000;
+  limits.nTicks = 2;
+  ResourceLimiter::Sample sample;
+  sample.mem = 500;
+  BOOST_CHECK(limiter.update(sample, limits) == ResourceLimiter::Action::None);
+  sample.mem = 2000;
+  std::vector<ResourceLimiter::Action> expected = {ResourceLimiter::Action::None, ResourceLimiter::Action::Warning,
+      ResourceLimiter::Action::None, ResourceLimiter::Action::Restart, ResourceLimiter::Action::None,
+      ResourceLimiter::Action::Kill, ResourceLimiter::Action::None};
+  for(auto& action : expected) {
+    BOOST_CHECK(limiter.update(sample, limits) == action);
+  }
+  BOOST_CHECK(limiter.getLevel() == ResourceLimiter::Action::Kill);
+  BOOST_CHECK(!limiter.getBreach().empty());
+  // back to normal
+  sample.mem = 500;
+  BOOST_CHECK(limiter.update(sample, limits) == ResourceLimiter::Action::None);
+  BOOST_CHECK(limiter.getLevel() == ResourceLimiter::Action::None);
+  BOOST_CHECK(limiter.getBreach().empty());
+}
+
+BOOST_AUTO_TEST_CASE(testInterruptedBreach) {
+  ResourceLimiter limiter;
+  ResourceLimiter::Limits limits;
+  limits.maxThreads = 10;
+  limits.maxFDs = 10;
+  limits.nTicks = 2;
+  ResourceLimiter::Sample sample;
+  sample.nThreads = 20;
+  BOOST_CHECK(limiter.update(sample, limits) == ResourceLimiter::Action::None);
+  sample.nThreads = 5;
+  BOOST_CHECK(limiter.update(sample, limits) == ResourceLimiter::Action::None);
+  // a different limit is exceeded now -> counting starts again
+  sample.nFDs = 20;
+  BOOST_CHECK(limiter.update(sample, limits) == ResourceLimiter::Action::None);
+  BOOST_CHECK(limiter.update(sample, limits) == ResourceLimiter::Action::Warning);
+}
+
+BOOST_AUTO_TEST_CASE(testCPUWindow) {
+  ResourceLimiter limiter;
+  ResourceLimiter::Limits limits;
+  limits.maxCPU = 50;
+  limits.cpuWindow = 3;
+  limits.nTicks = 1;
+  ResourceLimiter::Sample sample;
+  // short spikes are averaged out
+  sample.pcpu = 100;
+  BOOST_CHECK(limiter.update(sample, limits) == ResourceLimiter::Action::None);
+  sample.pcpu = 0;
+  BOOST_CHECK(limiter.update(sample, limits) == ResourceLimiter::Action::None);
+  BOOST_CHECK(limiter.update(sample, limits) == ResourceLimiter::Action::None);
+  sample.pcpu = 100;
+  BOOST_CHECK(limiter.update(sample, limits) == ResourceLimiter::Action::None);
+  BOOST_CHECK(limiter.update(sample, limits) == ResourceLimiter::Action::Warning);
+  limiter.reset();
+  BOOST_CHECK(limiter.getLevel() == ResourceLimiter::Action::None);
+  // disabled limits are never exceeded
+  limits.maxCPU = 0;
+  for(size_t i = 0; i < 5; i++) BOOST_CHECK(limiter.update(sample, limits) == ResourceLimiter::Action::None);
+}
@@ -0,0 +1,170 @@
+// SPDX-FileCopyrightText: Helmholtz-Zentrum Dresden-Rossendorf, FWKE, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * test_systemSnapshot.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE SystemSnapshotTest
+
+#include "ProcFile.h"
+#include "SystemSnapshot.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace boost::unit_test_framework;
+
+BOOST_AUTO_TEST_CASE(testRecorded) {
+  SystemSnapshot snapshot("proc");
+  BOOST_REQUIRE_MESSAGE(snapshot.update(), snapshot.getError());
+  auto& total = snapshot.getTotal();
+  BOOST_CHECK_EQUAL(total.user, 4705);
+  BOOST_CHECK_EQUAL(total.nice, 356);
+  BOOST_CHECK_EQUAL(total.system, 584);
+  BOOST_CHECK_EQUAL(total.idle, 3699176);
+  BOOST_CHECK_EQUAL(total.iowait, 23060);
+  BOOST_CHECK_EQUAL(total.softirq, 277);
+  BOOST_CHECK_EQUAL(total.busy(), 4705 + 356 + 584 + 277);
+  BOOST_CHECK_EQUAL(total.total(), 4705 + 356 + 584 + 277 + 3699176 + 23060);
+  BOOST_REQUIRE_EQUAL(snapshot.getCpus().size(), 4);
+  BOOST_CHECK_EQUAL(snapshot.getCpus().user[2], 1102);
+  BOOST_CHECK_EQUAL(snapshot.getCpus().iowait[3], 5697);
+  BOOST_CHECK_EQUAL(snapshot.getBootTime(), 1792418649);
+
+  auto& memory = snapshot.getMemory();
+  BOOST_CHECK_EQUAL(memory.total, 16315012);
+  BOOST_CHECK_EQUAL(memory.free, 9842108);
+  BOOST_CHECK_EQUAL(memory.available, 13012340);
+  BOOST_CHECK_EQUAL(memory.buffers, 211960);
+  BOOST_CHECK_EQUAL(memory.cached, 3125444);
+  BOOST_CHECK_EQUAL(memory.sReclaimable, 198440);
+  BOOST_CHECK_EQUAL(memory.shmem, 412308);
+  BOOST_CHECK_EQUAL(memory.swapTotal, 2097148);
+  BOOST_CHECK_EQUAL(memory.swapFree, 2031612);
+  BOOST_CHECK_EQUAL(memory.dirty, 1524);
+  BOOST_CHECK_EQUAL(memory.writeback, 16);
+  BOOST_CHECK_EQUAL(memory.slab, 345888);
+  BOOST_CHECK_EQUAL(memory.hugePagesTotal, 64);
+  BOOST_CHECK_EQUAL(memory.hugePagesFree, 48);
+  BOOST_CHECK_EQUAL(memory.hugePageSize, 2048);
+
+  auto& vmstat = snapshot.getVmstat();
+  BOOST_CHECK_EQUAL(vmstat.majorFaults, 8437);
+  BOOST_CHECK_EQUAL(vmstat.swapIn, 122);
+  BOOST_CHECK_EQUAL(vmstat.swapOut, 517);
+  BOOST_CHECK_EQUAL(vmstat.allocStalls, 3 + 12 + 5);
+  BOOST_CHECK_EQUAL(vmstat.compactStalls, 7);
+
+  BOOST_CHECK_CLOSE(snapshot.getLoadAvg()[0], 0.52, 1e-6);
+  BOOST_CHECK_CLOSE(snapshot.getLoadAvg()[1], 0.58, 1e-6);
+  BOOST_CHECK_CLOSE(snapshot.getLoadAvg()[2], 0.59, 1e-6);
+  BOOST_CHECK_CLOSE(snapshot.getUptime(), 35629.57, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(testUpdate) {
+  // the files are kept open, so rewriting them in place changes the next update
+  std::string dir = "test_systemSnapshot.d";
+  mkdir(dir.c_str(), 0755);
+  for(auto name : {"stat", "meminfo", "vmstat", "loadavg", "uptime"}) {
+    std::ifstream in(std::string("proc/") + name);
+    std::ofstream out(dir + "/" + name);
+    out << in.rdbuf();
+  }
+  SystemSnapshot snapshot(dir);
+  BOOST_REQUIRE(snapshot.update());
+  {
+    // cpu1 is offline, cpu5 was added
+    std::ofstream out(dir + "/stat");
+    out << "cpu  10 0 0 20\ncpu0 1 2 3 4 5 6 7 8 9 10\ncpu5 5 0 0 10\nbtime 100\n";
+  }
+  {
+    std::ofstream out(dir + "/uptime");
+    out << "12.5 3.00\n";
+  }
+  {
+    // kernels before 4.8 only provide a single allocstall counter
+    std::ofstream out(dir + "/vmstat");
+    out << "pgmajfault 9000\nallocstall 4\n";
+  }
+  BOOST_REQUIRE(snapshot.update());
+  BOOST_CHECK_EQUAL(snapshot.getTotal().idle, 20);
+  BOOST_CHECK_EQUAL(snapshot.getTotal().iowait, 0);
+  BOOST_REQUIRE_EQUAL(snapshot.getCpus().size(), 6);
+  BOOST_CHECK_EQUAL(snapshot.getCpus().guestNice[0], 10);
+  BOOST_CHECK_EQUAL(snapshot.getCpus().user[1], 0);
+  BOOST_CHECK_EQUAL(snapshot.getCpus().get(5).idle, 10);
+  BOOST_CHECK_EQUAL(snapshot.getUptime(), 12.5);
+  BOOST_CHECK_EQUAL(snapshot.getMemory().total, 16315012);
+  BOOST_CHECK_EQUAL(snapshot.getVmstat().majorFaults, 9000);
+  BOOST_CHECK_EQUAL(snapshot.getVmstat().allocStalls, 4);
+  BOOST_CHECK_EQUAL(snapshot.getVmstat().swapIn, 122);
+
+  // invalid data is reported, the other files are still read
+  {
+    std::ofstream out(dir + "/loadavg");
+    out << "invalid\n";
+  }
+  {
+    std::ofstream out(dir + "/uptime");
+    out << "13.5 3.00\n";
+  }
+  BOOST_CHECK(!snapshot.update());
+  BOOST_CHECK_EQUAL(snapshot.getError(), dir + "/loadavg: invalid format");
+  BOOST_CHECK_EQUAL(snapshot.getUptime(), 13.5);
+
+  SystemSnapshot moved(std::move(snapshot));
+  BOOST_CHECK_EQUAL(moved.getUptime(), 13.5);
+  for(auto name : {"stat", "meminfo", "vmstat", "loadavg", "uptime"}) remove((dir + "/" + name).c_str());
+  rmdir(dir.c_str());
+
+  SystemSnapshot missing(dir);
+  BOOST_CHECK(!missing.update());
+}
+
+BOOST_AUTO_TEST_CASE(testProc) {
+  SystemSnapshot snapshot;
+  BOOST_REQUIRE_MESSAGE(snapshot.update(), snapshot.getError());
+  BOOST_CHECK(snapshot.getTotal().total() > 0);
+  BOOST_CHECK(snapshot.getCpus().size() > 0);
+  BOOST_CHECK(snapshot.getMemory().total > 0);
+  BOOST_CHECK(snapshot.getUptime() > 0);
+  BOOST_CHECK(snapshot.getBootTime() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(testProcFile) {
+  std::string_view text("cpu0  12 3.25\nlast");
+  BOOST_CHECK_EQUAL(procfs::nextLine(text), "cpu0  12 3.25");
+  BOOST_CHECK_EQUAL(procfs::nextLine(text), "last");
+  BOOST_CHECK(text.empty());
+  text = "cpu0  12 3.25";
+  BOOST_CHECK_EQUAL(procfs::nextWord(text), "cpu0");
+  uint64_t number;
+  BOOST_REQUIRE(procfs::parseNumber(text, number));
+  BOOST_CHECK_EQUAL(number, 12);
+  double decimal;
+  BOOST_REQUIRE(procfs::parseDecimal(text, decimal));
+  BOOST_CHECK_CLOSE(decimal, 3.25, 1e-9);
+  BOOST_CHECK(!procfs::parseNumber(text, number));
+
+  // the buffer grows until the whole file fits, the file is read again from the beginning
+  int fd = ::open("proc/stat", O_RDONLY | O_CLOEXEC);
+  BOOST_REQUIRE(fd >= 0);
+  struct stat st;
+  BOOST_REQUIRE(fstat(fd, &st) == 0);
+  std::string buffer(16, '\0');
+  BOOST_CHECK_EQUAL(procfs::readFile(fd, buffer).size(), st.st_size);
+  BOOST_CHECK(buffer.size() > static_cast<size_t>(st.st_size));
+  BOOST_CHECK_EQUAL(procfs::readFile(fd, buffer).size(), st.st_size);
+  ::close(fd);
+  BOOST_CHECK(procfs::readFile(-1, buffer).empty());
+}
@@ -37,8 +37,6 @@ struct testWD : public ctk::Application {
       std::cout << "Adding process: " << processName << std::endl;
       processGroup.processes.emplace_back(&processGroup, processName, "process", true);
       //      processGroup.processes.back().logStream = nullptr;
-      processGroup.processesLogExternal.emplace_back(&processGroup, processName, "process external log",
-          "/Trigger/tick", "/processes/" + processName + "/config/logfileExternal");
     }
     ProcessHandler::setupHandler();
     logging = logging::LoggingModule{this, "logging", "LoggingModule logging watchdog internal messages"};